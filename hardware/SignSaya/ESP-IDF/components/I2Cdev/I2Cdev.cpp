@@ -704,6 +704,175 @@ bool I2Cdev::writeWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16
  */
 uint16_t I2Cdev::readTimeout = I2CDEV_DEFAULT_READ_TIMEOUT;
 
+#ifdef ESP_PLATFORM
+
+I2CdevAsync::Bus I2CdevAsync::buses[I2CDEV_ASYNC_BUSES];
+
+/** Start the worker task for a bus. Safe to call more than once.
+ * @param wireObj Bus the worker drives (0 for the default Wire)
+ * @param priority FreeRTOS priority of the worker
+ * @param core Core to pin the worker to, tskNO_AFFINITY for either
+ * @return Status of worker creation (true = running)
+ */
+bool I2CdevAsync::begin(void *wireObj, UBaseType_t priority, BaseType_t core) {
+    if (findBus(wireObj)) return true;
+
+    Bus *bus = NULL;
+    for (uint8_t i = 0; i < I2CDEV_ASYNC_BUSES; i++) {
+        if (buses[i].queue == NULL) {
+            bus = &buses[i];
+            break;
+        }
+    }
+    if (!bus) return false;
+
+    bus->wireObj = wireObj;
+    bus->completed = 0;
+    bus->rejected = 0;
+    bus->queue = xQueueCreate(I2CDEV_ASYNC_QUEUE_LENGTH, sizeof(I2CdevTransaction *));
+    if (!bus->queue) return false;
+    if (xTaskCreatePinnedToCore(worker, "i2cdevAsync", 3072, bus, priority, &bus->worker, core) != pdPASS) {
+        vQueueDelete(bus->queue);
+        bus->queue = NULL;
+        return false;
+    }
+    return true;
+}
+
+/** Queue a filled in transaction on its bus.
+ * @param transaction Transaction to run, result is set to I2CDEV_ASYNC_PENDING
+ * @param wait Ticks to wait for room in the queue
+ * @return Status of submission (false = no worker for the bus or queue full)
+ */
+bool I2CdevAsync::submit(I2CdevTransaction *transaction, TickType_t wait) {
+    Bus *bus = findBus(transaction->wireObj);
+    if (!bus) return false;
+    transaction->result = I2CDEV_ASYNC_PENDING;
+    if (xQueueSend(bus->queue, &transaction, wait) != pdTRUE) {
+        bus->rejected++;
+        transaction->result = -1;
+        return false;
+    }
+    return true;
+}
+
+/** Queue a multi-byte read that notifies the calling task when done.
+ * @param transaction Descriptor to fill in, must outlive the transfer
+ * @param devAddr I2C slave device address
+ * @param regAddr First register regAddr to read from
+ * @param length Number of bytes to read
+ * @param data Buffer to store read data in, must outlive the transfer
+ * @param timeout Optional read timeout in milliseconds
+ * @param wireObj Bus to read on (0 for the default Wire)
+ * @return Status of submission
+ */
+bool I2CdevAsync::readBytes(I2CdevTransaction *transaction, uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout, void *wireObj) {
+    transaction->devAddr = devAddr;
+    transaction->regAddr = regAddr;
+    transaction->length = length;
+    transaction->data = data;
+    transaction->read = true;
+    transaction->timeout = timeout;
+    transaction->wireObj = wireObj;
+    transaction->notifyTask = xTaskGetCurrentTaskHandle();
+    transaction->callback = NULL;
+    transaction->context = NULL;
+    return submit(transaction);
+}
+
+/** Queue a multi-byte write that notifies the calling task when done.
+ * @param transaction Descriptor to fill in, must outlive the transfer
+ * @param devAddr I2C slave device address
+ * @param regAddr First register address to write to
+ * @param length Number of bytes to write
+ * @param data Buffer to copy new data from, must outlive the transfer
+ * @param wireObj Bus to write on (0 for the default Wire)
+ * @return Status of submission
+ */
+bool I2CdevAsync::writeBytes(I2CdevTransaction *transaction, uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, void *wireObj) {
+    transaction->devAddr = devAddr;
+    transaction->regAddr = regAddr;
+    transaction->length = length;
+    transaction->data = data;
+    transaction->read = false;
+    transaction->timeout = 0;
+    transaction->wireObj = wireObj;
+    transaction->notifyTask = xTaskGetCurrentTaskHandle();
+    transaction->callback = NULL;
+    transaction->context = NULL;
+    return submit(transaction);
+}
+
+bool I2CdevAsync::isDone(const I2CdevTransaction *transaction) {
+    return transaction->result != I2CDEV_ASYNC_PENDING;
+}
+
+/** Block on the completion notification of a transaction. The notifyTask
+ * of the transaction must be the calling task.
+ * @param transaction Transaction to wait for
+ * @param timeout Ticks to wait in total
+ * @return Result of the transaction, I2CDEV_ASYNC_PENDING on timeout
+ */
+int8_t I2CdevAsync::wait(I2CdevTransaction *transaction, TickType_t timeout) {
+    TimeOut_t timeOut;
+    vTaskSetTimeOutState(&timeOut);
+    // other transactions of this task give the same notification, so loop
+    // until this one is the one that finished
+    while (transaction->result == I2CDEV_ASYNC_PENDING) {
+        if (xTaskCheckForTimeOut(&timeOut, &timeout) == pdTRUE) break;
+        ulTaskNotifyTakeIndexed(I2CDEV_ASYNC_NOTIFY_INDEX, pdFALSE, timeout);
+    }
+    return transaction->result;
+}
+
+uint32_t I2CdevAsync::completed(void *wireObj) {
+    Bus *bus = findBus(wireObj);
+    return bus ? bus->completed : 0;
+}
+
+uint32_t I2CdevAsync::rejected(void *wireObj) {
+    Bus *bus = findBus(wireObj);
+    return bus ? bus->rejected : 0;
+}
+
+I2CdevAsync::Bus *I2CdevAsync::findBus(void *wireObj) {
+    for (uint8_t i = 0; i < I2CDEV_ASYNC_BUSES; i++) {
+        if (buses[i].queue != NULL && buses[i].wireObj == wireObj) return &buses[i];
+    }
+    return NULL;
+}
+
+void I2CdevAsync::complete(I2CdevTransaction *transaction) {
+    int8_t result;
+    if (transaction->read) {
+        result = I2Cdev::readBytes(transaction->devAddr, transaction->regAddr, transaction->length, transaction->data, transaction->timeout, transaction->wireObj);
+    } else {
+        result = I2Cdev::writeBytes(transaction->devAddr, transaction->regAddr, transaction->length, transaction->data, transaction->wireObj);
+    }
+    // the callback runs before the result is published and the handle is read
+    // before that too, the owner may reuse the descriptor as soon as it sees
+    // it done
+    if (transaction->callback) transaction->callback(transaction, result);
+    TaskHandle_t notifyTask = transaction->notifyTask;
+    transaction->result = result;
+    if (notifyTask) xTaskNotifyGiveIndexed(notifyTask, I2CDEV_ASYNC_NOTIFY_INDEX);
+}
+
+void I2CdevAsync::worker(void *parameter) {
+    Bus *bus = (Bus *)parameter;
+    I2CdevTransaction *transaction;
+    for (;;) {
+        if (xQueueReceive(bus->queue, &transaction, portMAX_DELAY) != pdTRUE) continue;
+        // run everything already queued back to back before sleeping again
+        do {
+            complete(transaction);
+            bus->completed++;
+        } while (xQueueReceive(bus->queue, &transaction, 0) == pdTRUE);
+    }
+}
+
+#endif // ESP_PLATFORM
+
 #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_FASTWIRE
     // I2C library
     //////////////////////
@@ -154,6 +154,87 @@ class I2Cdev {
         static uint16_t readTimeout;
 };
 
+#ifdef ESP_PLATFORM
+    #include "freertos/FreeRTOS.h"
+    #include "freertos/queue.h"
+    #include "freertos/task.h"
+
+    // result of a transaction that has not completed yet
+    #define I2CDEV_ASYNC_PENDING        -2
+
+    #ifndef I2CDEV_ASYNC_QUEUE_LENGTH
+        #define I2CDEV_ASYNC_QUEUE_LENGTH   8
+    #endif
+
+    #ifndef I2CDEV_ASYNC_BUSES
+        #define I2CDEV_ASYNC_BUSES          2
+    #endif
+
+    // index 0 is left to ISR wakeups (vTaskNotifyGiveFromISR) when there is room
+    #ifndef I2CDEV_ASYNC_NOTIFY_INDEX
+        #if configTASK_NOTIFICATION_ARRAY_ENTRIES > 1
+            #define I2CDEV_ASYNC_NOTIFY_INDEX   1
+        #else
+            #define I2CDEV_ASYNC_NOTIFY_INDEX   0
+        #endif
+    #endif
+
+    struct I2CdevTransaction;
+    // result is what the transaction's result becomes once the callback returns
+    typedef void (*I2CdevCallback)(I2CdevTransaction *transaction, int8_t result);
+
+    /** One queued register read or write. Owned by the caller and must stay
+     * valid, together with data, until result leaves I2CDEV_ASYNC_PENDING.
+     */
+    struct I2CdevTransaction {
+        uint8_t devAddr;
+        uint8_t regAddr;
+        uint8_t length;
+        uint8_t *data;
+        bool read;
+        uint16_t timeout;
+        void *wireObj;
+        TaskHandle_t notifyTask;    // notified on completion, may be NULL
+        I2CdevCallback callback;    // runs on the bus worker before result is set, may be NULL
+        void *context;
+        volatile int8_t result;     // bytes read, 0/1 for writes, -1 on error
+    };
+
+    /** Non-blocking front end for I2Cdev. Transactions are queued per bus and
+     * a worker task runs every queued transfer back to back each time it
+     * wakes, so the submitting task can keep working while the bus is busy.
+     */
+    class I2CdevAsync {
+        public:
+            static bool begin(void *wireObj=0, UBaseType_t priority=configMAX_PRIORITIES - 2, BaseType_t core=tskNO_AFFINITY);
+            static bool submit(I2CdevTransaction *transaction, TickType_t wait=0);
+
+            static bool readBytes(I2CdevTransaction *transaction, uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout=I2Cdev::readTimeout, void *wireObj=0);
+            static bool writeBytes(I2CdevTransaction *transaction, uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, void *wireObj=0);
+
+            static bool isDone(const I2CdevTransaction *transaction);
+            static int8_t wait(I2CdevTransaction *transaction, TickType_t timeout=portMAX_DELAY);
+
+            static uint32_t completed(void *wireObj=0);
+            static uint32_t rejected(void *wireObj=0);
+
+        private:
+            struct Bus {
+                void *wireObj;
+                QueueHandle_t queue;
+                TaskHandle_t worker;
+                uint32_t completed;
+                uint32_t rejected;
+            };
+
+            static Bus buses[I2CDEV_ASYNC_BUSES];
+
+            static Bus *findBus(void *wireObj);
+            static void worker(void *parameter);
+            static void complete(I2CdevTransaction *transaction);
+    };
+#endif // ESP_PLATFORM
+
 #if I2CDEV_IMPLEMENTATION == I2CDEV_BUILTIN_FASTWIRE
     //////////////////////
     // FastWire 0.24
@@ -1315,6 +1315,17 @@ ICM_20948_Status_e ICM_20948::readFIFO(uint8_t *data, uint8_t len)
   return status;
 }
 
+ICM_20948_Bus_Stats_t ICM_20948::busStats(void)
+{
+  return _device._bus_stats;
+}
+
+ICM_20948_Status_e ICM_20948::readFIFOburst(uint8_t *data, uint16_t len)
+{
+  status = ICM_20948_read_FIFO_burst(&_device, data, len);
+  return status;
+}
+
 // DMP
 
 ICM_20948_Status_e ICM_20948::enableDMP(bool enable)
@@ -1436,6 +1447,16 @@ ICM_20948_Status_e ICM_20948::readDMPdataFromFIFO(icm_20948_DMP_data_t *data)
   return ICM_20948_Stat_DMPNotSupported;
 }
 
+ICM_20948_Status_e ICM_20948::parseDMPdata(const uint8_t *fifo, uint16_t available, icm_20948_DMP_data_t *data, uint16_t *consumed)
+{
+  if (_device._dmp_firmware_available == true)
+  {
+    status = inv_icm20948_parse_dmp_data(fifo, available, data, consumed);
+    return status;
+  }
+  return ICM_20948_Stat_DMPNotSupported;
+}
+
 ICM_20948_Status_e ICM_20948::setGyroSF(unsigned char div, int gyro_level)
 {
   if (_device._dmp_firmware_available == true) // Should we attempt to set the Gyro SF?
@@ -1752,6 +1773,7 @@ ICM_20948_Status_e ICM_20948_I2C::begin(TwoWire &wirePort, bool ad0val, uint8_t
   _device._firmware_loaded = false; // Initialize _firmware_loaded
   _device._last_bank = 255;         // Initialize _last_bank. Make it invalid. It will be set by the first call of ICM_20948_set_bank.
   _device._last_mems_bank = 255;    // Initialize _last_mems_bank. Make it invalid. It will be set by the first call of inv_icm20948_write_mems.
+  ICM_20948_invalidate_cache(&_device); // Forget shadow registers from an earlier begin attempt
   _device._gyroSF = 0;              // Use this to record the GyroSF, calculated by inv_icm20948_set_gyro_sf
   _device._gyroSFpll = 0;
   _device._enabled_Android_0 = 0;      // Keep track of which Android sensors are enabled: 0-31
@@ -1949,6 +1971,7 @@ ICM_20948_Status_e ICM_20948_SPI::begin(uint8_t csPin, SPIClass &spiPort, uint32
   _device._firmware_loaded = false; // Initialize _firmware_loaded
   _device._last_bank = 255;         // Initialize _last_bank. Make it invalid. It will be set by the first call of ICM_20948_set_bank.
   _device._last_mems_bank = 255;    // Initialize _last_mems_bank. Make it invalid. It will be set by the first call of inv_icm20948_write_mems.
+  ICM_20948_invalidate_cache(&_device); // Forget shadow registers from an earlier begin attempt
   _device._gyroSF = 0;              // Use this to record the GyroSF, calculated by inv_icm20948_set_gyro_sf
   _device._gyroSFpll = 0;
   _device._enabled_Android_0 = 0;      // Keep track of which Android sensors are enabled: 0-31
@@ -171,6 +171,8 @@ public:
   ICM_20948_Status_e setFIFOmode(bool snapshot = false); // Default to Stream (non-Snapshot) mode
   ICM_20948_Status_e getFIFOcount(uint16_t *count);
   ICM_20948_Status_e readFIFO(uint8_t *data, uint8_t len = 1);
+  ICM_20948_Status_e readFIFOburst(uint8_t *data, uint16_t len); // Large reads split into ICM_20948_FIFO_BURST_MAX transactions
+  ICM_20948_Bus_Stats_t busStats(void);                           // Bus transactions made and saved by the bank and register cache
 
   //DMP
 
@@ -234,6 +236,7 @@ public:
   ICM_20948_Status_e readDMPmems(unsigned short reg, unsigned int length, unsigned char *data);
   ICM_20948_Status_e setDMPODRrate(enum DMP_ODR_Registers odr_reg, int interval);
   ICM_20948_Status_e readDMPdataFromFIFO(icm_20948_DMP_data_t *data);
+  ICM_20948_Status_e parseDMPdata(const uint8_t *fifo, uint16_t available, icm_20948_DMP_data_t *data, uint16_t *consumed); // Parse one packet from bytes read with readFIFOburst
   ICM_20948_Status_e setGyroSF(unsigned char div, int gyro_level);
   ICM_20948_Status_e initializeDMP(void) __attribute__((weak)); // Combine all of the DMP start-up code in one place. Can be overwritten if required
 };
@@ -129,9 +129,111 @@ ICM_20948_Status_e ICM_20948_init_struct(ICM_20948_Device_t *pdev)
   // so ICM_20948_set_bank function does not skip issuing bank change operation
   static const ICM_20948_Device_t init_device = { ._last_bank = 4 };
   *pdev = init_device;
+#if defined(ICM_20948_USE_REGISTER_CACHE)
+  pdev->_shadow_enabled = true;
+#endif
+  return ICM_20948_Stat_Ok;
+}
+
+ICM_20948_Status_e ICM_20948_invalidate_cache(ICM_20948_Device_t *pdev)
+{
+  static const ICM_20948_Bus_Stats_t no_stats = { 0 };
+  pdev->_last_bank = 255;
+  pdev->_last_mems_bank = 255;
+  pdev->_shadow_valid = 0;
+  pdev->_bus_stats = no_stats;
   return ICM_20948_Stat_Ok;
 }
 
+// Configuration registers that only change when the driver writes them.
+// Status, data, FIFO, memory access and I2C_PERIPH4 registers are never cached.
+// self_clearing holds the trigger bits the device clears by itself, they are stored as 0.
+typedef struct
+{
+  uint8_t bank;
+  uint8_t reg;
+  uint8_t self_clearing;
+} ICM_20948_Cached_Reg_t;
+
+static const ICM_20948_Cached_Reg_t ICM_20948_cached_regs[ICM_20948_CACHED_REGS] = {
+    {0, AGB0_REG_USER_CTRL, 0x0E}, // DMP_RST, SRAM_RST, I2C_MST_RST
+    {0, AGB0_REG_LP_CONFIG, 0x00},
+    {0, AGB0_REG_PWR_MGMT_1, 0x80}, // DEVICE_RESET
+    {0, AGB0_REG_PWR_MGMT_2, 0x00},
+    {0, AGB0_REG_INT_PIN_CONFIG, 0x00},
+    {0, AGB0_REG_INT_ENABLE, 0x00},
+    {0, AGB0_REG_INT_ENABLE_1, 0x00},
+    {0, AGB0_REG_INT_ENABLE_2, 0x00},
+    {0, AGB0_REG_INT_ENABLE_3, 0x00},
+    {0, AGB0_REG_SINGLE_FIFO_PRIORITY_SEL, 0x00},
+    {0, AGB0_REG_FIFO_EN_1, 0x00},
+    {0, AGB0_REG_FIFO_EN_2, 0x00},
+    {0, AGB0_REG_FIFO_MODE, 0x00},
+    {0, AGB0_REG_HW_FIX_DISABLE, 0x00},
+    {0, AGB0_REG_FIFO_CFG, 0x00},
+    {2, AGB2_REG_GYRO_SMPLRT_DIV, 0x00},
+    {2, AGB2_REG_GYRO_CONFIG_1, 0x00},
+    {2, AGB2_REG_GYRO_CONFIG_2, 0x00},
+    {2, AGB2_REG_ODR_ALIGN_EN, 0x00},
+    {2, AGB2_REG_ACCEL_SMPLRT_DIV_1, 0x00},
+    {2, AGB2_REG_ACCEL_SMPLRT_DIV_2, 0x00},
+    {2, AGB2_REG_ACCEL_INTEL_CTRL, 0x00},
+    {2, AGB2_REG_ACCEL_WOM_THR, 0x00},
+    {2, AGB2_REG_ACCEL_CONFIG, 0x00},
+    {2, AGB2_REG_ACCEL_CONFIG_2, 0x00},
+    {2, AGB2_REG_FSYNC_CONFIG, 0x00},
+    {2, AGB2_REG_TEMP_CONFIG, 0x00},
+    {2, AGB2_REG_MOD_CTRL_USR, 0x00},
+    {3, AGB3_REG_I2C_MST_ODR_CONFIG, 0x00},
+    {3, AGB3_REG_I2C_MST_CTRL, 0x00},
+    {3, AGB3_REG_I2C_MST_DELAY_CTRL, 0x00},
+    {3, AGB3_REG_I2C_PERIPH0_ADDR, 0x00},
+    {3, AGB3_REG_I2C_PERIPH0_REG, 0x00},
+    {3, AGB3_REG_I2C_PERIPH0_CTRL, 0x00},
+    {3, AGB3_REG_I2C_PERIPH0_DO, 0x00},
+    {3, AGB3_REG_I2C_PERIPH1_ADDR, 0x00},
+    {3, AGB3_REG_I2C_PERIPH1_REG, 0x00},
+    {3, AGB3_REG_I2C_PERIPH1_CTRL, 0x00},
+    {3, AGB3_REG_I2C_PERIPH1_DO, 0x00},
+    {3, AGB3_REG_I2C_PERIPH2_ADDR, 0x00},
+    {3, AGB3_REG_I2C_PERIPH2_REG, 0x00},
+    {3, AGB3_REG_I2C_PERIPH2_CTRL, 0x00},
+    {3, AGB3_REG_I2C_PERIPH2_DO, 0x00},
+    {3, AGB3_REG_I2C_PERIPH3_ADDR, 0x00},
+    {3, AGB3_REG_I2C_PERIPH3_REG, 0x00},
+    {3, AGB3_REG_I2C_PERIPH3_CTRL, 0x00},
+    {3, AGB3_REG_I2C_PERIPH3_DO, 0x00},
+};
+
+// Index into _shadow_regs for regaddr in the selected bank, or -1 if it is not cached
+static int ICM_20948_cache_index(ICM_20948_Device_t *pdev, uint8_t regaddr)
+{
+  if ((!pdev->_shadow_enabled) || (pdev->_last_bank > 3))
+    return -1;
+  for (int i = 0; i < ICM_20948_CACHED_REGS; i++)
+  {
+    if ((ICM_20948_cached_regs[i].bank == pdev->_last_bank) && (ICM_20948_cached_regs[i].reg == regaddr))
+      return i;
+  }
+  return -1;
+}
+
+static void ICM_20948_cache_store(ICM_20948_Device_t *pdev, uint8_t regaddr, const uint8_t *pdata, uint32_t len)
+{
+  // FIFO_R_W and MEM_R_W are data ports, every byte goes through the same address
+  if ((pdev->_last_bank == 0) && ((regaddr == AGB0_REG_FIFO_R_W) || (regaddr == AGB0_REG_MEM_R_W)))
+    return;
+  for (uint32_t i = 0; i < len; i++) // Other multi-byte accesses auto increment the address
+  {
+    int index = ICM_20948_cache_index(pdev, regaddr + i);
+    if (index >= 0)
+    {
+      pdev->_shadow_regs[index] = pdata[i] & ~ICM_20948_cached_regs[index].self_clearing;
+      pdev->_shadow_valid |= ((uint64_t)1 << index);
+    }
+  }
+}
+
 ICM_20948_Status_e ICM_20948_link_serif(ICM_20948_Device_t *pdev, const ICM_20948_Serif_t *s)
 {
   if (s == NULL)
@@ -148,20 +250,70 @@ ICM_20948_Status_e ICM_20948_link_serif(ICM_20948_Device_t *pdev, const ICM_2094
 
 ICM_20948_Status_e ICM_20948_execute_w(ICM_20948_Device_t *pdev, uint8_t regaddr, uint8_t *pdata, uint32_t len)
 {
+  ICM_20948_Status_e retval = ICM_20948_Stat_Ok;
+
   if (pdev->_serif->write == NULL)
   {
     return ICM_20948_Stat_NotImpl;
   }
-  return (*pdev->_serif->write)(regaddr, pdata, len, pdev->_serif->user);
+
+  if (len == 1)
+  {
+    int index = ICM_20948_cache_index(pdev, regaddr);
+    if ((index >= 0) && ((pdev->_shadow_valid & ((uint64_t)1 << index)) > 0) &&
+        ((*pdata & ICM_20948_cached_regs[index].self_clearing) == 0) && (*pdata == pdev->_shadow_regs[index]))
+    {
+      pdev->_bus_stats.writes_saved++;
+      return ICM_20948_Stat_Ok; // The register already holds this value
+    }
+  }
+
+  pdev->_bus_stats.writes++;
+  retval = (*pdev->_serif->write)(regaddr, pdata, len, pdev->_serif->user);
+  if (retval != ICM_20948_Stat_Ok)
+  {
+    return retval;
+  }
+
+  if ((pdev->_last_bank == 0) && (regaddr == AGB0_REG_PWR_MGMT_1) && ((*pdata & 0x80) > 0))
+  {
+    // DEVICE_RESET puts every register, including REG_BANK_SEL, back to its default
+    ICM_20948_Bus_Stats_t stats = pdev->_bus_stats; // Keep counting across the reset
+    ICM_20948_invalidate_cache(pdev);
+    pdev->_bus_stats = stats;
+    return retval;
+  }
+  ICM_20948_cache_store(pdev, regaddr, pdata, len);
+  return retval;
 }
 
 ICM_20948_Status_e ICM_20948_execute_r(ICM_20948_Device_t *pdev, uint8_t regaddr, uint8_t *pdata, uint32_t len)
 {
+  ICM_20948_Status_e retval = ICM_20948_Stat_Ok;
+
   if (pdev->_serif->read == NULL)
   {
     return ICM_20948_Stat_NotImpl;
   }
-  return (*pdev->_serif->read)(regaddr, pdata, len, pdev->_serif->user);
+
+  if (len == 1)
+  {
+    int index = ICM_20948_cache_index(pdev, regaddr);
+    if ((index >= 0) && ((pdev->_shadow_valid & ((uint64_t)1 << index)) > 0))
+    {
+      *pdata = pdev->_shadow_regs[index];
+      pdev->_bus_stats.reads_saved++;
+      return ICM_20948_Stat_Ok;
+    }
+  }
+
+  pdev->_bus_stats.reads++;
+  retval = (*pdev->_serif->read)(regaddr, pdata, len, pdev->_serif->user);
+  if (retval == ICM_20948_Stat_Ok)
+  {
+    ICM_20948_cache_store(pdev, regaddr, pdata, len);
+  }
+  return retval;
 }
 
 //Transact directly with an I2C device, one byte at a time
@@ -271,7 +423,10 @@ ICM_20948_Status_e ICM_20948_set_bank(ICM_20948_Device_t *pdev, uint8_t bank)
   } // Only 4 possible banks
 
   if (bank == pdev->_last_bank) // Do we need to change bank?
-    return ICM_20948_Stat_Ok;   // Bail if we don't need to change bank to avoid unnecessary bus traffic
+  {
+    pdev->_bus_stats.bank_switches_saved++;
+    return ICM_20948_Stat_Ok; // Bail if we don't need to change bank to avoid unnecessary bus traffic
+  }
 
   pdev->_last_bank = bank;   // Store the requested bank (before we bit-shift)
   bank = (bank << 4) & 0x30; // bits 5:4 of REG_BANK_SEL
@@ -1211,20 +1366,18 @@ ICM_20948_Status_e ICM_20948_get_FIFO_count(ICM_20948_Device_t *pdev, uint16_t *
     return retval;
   }
 
-  retval = ICM_20948_execute_r(pdev, AGB0_REG_FIFO_COUNT_H, (uint8_t *)&ctrlh, sizeof(ICM_20948_FIFO_COUNTH_t));
+  // COUNT_H and COUNT_L are adjacent, read both in one transaction
+  uint8_t counts[2];
+  retval = ICM_20948_execute_r(pdev, AGB0_REG_FIFO_COUNT_H, counts, 2);
   if (retval != ICM_20948_Stat_Ok)
   {
     return retval;
   }
+  *((uint8_t *)&ctrlh) = counts[0];
+  *((uint8_t *)&ctrll) = counts[1];
 
   ctrlh.FIFO_COUNTH &= 0x1F; // Datasheet says "FIFO_CNT[12:8]"
 
-  retval = ICM_20948_execute_r(pdev, AGB0_REG_FIFO_COUNT_L, (uint8_t *)&ctrll, sizeof(ICM_20948_FIFO_COUNTL_t));
-  if (retval != ICM_20948_Stat_Ok)
-  {
-    return retval;
-  }
-
   *count = (((uint16_t)ctrlh.FIFO_COUNTH) << 8) | (uint16_t)ctrll.FIFO_COUNTL;
 
   return retval;
@@ -1249,6 +1402,32 @@ ICM_20948_Status_e ICM_20948_read_FIFO(ICM_20948_Device_t *pdev, uint8_t *data,
   return retval;
 }
 
+ICM_20948_Status_e ICM_20948_read_FIFO_burst(ICM_20948_Device_t *pdev, uint8_t *data, uint16_t len)
+{
+  ICM_20948_Status_e retval = ICM_20948_Stat_Ok;
+
+  retval = ICM_20948_set_bank(pdev, 0);
+  if (retval != ICM_20948_Stat_Ok)
+  {
+    return retval;
+  }
+
+  // FIFO_R_W does not auto increment, so consecutive reads keep draining the FIFO
+  while (len > 0)
+  {
+    uint16_t chunk = (len > ICM_20948_FIFO_BURST_MAX) ? ICM_20948_FIFO_BURST_MAX : len;
+    retval = ICM_20948_execute_r(pdev, AGB0_REG_FIFO_R_W, data, chunk);
+    if (retval != ICM_20948_Stat_Ok)
+    {
+      return retval;
+    }
+    data += chunk;
+    len -= chunk;
+  }
+
+  return retval;
+}
+
 // DMP
 
 ICM_20948_Status_e ICM_20948_enable_DMP(ICM_20948_Device_t *pdev, bool enable)
@@ -2471,6 +2650,184 @@ ICM_20948_Status_e inv_icm20948_read_dmp_data(ICM_20948_Device_t *pdev, icm_2094
   return result;
 }
 
+// Returns the next len bytes of a packet being parsed, or NULL if the packet is incomplete
+static const uint8_t *inv_icm20948_take_dmp_bytes(const uint8_t **cursor, uint16_t *remaining, uint16_t len)
+{
+  const uint8_t *bytes = *cursor;
+  if (*remaining < len)
+    return NULL;
+  *cursor += len;
+  *remaining -= len;
+  return bytes;
+}
+
+ICM_20948_Status_e inv_icm20948_parse_dmp_data(const uint8_t *fifo, uint16_t available, icm_20948_DMP_data_t *data, uint16_t *consumed)
+{
+  const uint8_t *cursor = fifo;
+  uint16_t remaining = available;
+  const uint8_t *bytes;
+
+  // Same layout as inv_icm20948_read_dmp_data, but from memory instead of one FIFO read per field
+  *consumed = 0;
+
+  if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Header_Bytes)) == NULL)
+    return ICM_20948_Stat_FIFONoDataAvail;
+  data->header = ((uint16_t)bytes[0] << 8) | bytes[1]; // MSB first
+
+  data->header2 = 0;
+  if ((data->header & DMP_header_bitmap_Header2) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Header2_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    data->header2 = ((uint16_t)bytes[0] << 8) | bytes[1];
+  }
+
+  if ((data->header & DMP_header_bitmap_Accel) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Raw_Accel_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < icm_20948_DMP_Raw_Accel_Bytes; i++)
+      data->Raw_Accel.Bytes[DMP_PQuat6_Byte_Ordering[i]] = bytes[i];
+  }
+
+  if ((data->header & DMP_header_bitmap_Gyro) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Raw_Gyro_Bytes + icm_20948_DMP_Gyro_Bias_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < (icm_20948_DMP_Raw_Gyro_Bytes + icm_20948_DMP_Gyro_Bias_Bytes); i++)
+      data->Raw_Gyro.Bytes[DMP_Raw_Gyro_Byte_Ordering[i]] = bytes[i];
+  }
+
+  if ((data->header & DMP_header_bitmap_Compass) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Compass_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < icm_20948_DMP_Compass_Bytes; i++)
+      data->Compass.Bytes[DMP_PQuat6_Byte_Ordering[i]] = bytes[i];
+  }
+
+  if ((data->header & DMP_header_bitmap_ALS) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_ALS_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < icm_20948_DMP_ALS_Bytes; i++)
+      data->ALS[i] = bytes[i];
+  }
+
+  if ((data->header & DMP_header_bitmap_Quat6) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Quat6_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < icm_20948_DMP_Quat6_Bytes; i++)
+      data->Quat6.Bytes[DMP_Quat6_Byte_Ordering[i]] = bytes[i];
+  }
+
+  if ((data->header & DMP_header_bitmap_Quat9) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Quat9_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < icm_20948_DMP_Quat9_Bytes; i++)
+      data->Quat9.Bytes[DMP_Quat9_Byte_Ordering[i]] = bytes[i];
+  }
+
+  if ((data->header & DMP_header_bitmap_PQuat6) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_PQuat6_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < icm_20948_DMP_PQuat6_Bytes; i++)
+      data->PQuat6.Bytes[DMP_PQuat6_Byte_Ordering[i]] = bytes[i];
+  }
+
+  if ((data->header & DMP_header_bitmap_Geomag) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Geomag_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < icm_20948_DMP_Geomag_Bytes; i++)
+      data->Geomag.Bytes[DMP_Quat9_Byte_Ordering[i]] = bytes[i];
+  }
+
+  if ((data->header & DMP_header_bitmap_Pressure) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Pressure_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < icm_20948_DMP_Pressure_Bytes; i++)
+      data->Pressure[i] = bytes[i];
+  }
+
+  // Gyro_Calibr is skipped, see inv_icm20948_read_dmp_data
+
+  if ((data->header & DMP_header_bitmap_Compass_Calibr) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Compass_Calibr_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < icm_20948_DMP_Compass_Calibr_Bytes; i++)
+      data->Compass_Calibr.Bytes[DMP_Quat6_Byte_Ordering[i]] = bytes[i];
+  }
+
+  if ((data->header & DMP_header_bitmap_Step_Detector) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Step_Detector_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    data->Pedometer_Timestamp = ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+  }
+
+  if ((data->header2 & DMP_header2_bitmap_Accel_Accuracy) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Accel_Accuracy_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    data->Accel_Accuracy = ((uint16_t)bytes[0] << 8) | bytes[1];
+  }
+
+  if ((data->header2 & DMP_header2_bitmap_Gyro_Accuracy) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Gyro_Accuracy_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    data->Gyro_Accuracy = ((uint16_t)bytes[0] << 8) | bytes[1];
+  }
+
+  if ((data->header2 & DMP_header2_bitmap_Compass_Accuracy) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Compass_Accuracy_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    data->Compass_Accuracy = ((uint16_t)bytes[0] << 8) | bytes[1];
+  }
+
+  // Fsync is skipped, see inv_icm20948_read_dmp_data
+
+  if ((data->header2 & DMP_header2_bitmap_Pickup) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Pickup_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    data->Pickup = ((uint16_t)bytes[0] << 8) | bytes[1];
+  }
+
+  if ((data->header2 & DMP_header2_bitmap_Activity_Recog) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Activity_Recognition_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < icm_20948_DMP_Activity_Recognition_Bytes; i++)
+      data->Activity_Recognition.Bytes[DMP_Activity_Recognition_Byte_Ordering[i]] = bytes[i];
+  }
+
+  if ((data->header2 & DMP_header2_bitmap_Secondary_On_Off) > 0)
+  {
+    if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Secondary_On_Off_Bytes)) == NULL)
+      return ICM_20948_Stat_FIFOIncompleteData;
+    for (int i = 0; i < icm_20948_DMP_Secondary_On_Off_Bytes; i++)
+      data->Secondary_On_Off.Bytes[DMP_Secondary_On_Off_Byte_Ordering[i]] = bytes[i];
+  }
+
+  if ((bytes = inv_icm20948_take_dmp_bytes(&cursor, &remaining, icm_20948_DMP_Footer_Bytes)) == NULL)
+    return ICM_20948_Stat_FIFOIncompleteData;
+  data->Footer = ((uint16_t)bytes[0] << 8) | bytes[1];
+
+  *consumed = available - remaining;
+  if (remaining > 0) // Another packet follows in the buffer
+    return ICM_20948_Stat_FIFOMoreDataAvail;
+
+  return ICM_20948_Stat_Ok;
+}
+
 uint8_t sensor_type_2_android_sensor(enum inv_icm20948_sensor sensor)
 {
   switch (sensor)
@@ -28,6 +28,10 @@ extern int memcmp(const void *, const void *, size_t); // Avoid compiler warning
 // Note: you must have 14290/14301 Bytes of program memory available to store the DMP firmware!
 #define ICM_20948_USE_DMP // Uncomment this line to enable DMP support. You can of course use ICM_20948_USE_DMP as a compiler flag too
 
+// Define to keep shadow copies of the configuration registers, so read-modify-write helpers skip the read
+// and writes of an unchanged value are skipped. Clear _shadow_enabled at runtime to compare bus traffic
+#define ICM_20948_USE_REGISTER_CACHE
+
 // There are two versions of the InvenSense DMP firmware for the ICM20948 - with slightly different sizes
 #define DMP_CODE_SIZE 14301 /* eMD-SmartMotion-ICM20948-1.1.0-MP */
 //#define DMP_CODE_SIZE 14290 /* ICM20948_eMD_nucleo_1.0 */
@@ -43,6 +47,10 @@ extern int memcmp(const void *, const void *, size_t); // Avoid compiler warning
 
 /** @brief Max size that can be read across I2C or SPI data lines */
 #define INV_MAX_SERIAL_READ 16
+/** @brief Max size of one FIFO burst read, the Arduino Wire buffer is 128 bytes */
+#ifndef ICM_20948_FIFO_BURST_MAX
+#define ICM_20948_FIFO_BURST_MAX 128
+#endif
 /** @brief Max size that can be written across I2C or SPI data lines */
 #define INV_MAX_SERIAL_WRITE 16
 
@@ -164,6 +172,17 @@ extern int memcmp(const void *, const void *, size_t); // Avoid compiler warning
   } ICM_20948_Serif_t;                      // This is the vtable of serial interface functions
   extern const ICM_20948_Serif_t NullSerif; // Here is a default for initialization (NULL)
 
+#define ICM_20948_CACHED_REGS 47 // Configuration registers covered by the shadow cache, see ICM_20948_cached_regs
+
+  typedef struct
+  {
+    uint32_t reads;               // Read transactions that went out on the bus
+    uint32_t writes;              // Write transactions that went out on the bus (bank selects included)
+    uint32_t reads_saved;         // Reads answered from the shadow cache
+    uint32_t writes_saved;        // Writes skipped because the register already held the value
+    uint32_t bank_switches_saved; // Bank selects skipped because the bank was already selected
+  } ICM_20948_Bus_Stats_t;
+
   typedef struct
   {
     const ICM_20948_Serif_t *_serif; // Pointer to the assigned Serif (Serial Interface) vtable
@@ -182,6 +201,10 @@ extern int memcmp(const void *, const void *, size_t); // Avoid compiler warning
     uint16_t _dataRdyStatus;          // Diagnostics: record the setting of DATA_RDY_STATUS
     uint16_t _motionEventCtl;         // Diagnostics: record the setting of MOTION_EVENT_CTL
     uint16_t _dataIntrCtl;            // Diagnostics: record the setting of DATA_INTR_CTL
+    bool _shadow_enabled;                          // Use the shadow cache below
+    uint64_t _shadow_valid;                        // One bit per entry of _shadow_regs
+    uint8_t _shadow_regs[ICM_20948_CACHED_REGS];   // Last known value of each cached configuration register
+    ICM_20948_Bus_Stats_t _bus_stats;              // Transaction counters, cleared by ICM_20948_invalidate_cache
   } ICM_20948_Device_t;               // Definition of device struct type
 
   ICM_20948_Status_e ICM_20948_init_struct(ICM_20948_Device_t *pdev); // Initialize ICM_20948_Device_t
@@ -189,6 +212,7 @@ extern int memcmp(const void *, const void *, size_t); // Avoid compiler warning
   // ICM_20948_Status_e ICM_20948_Startup( ICM_20948_Device_t* pdev ); // For the time being this performs a standardized startup routine
 
   ICM_20948_Status_e ICM_20948_link_serif(ICM_20948_Device_t *pdev, const ICM_20948_Serif_t *s); // Links a SERIF structure to the device
+  ICM_20948_Status_e ICM_20948_invalidate_cache(ICM_20948_Device_t *pdev);                       // Forgets the selected bank and all shadow registers, clears the bus counters
 
   // use the device's serif to perform a read or write
   ICM_20948_Status_e ICM_20948_execute_r(ICM_20948_Device_t *pdev, uint8_t regaddr, uint8_t *pdata, uint32_t len); // Executes a R or W witht he serif vt as long as the pointers are not null
@@ -242,6 +266,7 @@ extern int memcmp(const void *, const void *, size_t); // Avoid compiler warning
   ICM_20948_Status_e ICM_20948_set_FIFO_mode(ICM_20948_Device_t *pdev, bool snapshot);
   ICM_20948_Status_e ICM_20948_get_FIFO_count(ICM_20948_Device_t *pdev, uint16_t *count);
   ICM_20948_Status_e ICM_20948_read_FIFO(ICM_20948_Device_t *pdev, uint8_t *data, uint8_t len);
+  ICM_20948_Status_e ICM_20948_read_FIFO_burst(ICM_20948_Device_t *pdev, uint8_t *data, uint16_t len); // Reads len bytes in ICM_20948_FIFO_BURST_MAX sized transactions
 
   // DMP
 
@@ -281,6 +306,7 @@ extern int memcmp(const void *, const void *, size_t); // Avoid compiler warning
   enum inv_icm20948_sensor inv_icm20948_sensor_android_2_sensor_type(int sensor);
 
   ICM_20948_Status_e inv_icm20948_read_dmp_data(ICM_20948_Device_t *pdev, icm_20948_DMP_data_t *data);
+  ICM_20948_Status_e inv_icm20948_parse_dmp_data(const uint8_t *fifo, uint16_t available, icm_20948_DMP_data_t *data, uint16_t *consumed); // Parses one packet from FIFO bytes already read with ICM_20948_read_FIFO_burst
   ICM_20948_Status_e inv_icm20948_set_gyro_sf(ICM_20948_Device_t *pdev, unsigned char div, int gyro_level);
 
   // ToDo:
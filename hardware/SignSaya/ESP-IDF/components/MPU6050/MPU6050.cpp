@@ -2803,6 +2803,114 @@ void MPU6050_Base::setFIFOTimeout(uint32_t fifoTimeout) {
      return 1;
 }
 
+/** Read every complete packet in the FIFO buffer, oldest first.
+ * Unlike GetCurrentFIFOPacket nothing is discarded: packets beyond maxPackets
+ * stay in the FIFO for the next call. Each packet gets a sample time derived
+ * from the sample period, anchored so the newest buffered packet is now and
+ * kept on an even grid from one call to the next. An overflowed FIFO cannot be
+ * realigned, so it is reset and the lost packets are added to the dropped count.
+ * A failed or short chunk read is handled the same way, none of its packets
+ * are returned.
+ * @param data Buffer for maxPackets * length bytes
+ * @param length Packet length in bytes
+ * @param maxPackets Number of packets data and timestamps can hold
+ * @param samplePeriod Time between packets in microseconds
+ * @param timestamps Optional micros() sample time of each packet
+ * @return Number of packets read
+ */
+uint16_t MPU6050_Base::GetFIFOPackets(uint8_t *data, uint8_t length, uint16_t maxPackets, uint32_t samplePeriod, uint32_t *timestamps) {
+    uint16_t fifoC = getFIFOCount();
+    uint32_t now = micros();
+
+    if (fifoC >= MPU6050_FIFO_SIZE) {
+        // the FIFO overwrote its oldest bytes, everything since the last read is gone
+        fifoOverflows++;
+        if (fifoLastRead != 0 && samplePeriod > 0) {
+            fifoDroppedPackets += (now - fifoLastRead) / samplePeriod;
+        } else {
+            fifoDroppedPackets += MPU6050_FIFO_SIZE / length;
+        }
+        resetFIFO();
+        fifoTimeValid = false;
+        fifoLastRead = now;
+        return 0;
+    }
+
+    uint16_t buffered = fifoC / length;
+    uint16_t packets = buffered < maxPackets ? buffered : maxPackets;
+    uint16_t bytes = packets * length;
+    uint16_t offset = 0;
+
+#ifdef ESP_PLATFORM
+    // with a bus worker running the chunks are queued together and run back
+    // to back while the timestamps below are worked out
+    I2CdevTransaction transfers[I2CDEV_ASYNC_QUEUE_LENGTH];
+    uint8_t queued = 0;
+    while (offset < bytes && queued < I2CDEV_ASYNC_QUEUE_LENGTH) {
+        uint8_t chunk = (bytes - offset < MPU6050_FIFO_CHUNK_SIZE) ? bytes - offset : MPU6050_FIFO_CHUNK_SIZE;
+        if (!I2CdevAsync::readBytes(&transfers[queued], devAddr, MPU6050_RA_FIFO_R_W, chunk, data + offset, I2Cdev::readTimeout, wireObj)) break;
+        queued++;
+        offset += chunk;
+    }
+#endif
+
+    if (timestamps) {
+        for (uint16_t i = 0; i < packets; i++) {
+            uint32_t anchored = now - (uint32_t)(buffered - 1 - i) * samplePeriod;
+            uint32_t predicted = fifoPacketTime + samplePeriod;
+            int32_t error = (int32_t)(anchored - predicted);
+            // stay on the grid unless a packet went missing or the clocks drifted apart
+            if (fifoTimeValid && error < (int32_t)samplePeriod && error > -(int32_t)samplePeriod) {
+                fifoPacketTime = predicted;
+            } else {
+                fifoPacketTime = anchored;
+            }
+            fifoTimeValid = true;
+            timestamps[i] = fifoPacketTime;
+        }
+    }
+
+    bool failed = false;
+#ifdef ESP_PLATFORM
+    // every queued transfer has to finish before transfers goes out of scope
+    for (uint8_t i = 0; i < queued; i++) {
+        if (I2CdevAsync::wait(&transfers[i]) != transfers[i].length) failed = true;
+    }
+#endif
+    // the rest, or everything when there is no worker, goes the blocking way
+    while (!failed && offset < bytes) {
+        uint8_t chunk = (bytes - offset < MPU6050_FIFO_CHUNK_SIZE) ? bytes - offset : MPU6050_FIFO_CHUNK_SIZE;
+        if (I2Cdev::readBytes(devAddr, MPU6050_RA_FIFO_R_W, chunk, data + offset, I2Cdev::readTimeout, wireObj) != chunk) failed = true;
+        offset += chunk;
+    }
+
+    fifoLastRead = now;
+    if (failed) {
+        // the packet boundaries are lost with the missing bytes
+        fifoDroppedPackets += buffered;
+        resetFIFO();
+        fifoTimeValid = false;
+        return 0;
+    }
+    return packets;
+}
+
+/** Get the number of packets lost to FIFO overflows.
+ * @return Packets dropped since startup
+ * @see GetFIFOPackets()
+ */
+uint32_t MPU6050_Base::getFIFODroppedPackets() {
+    return fifoDroppedPackets;
+}
+
+/** Get the number of FIFO overflows GetFIFOPackets() recovered from.
+ * @return Overflows since startup
+ * @see GetFIFOPackets()
+ */
+uint32_t MPU6050_Base::getFIFOOverflowCount() {
+    return fifoOverflows;
+}
+
 
 /** Write byte to FIFO buffer.
  * @see getFIFOByte()
@@ -615,3 +615,12 @@ uint16_t MPU6050::dmpGetFIFOPacketSize() {
 uint8_t MPU6050::dmpGetCurrentFIFOPacket(uint8_t *data) { // overflow proof
     return(GetCurrentFIFOPacket(data, dmpPacketSize));
 }
+
+// DMP output rate is 200Hz / (1 + MPU6050_DMP_FIFO_RATE_DIVISOR)
+uint32_t MPU6050::dmpGetSamplePeriod() {
+    return 5000UL * (1 + MPU6050_DMP_FIFO_RATE_DIVISOR);
+}
+
+uint16_t MPU6050::dmpGetFIFOPackets(uint8_t *data, uint16_t maxPackets, uint32_t *timestamps) {
+    return GetFIFOPackets(data, dmpPacketSize, maxPackets, dmpGetSamplePeriod(), timestamps);
+}
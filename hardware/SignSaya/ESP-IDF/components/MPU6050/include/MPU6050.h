@@ -436,6 +436,9 @@ THE SOFTWARE.
 #define MPU6050_DMP_MEMORY_CHUNK_SIZE   16
 
 #define MPU6050_FIFO_DEFAULT_TIMEOUT 11000
+#define MPU6050_FIFO_SIZE 1024
+// bytes per GetFIFOPackets() read, I2Cdev reports the count read as an int8_t
+#define MPU6050_FIFO_CHUNK_SIZE (I2CDEVLIB_WIRE_BUFFER_LENGTH < 127 ? I2CDEVLIB_WIRE_BUFFER_LENGTH : 127)
 
 class MPU6050_Base {
     public:
@@ -719,6 +722,9 @@ class MPU6050_Base {
         // FIFO_R_W register
         uint8_t getFIFOByte();
 		int8_t GetCurrentFIFOPacket(uint8_t *data, uint8_t length);
+		uint16_t GetFIFOPackets(uint8_t *data, uint8_t length, uint16_t maxPackets, uint32_t samplePeriod, uint32_t *timestamps);
+		uint32_t getFIFODroppedPackets();
+		uint32_t getFIFOOverflowCount();
         void setFIFOByte(uint8_t data);
         void getFIFOBytes(uint8_t *data, uint8_t length);
         void setFIFOTimeout(uint32_t fifoTimeout);
@@ -839,6 +845,11 @@ class MPU6050_Base {
         void *wireObj;
         uint8_t buffer[14];
         uint32_t fifoTimeout = MPU6050_FIFO_DEFAULT_TIMEOUT;
+        uint32_t fifoLastRead = 0;
+        uint32_t fifoPacketTime = 0;
+        bool fifoTimeValid = false;
+        uint32_t fifoDroppedPackets = 0;
+        uint32_t fifoOverflows = 0;
     
     private:
         int16_t offsets[6];
@@ -0,0 +1,44 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/micro/arena_allocator/two_tier_persistent_buffer_allocator.h"
+
+namespace tflite {
+
+TwoTierPersistentBufferAllocator::TwoTierPersistentBufferAllocator(
+    SingleArenaBufferAllocator* fast_allocator,
+    IPersistentBufferAllocator* main_allocator)
+    : fast_allocator_(fast_allocator), main_allocator_(main_allocator) {}
+
+TwoTierPersistentBufferAllocator::~TwoTierPersistentBufferAllocator() {}
+
+uint8_t* TwoTierPersistentBufferAllocator::AllocatePersistentBuffer(
+    size_t size, size_t alignment) {
+  // Checked up front so a full fast arena falls through quietly instead of
+  // logging a failed tail allocation.
+  if (fast_allocator_->GetAvailableMemory(alignment) >= size + alignment) {
+    uint8_t* result = fast_allocator_->AllocatePersistentBuffer(size, alignment);
+    if (result != nullptr) {
+      return result;
+    }
+  }
+  return main_allocator_->AllocatePersistentBuffer(size, alignment);
+}
+
+size_t TwoTierPersistentBufferAllocator::GetPersistentUsedBytes() const {
+  return fast_allocator_->GetPersistentUsedBytes() +
+         main_allocator_->GetPersistentUsedBytes();
+}
+
+}  // namespace tflite
@@ -0,0 +1,53 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_MICRO_ARENA_ALLOCATOR_TWO_TIER_PERSISTENT_BUFFER_ALLOCATOR_H_
+#define TENSORFLOW_LITE_MICRO_ARENA_ALLOCATOR_TWO_TIER_PERSISTENT_BUFFER_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/micro/arena_allocator/ibuffer_allocator.h"
+#include "tensorflow/lite/micro/arena_allocator/single_arena_buffer_allocator.h"
+#include "tensorflow/lite/micro/compatibility.h"
+
+namespace tflite {
+
+// TwoTierPersistentBufferAllocator is an implementation of
+// IPersistentBufferAllocator over two arenas: persistent buffers come from the
+// tail of the fast arena (e.g. internal SRAM) while it has room and from the
+// main arena (e.g. PSRAM) after that.
+class TwoTierPersistentBufferAllocator : public IPersistentBufferAllocator {
+ public:
+  TwoTierPersistentBufferAllocator(SingleArenaBufferAllocator* fast_allocator,
+                                   IPersistentBufferAllocator* main_allocator);
+  virtual ~TwoTierPersistentBufferAllocator();
+
+  // Allocates persistent memory. The persistent buffer is never freed.
+  // Returns nullptr if neither arena has room.
+  uint8_t* AllocatePersistentBuffer(size_t size, size_t alignment) override;
+
+  // Returns the size of all persistent allocations in both arenas in bytes.
+  size_t GetPersistentUsedBytes() const override;
+
+  TF_LITE_REMOVE_VIRTUAL_DELETE
+ private:
+  SingleArenaBufferAllocator* const fast_allocator_;
+  IPersistentBufferAllocator* const main_allocator_;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_ARENA_ALLOCATOR_TWO_TIER_PERSISTENT_BUFFER_ALLOCATOR_H_
@@ -30,10 +30,6 @@ limitations under the License.
 #include <esp_nn.h>
 #endif
 
-#include <esp_timer.h>
-
-long long fc_total_time = 0;
-
 namespace tflite {
 namespace {
 
@@ -100,7 +96,6 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   const auto& data =
       *(static_cast<const OpDataFullyConnected*>(node->user_data));
 
-  long long start_time = esp_timer_get_time();
   // Checks in Prepare ensure input, output and filter types are all the same.
   switch (input->type) {
     case kTfLiteFloat32: {
@@ -179,7 +174,6 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       return kTfLiteError;
     }
   }
-  fc_total_time += esp_timer_get_time() - start_time;
   return kTfLiteOk;
 }
 
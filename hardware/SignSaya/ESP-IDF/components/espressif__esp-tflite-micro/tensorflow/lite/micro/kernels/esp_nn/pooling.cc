@@ -24,10 +24,6 @@ limitations under the License.
 #include <esp_nn.h>
 #endif
 
-#include <esp_timer.h>
-
-long long pooling_total_time = 0;
-
 namespace tflite {
 
 namespace {
@@ -158,7 +154,6 @@ TfLiteStatus AverageEval(TfLiteContext* context, TfLiteNode* node) {
   TfLiteEvalTensor* output =
       micro::GetEvalOutput(context, node, kPoolingOutputTensor);
 
-  long long start_time = esp_timer_get_time();
   // Inputs and outputs share the same type, guaranteed by the converter.
   switch (input->type) {
     case kTfLiteFloat32:
@@ -181,7 +176,6 @@ TfLiteStatus AverageEval(TfLiteContext* context, TfLiteNode* node) {
                          TfLiteTypeGetName(input->type));
       return kTfLiteError;
   }
-  pooling_total_time += esp_timer_get_time() - start_time;
   return kTfLiteOk;
 }
 
@@ -198,7 +192,6 @@ TfLiteStatus MaxEval(TfLiteContext* context, TfLiteNode* node) {
   TfLiteEvalTensor* output =
       micro::GetEvalOutput(context, node, kPoolingOutputTensor);
 
-  long long start_time = esp_timer_get_time();
   switch (input->type) {
     case kTfLiteFloat32:
       MaxPoolingEvalFloat(context, node, params, data, input, output);
@@ -220,7 +213,6 @@ TfLiteStatus MaxEval(TfLiteContext* context, TfLiteNode* node) {
                          TfLiteTypeGetName(input->type));
       return kTfLiteError;
   }
-  pooling_total_time += esp_timer_get_time() - start_time;
   return kTfLiteOk;
 }
 
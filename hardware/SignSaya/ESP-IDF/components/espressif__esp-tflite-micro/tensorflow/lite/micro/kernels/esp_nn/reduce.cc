@@ -0,0 +1,238 @@
+/* Copyright 2022 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/kernels/internal/reference/reduce.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/mean.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/reduce.h"
+#include "tensorflow/lite/micro/micro_utils.h"
+
+#if ESP_NN
+#include <sdkconfig.h>
+#endif
+
+#if ESP_NN && CONFIG_IDF_TARGET_ESP32S3
+#define REDUCE_MAX_S3_SIMD 1
+#else
+#define REDUCE_MAX_S3_SIMD 0
+#endif
+
+namespace tflite {
+
+namespace {
+
+#if REDUCE_MAX_S3_SIMD
+// Lane-wise max of `rows` 16 byte vectors `stride` bytes apart, written to
+// out. input and stride must be 16 byte aligned, the S3 ignores the low
+// address bits of a 128 bit load.
+void VerticalMax16(const int8_t* input, int rows, int stride, int8_t* out) {
+  alignas(16) int8_t lanes[16];
+  int8_t* lanes_ptr = lanes;
+  asm volatile(
+      "ee.vld.128.xp q0, %[in], %[stride]\n"
+      "loopgtz %[rest], .Lreduce_max_end%=\n"
+      "ee.vld.128.xp q1, %[in], %[stride]\n"
+      "ee.vmax.s8 q0, q0, q1\n"
+      ".Lreduce_max_end%=:\n"
+      "ee.vst.128.ip q0, %[out], 0\n"
+      : [in] "+r"(input), [out] "+r"(lanes_ptr)
+      : [rest] "r"(rows - 1), [stride] "r"(stride)
+      : "memory");
+  memcpy(out, lanes, sizeof(lanes));
+}
+#endif
+
+// Writes the max over each run of the reduced dimension to output. Plain
+// loops over contiguous rows, which the compiler vectorizes on the host.
+void MaxOverRows(const int8_t* __restrict__ input, int reduced, int inner,
+                 int8_t* __restrict__ output) {
+  memcpy(output, input, inner);
+  for (int row = 1; row < reduced; ++row) {
+    const int8_t* __restrict__ values = input + row * inner;
+    for (int i = 0; i < inner; ++i) {
+      output[i] = values[i] > output[i] ? values[i] : output[i];
+    }
+  }
+}
+
+int8_t MaxOfRun(const int8_t* __restrict__ input, int length) {
+  int8_t max_value = input[0];
+  for (int i = 1; i < length; ++i) {
+    max_value = input[i] > max_value ? input[i] : max_value;
+  }
+  return max_value;
+}
+
+// Views input as [outer, reduced, inner] when the reduced axes form one
+// contiguous run of dimensions, false otherwise.
+bool ResolveContiguousAxes(const TfLiteIntArray* dims, const int32_t* axis,
+                           int num_axis, int* outer, int* reduced,
+                           int* inner) {
+  if (num_axis <= 0) {
+    return false;
+  }
+  bool reduce_dim[kMaxNumberOfAxis] = {};
+  if (dims->size > kMaxNumberOfAxis) {
+    return false;
+  }
+  for (int i = 0; i < num_axis; ++i) {
+    int current = axis[i] < 0 ? axis[i] + dims->size : axis[i];
+    if (current < 0 || current >= dims->size) {
+      return false;
+    }
+    reduce_dim[current] = true;
+  }
+  int first = 0;
+  while (!reduce_dim[first]) {
+    ++first;
+  }
+  int last = first;
+  while (last + 1 < dims->size && reduce_dim[last + 1]) {
+    ++last;
+  }
+  for (int dim = last + 1; dim < dims->size; ++dim) {
+    if (reduce_dim[dim]) {
+      return false;
+    }
+  }
+  *outer = 1;
+  *reduced = 1;
+  *inner = 1;
+  for (int dim = 0; dim < dims->size; ++dim) {
+    int* product = dim < first ? outer : (dim <= last ? reduced : inner);
+    *product *= dims->data[dim];
+  }
+  return *outer > 0 && *reduced > 0 && *inner > 0;
+}
+
+}  // namespace
+
+void ReduceMaxContiguousInt8(const int8_t* input, int outer, int reduced,
+                             int inner, int8_t* output) {
+  for (int block = 0; block < outer; ++block) {
+#if REDUCE_MAX_S3_SIMD
+    const bool aligned = (reinterpret_cast<uintptr_t>(input) & 15) == 0;
+    if (aligned && inner % 16 == 0) {
+      for (int lane = 0; lane < inner; lane += 16) {
+        VerticalMax16(input + lane, reduced, inner, output + lane);
+      }
+      input += reduced * inner;
+      output += inner;
+      continue;
+    }
+    if (aligned && inner == 1 && reduced >= 32) {
+      int8_t lanes[16];
+      const int vectors = reduced / 16;
+      VerticalMax16(input, vectors, 16, lanes);
+      int8_t max_value = MaxOfRun(lanes, 16);
+      const int tail = reduced - vectors * 16;
+      if (tail > 0) {
+        const int8_t tail_max = MaxOfRun(input + vectors * 16, tail);
+        max_value = tail_max > max_value ? tail_max : max_value;
+      }
+      *output = max_value;
+      input += reduced;
+      output += 1;
+      continue;
+    }
+#endif
+    if (inner == 1) {
+      *output = MaxOfRun(input, reduced);
+    } else {
+      MaxOverRows(input, reduced, inner, output);
+    }
+    input += reduced * inner;
+    output += inner;
+  }
+}
+
+void* InitReduce(TfLiteContext* context, const char* buffer, size_t length) {
+  return context->AllocatePersistentBuffer(context, sizeof(OpDataReduce));
+}
+
+TfLiteStatus PrepareMax(TfLiteContext* context, TfLiteNode* node) {
+  OpDataReduce* op_data = static_cast<OpDataReduce*>(node->user_data);
+  TF_LITE_ENSURE_OK(context, PrepareMaxHelper(context, node, op_data));
+
+  // PrepareMaxHelper leaves the zero points unset, EvalMax compares them
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input = micro_context->AllocateTempInputTensor(node, 0);
+  TfLiteTensor* output = micro_context->AllocateTempOutputTensor(node, 0);
+  op_data->input_zp = input->params.zero_point;
+  op_data->output_zp = output->params.zero_point;
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(output);
+  return kTfLiteOk;
+}
+
+TfLiteStatus PrepareMeanOrSum(TfLiteContext* context, TfLiteNode* node) {
+  return PrepareMeanOrSumHelper(context, node,
+                                static_cast<OpDataReduce*>(node->user_data));
+}
+
+TfLiteStatus EvalMean(TfLiteContext* context, TfLiteNode* node) {
+  return EvalMeanHelper(context, node,
+                        static_cast<OpDataReduce*>(node->user_data));
+}
+
+TfLiteStatus EvalMax(TfLiteContext* context, TfLiteNode* node) {
+  OpDataReduce* op_data = static_cast<OpDataReduce*>(node->user_data);
+  const TfLiteEvalTensor* input = tflite::micro::GetEvalInput(context, node, 0);
+  const TfLiteEvalTensor* axis = tflite::micro::GetEvalInput(context, node, 1);
+  TfLiteEvalTensor* output = tflite::micro::GetEvalOutput(context, node, 0);
+
+  int outer, reduced, inner;
+  if (input->type == kTfLiteInt8 && output->type == kTfLiteInt8 &&
+      op_data->input_scale == op_data->output_scale &&
+      op_data->input_zp == op_data->output_zp &&
+      ResolveContiguousAxes(input->dims,
+                            tflite::micro::GetTensorData<int32_t>(axis),
+                            static_cast<int>(ElementCount(*axis->dims)),
+                            &outer, &reduced, &inner)) {
+    ReduceMaxContiguousInt8(tflite::micro::GetTensorData<int8_t>(input),
+                            outer, reduced, inner,
+                            tflite::micro::GetTensorData<int8_t>(output));
+    return kTfLiteOk;
+  }
+  return EvalMaxHelper(context, node, op_data);
+}
+
+TfLiteStatus EvalSum(TfLiteContext* context, TfLiteNode* node) {
+  return EvalSumHelper(context, node,
+                       static_cast<OpDataReduce*>(node->user_data));
+}
+
+TFLMRegistration Register_MEAN() {
+  return tflite::micro::RegisterOp(InitReduce, PrepareMeanOrSum, EvalMean);
+}
+
+TFLMRegistration Register_REDUCE_MAX() {
+  return tflite::micro::RegisterOp(InitReduce, PrepareMax, EvalMax);
+}
+
+TFLMRegistration Register_SUM() {
+  return tflite::micro::RegisterOp(InitReduce, PrepareMeanOrSum, EvalSum);
+}
+
+}  // namespace tflite
@@ -56,6 +56,11 @@ TfLiteStatus EvalSumHelper(TfLiteContext* context, TfLiteNode* node,
 void ReduceResolveAxis(const int* axis_data, int axis_count,
                        MeanParams* op_params);
 
+// Max over the middle dimension of input viewed as [outer, reduced, inner],
+// the int8 ReduceMax path in kernels/esp_nn/reduce.cc for contiguous axes.
+void ReduceMaxContiguousInt8(const int8_t* input, int outer, int reduced,
+                             int inner, int8_t* output);
+
 TFLMRegistration Register_MEAN();
 TFLMRegistration Register_REDUCE_MAX();
 TFLMRegistration Register_SUM();
@@ -199,6 +199,7 @@ TfLiteStatus AllocationInfoBuilder::InitializeAllocationInfo(
 
       current->first_created = kUninitializedLifetime;
       current->last_used = kUninitializedLifetime;
+      current->in_fast_arena = false;
       current->needs_allocating =
           (eval_tensors[i].data.data == nullptr) &&
           (!subgraph->tensors()->Get(i)->is_variable()) &&
@@ -225,6 +226,7 @@ TfLiteStatus AllocationInfoBuilder::InitializeAllocationInfo(
     current->first_created = kUninitializedLifetime;
     current->last_used = kUninitializedLifetime;
     current->needs_allocating = true;
+    current->in_fast_arena = false;
     current->offline_offset = kOnlinePlannedBuffer;
   }
   return kTfLiteOk;
@@ -31,6 +31,7 @@ struct AllocationInfo {
   int last_used;
   int32_t offline_offset;
   bool needs_allocating;
+  bool in_fast_arena;
 };
 
 // Used to hold the allocation info list and related metadata for the entire
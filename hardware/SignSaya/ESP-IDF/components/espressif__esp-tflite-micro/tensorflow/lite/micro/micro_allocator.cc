@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/lite/micro/arena_allocator/non_persistent_arena_buffer_allocator.h"
 #include "tensorflow/lite/micro/arena_allocator/persistent_arena_buffer_allocator.h"
 #include "tensorflow/lite/micro/arena_allocator/single_arena_buffer_allocator.h"
+#include "tensorflow/lite/micro/arena_allocator/two_tier_persistent_buffer_allocator.h"
 #include "tensorflow/lite/micro/compatibility.h"
 #include "tensorflow/lite/micro/flatbuffer_utils.h"
 #include "tensorflow/lite/micro/memory_helpers.h"
@@ -94,16 +95,20 @@ MicroMemoryPlanner* CreateMemoryPlanner(
   return memory_planner;
 }
 
+// Plans the buffers that need allocating in the given arena, the fast one or
+// the main one. Offline offsets are into the main arena, buffers moved to the
+// fast one are planned online there.
 TfLiteStatus CreatePlan(MicroMemoryPlanner* planner,
                         const AllocationInfo* allocation_info,
-                        size_t allocation_info_size) {
+                        size_t allocation_info_size,
+                        bool fast_arena = false) {
   // Add the tensors to our allocation plan.
   for (size_t i = 0; i < allocation_info_size; ++i) {
     const AllocationInfo* current = &allocation_info[i];
-    if (current->needs_allocating) {
+    if (current->needs_allocating && current->in_fast_arena == fast_arena) {
       size_t aligned_bytes_required =
           AlignSizeUp(current->bytes, MicroArenaBufferAlignment());
-      if (current->offline_offset == kOnlinePlannedBuffer) {
+      if (fast_arena || current->offline_offset == kOnlinePlannedBuffer) {
         TF_LITE_ENSURE_STATUS(planner->AddBuffer(aligned_bytes_required,
                                                  current->first_created,
                                                  current->last_used));
@@ -119,12 +124,13 @@ TfLiteStatus CreatePlan(MicroMemoryPlanner* planner,
 
 TfLiteStatus CommitPlan(MicroMemoryPlanner* planner, uint8_t* starting_point,
                         const AllocationInfo* allocation_info,
-                        size_t allocation_info_size) {
+                        size_t allocation_info_size,
+                        bool fast_arena = false) {
   // Figure out the actual memory addresses for each buffer, based on the plan.
   int planner_index = 0;
   for (size_t i = 0; i < allocation_info_size; ++i) {
     const AllocationInfo* current = &allocation_info[i];
-    if (current->needs_allocating) {
+    if (current->needs_allocating && current->in_fast_arena == fast_arena) {
       int offset = -1;
       TF_LITE_ENSURE_STATUS(
           planner->GetOffsetForBuffer(planner_index, &offset));
@@ -469,6 +475,52 @@ MicroAllocator* MicroAllocator::Create(uint8_t* persistent_tensor_arena,
   return allocator;
 }
 
+MicroAllocator* MicroAllocator::Create(
+    uint8_t* tensor_arena, size_t arena_size, uint8_t* fast_tensor_arena,
+    size_t fast_arena_size, const ArenaPlacementPolicy& placement_policy,
+    MemoryPlannerType memory_planner_type) {
+  TFLITE_DCHECK(fast_tensor_arena != nullptr);
+  TFLITE_DCHECK(fast_tensor_arena != tensor_arena);
+
+  uint8_t* aligned_arena =
+      AlignPointerUp(tensor_arena, MicroArenaBufferAlignment());
+  size_t aligned_arena_size = tensor_arena + arena_size - aligned_arena;
+  SingleArenaBufferAllocator* memory_allocator =
+      SingleArenaBufferAllocator::Create(aligned_arena, aligned_arena_size);
+
+  uint8_t* aligned_fast_arena =
+      AlignPointerUp(fast_tensor_arena, MicroArenaBufferAlignment());
+  size_t aligned_fast_arena_size =
+      fast_tensor_arena + fast_arena_size - aligned_fast_arena;
+  SingleArenaBufferAllocator* fast_allocator =
+      SingleArenaBufferAllocator::Create(aligned_fast_arena,
+                                         aligned_fast_arena_size);
+
+  IPersistentBufferAllocator* persistent_buffer_allocator = memory_allocator;
+  if (placement_policy.persistent == ArenaTier::kFast) {
+    uint8_t* persistent_allocator_buffer =
+        memory_allocator->AllocatePersistentBuffer(
+            sizeof(TwoTierPersistentBufferAllocator),
+            alignof(TwoTierPersistentBufferAllocator));
+    persistent_buffer_allocator = new (persistent_allocator_buffer)
+        TwoTierPersistentBufferAllocator(fast_allocator, memory_allocator);
+  }
+
+  MicroMemoryPlanner* memory_planner =
+      CreateMemoryPlanner(memory_planner_type, memory_allocator);
+  MicroMemoryPlanner* fast_memory_planner =
+      CreateMemoryPlanner(memory_planner_type, memory_allocator);
+
+  uint8_t* allocator_buffer = memory_allocator->AllocatePersistentBuffer(
+      sizeof(MicroAllocator), alignof(MicroAllocator));
+  MicroAllocator* allocator = new (allocator_buffer) MicroAllocator(
+      persistent_buffer_allocator, memory_allocator, memory_planner);
+  allocator->fast_buffer_allocator_ = fast_allocator;
+  allocator->fast_memory_planner_ = fast_memory_planner;
+  allocator->placement_policy_ = placement_policy;
+  return allocator;
+}
+
 SubgraphAllocations* MicroAllocator::StartModelAllocation(const Model* model) {
   TFLITE_DCHECK(model != nullptr);
 
@@ -607,8 +659,21 @@ TfLiteStatus MicroAllocator::FinishPrepareNodeAllocations(int node_id) {
 }
 
 size_t MicroAllocator::used_bytes() const {
+  size_t fast_head_bytes =
+      fast_buffer_allocator_ != nullptr
+          ? fast_buffer_allocator_->GetNonPersistentUsedBytes()
+          : 0;
   return non_persistent_buffer_allocator_->GetNonPersistentUsedBytes() +
-         persistent_buffer_allocator_->GetPersistentUsedBytes();
+         persistent_buffer_allocator_->GetPersistentUsedBytes() +
+         fast_head_bytes;
+}
+
+size_t MicroAllocator::fast_used_bytes() const {
+  if (fast_buffer_allocator_ == nullptr) {
+    return 0;
+  }
+  return fast_buffer_allocator_->GetNonPersistentUsedBytes() +
+         fast_buffer_allocator_->GetPersistentUsedBytes();
 }
 
 TfLiteStatus MicroAllocator::AllocateNodeAndRegistrations(
@@ -881,6 +946,11 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
   int allocation_info_count = builder.AllocationCount();
   AllocationInfo* allocation_info = builder.Finish();
 
+  if (fast_buffer_allocator_ != nullptr) {
+    TF_LITE_ENSURE_STATUS(
+        CommitFastMemoryPlan(allocation_info, allocation_info_count));
+  }
+
   // Remaining arena size that memory planner can use for calculating offsets.
   size_t remaining_arena_size =
       non_persistent_buffer_allocator_->GetAvailableMemory(
@@ -934,6 +1004,72 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
   return kTfLiteOk;
 }
 
+TfLiteStatus MicroAllocator::CommitFastMemoryPlan(
+    AllocationInfo* allocation_info, size_t allocation_info_count) {
+  // Scratch buffer requests are the last entries of the allocation info.
+  size_t scratch_offset = allocation_info_count - scratch_buffer_request_count_;
+  bool any_fast = false;
+  // The placement wins over an offline plan, the moved buffers leave holes
+  // in the main arena's offline layout but nothing there overlaps them.
+  for (size_t i = 0; i < allocation_info_count; ++i) {
+    AllocationInfo* current = &allocation_info[i];
+    bool is_scratch = i >= scratch_offset;
+    if (!current->needs_allocating) {
+      continue;
+    }
+    if (is_scratch) {
+      current->in_fast_arena =
+          placement_policy_.scratch == ArenaTier::kFast;
+    } else {
+      current->in_fast_arena =
+          placement_policy_.activations == ArenaTier::kFast &&
+          current->bytes <= placement_policy_.activation_fast_max_bytes;
+    }
+    any_fast = any_fast || current->in_fast_arena;
+  }
+  if (!any_fast) {
+    return kTfLiteOk;
+  }
+
+  size_t fast_arena_size = fast_buffer_allocator_->GetAvailableMemory(
+      MicroArenaBufferAlignment());
+  uint8_t* planner_arena = fast_buffer_allocator_->AllocateTemp(
+      fast_arena_size, MicroArenaBufferAlignment());
+  if (planner_arena == nullptr) {
+    return kTfLiteError;
+  }
+  fast_memory_planner_->Init(planner_arena, fast_arena_size);
+  bool fits = CreatePlan(fast_memory_planner_, allocation_info,
+                         allocation_info_count, true) == kTfLiteOk;
+  size_t fast_head_usage =
+      fits ? fast_memory_planner_->GetMaximumMemorySize() : 0;
+  fits = fits && fast_head_usage <= fast_arena_size;
+  if (fits) {
+    TF_LITE_ENSURE_STATUS(CommitPlan(
+        fast_memory_planner_, fast_buffer_allocator_->GetOverlayMemoryAddress(),
+        allocation_info, allocation_info_count, true));
+  }
+  fast_buffer_allocator_->DeallocateTemp(planner_arena);
+  TF_LITE_ENSURE_STATUS(fast_buffer_allocator_->ResetTempAllocations());
+
+  if (!fits) {
+    MicroPrintf(
+        "Fast arena too small for its buffers (%u bytes available), "
+        "planning them in the main arena",
+        fast_arena_size);
+    for (size_t i = 0; i < allocation_info_count; ++i) {
+      allocation_info[i].in_fast_arena = false;
+    }
+    return kTfLiteOk;
+  }
+
+  if (max_fast_head_buffer_usage_ < fast_head_usage) {
+    max_fast_head_buffer_usage_ = fast_head_usage;
+  }
+  return fast_buffer_allocator_->ReserveNonPersistentOverlayMemory(
+      max_fast_head_buffer_usage_, MicroArenaBufferAlignment());
+}
+
 TfLiteStatus MicroAllocator::AllocateScratchBufferHandles(
     ScratchBufferHandle** scratch_buffer_handles, size_t handle_count) {
   TFLITE_DCHECK(scratch_buffer_handles != nullptr);
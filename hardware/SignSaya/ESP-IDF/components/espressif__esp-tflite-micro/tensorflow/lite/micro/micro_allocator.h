@@ -28,6 +28,8 @@ limitations under the License.
 
 namespace tflite {
 
+struct AllocationInfo;
+
 // TODO(b/199402574): rename to tflite_internal or just remove internal
 // namespace.
 namespace internal {
@@ -93,6 +95,25 @@ struct SubgraphAllocations {
   TfLiteEvalTensor* tensors;
 };
 
+// Memory an arena buffer is placed in when the MicroAllocator is created with
+// a fast arena next to the main one, e.g. internal SRAM next to PSRAM.
+enum class ArenaTier { kMain, kFast };
+
+// Placement of each class of arena buffer across the two arenas. Buffers
+// placed in the fast arena are planned on their own over its head; if that
+// plan does not fit, every buffer is planned in the main arena instead.
+struct ArenaPlacementPolicy {
+  // Buffers kernels request through RequestScratchBufferInArena().
+  ArenaTier scratch = ArenaTier::kFast;
+  // Online planned activation tensors of at most activation_fast_max_bytes.
+  ArenaTier activations = ArenaTier::kMain;
+  size_t activation_fast_max_bytes = SIZE_MAX;
+  // Persistent buffers (tensor structs, op data, ...) come from the fast
+  // arena's tail while it has room and from the main arena after that. As
+  // they are allocated before the plan, they can crowd out the fast plan.
+  ArenaTier persistent = ArenaTier::kMain;
+};
+
 // Allocator responsible for allocating memory for all intermediate tensors
 // necessary to invoke a model.
 //
@@ -151,6 +172,15 @@ class MicroAllocator {
       uint8_t* non_persistent_tensor_arena, size_t non_persistent_arena_size,
       MemoryPlannerType memory_planner_type = MemoryPlannerType::kGreedy);
 
+  // Creates a MicroAllocator instance over a main tensor arena and a second,
+  // faster one. Which buffers go to the fast arena is set by the placement
+  // policy, the rest and the allocator's own bookkeeping stay in the main
+  // arena. Both arenas should be 16 bytes aligned.
+  static MicroAllocator* Create(
+      uint8_t* tensor_arena, size_t arena_size, uint8_t* fast_tensor_arena,
+      size_t fast_arena_size, const ArenaPlacementPolicy& placement_policy,
+      MemoryPlannerType memory_planner_type = MemoryPlannerType::kGreedy);
+
   // Returns the fixed amount of memory overhead of MicroAllocator.
   static size_t GetDefaultTailUsage(bool is_memory_planner_given);
 
@@ -248,6 +278,9 @@ class MicroAllocator {
   // `FinishModelAllocation`. Otherwise, it will return 0.
   size_t used_bytes() const;
 
+  // Returns the part of used_bytes() in the fast arena, 0 without one.
+  size_t fast_used_bytes() const;
+
   TfLiteBridgeBuiltinDataAllocator* GetBuiltinDataAllocator();
 
  protected:
@@ -303,6 +336,12 @@ class MicroAllocator {
       const Model* model, SubgraphAllocations* allocations,
       ScratchBufferHandle* scratch_buffer_handles);
 
+  // Plans the buffers the placement policy puts in the fast arena over its
+  // head and marks them so the main plan skips them. Falls back to leaving
+  // every buffer to the main plan when the fast plan does not fit.
+  TfLiteStatus CommitFastMemoryPlan(AllocationInfo* allocation_info,
+                                    size_t allocation_info_count);
+
   // Allocates an array of ScratchBufferHandle structs in the tail section for a
   // given number of handles.
   virtual TfLiteStatus AllocateScratchBufferHandles(
@@ -340,6 +379,12 @@ class MicroAllocator {
   // to ensure that multi-tenant allocations can share the head for buffers.
   size_t max_head_buffer_usage_ = 0;
 
+  // The fast arena and its planner, only set up by the two arena Create().
+  SingleArenaBufferAllocator* fast_buffer_allocator_ = nullptr;
+  MicroMemoryPlanner* fast_memory_planner_ = nullptr;
+  ArenaPlacementPolicy placement_policy_;
+  size_t max_fast_head_buffer_usage_ = 0;
+
   TF_LITE_REMOVE_VIRTUAL_DELETE
 };
 
@@ -26,13 +26,38 @@ limitations under the License.
 
 #include "tensorflow/lite/micro/micro_time.h"
 
-#if defined(TF_LITE_USE_CTIME)
+#if defined(ESP_PLATFORM)
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#elif defined(__linux__)
+#include <time.h>
+#elif defined(TF_LITE_USE_CTIME)
 #include <ctime>
 #endif
 
 namespace tflite {
 
-#if !defined(TF_LITE_USE_CTIME)
+#if defined(ESP_PLATFORM)
+
+// CPU cycle counter, one tick per core clock. Wraps every ~18 s at 240 MHz,
+// which only matters for events longer than that.
+uint32_t ticks_per_second() { return esp_rom_get_cpu_ticks_per_us() * 1000000u; }
+
+uint32_t GetCurrentTimeTicks() { return (uint32_t)esp_cpu_get_cycle_count(); }
+
+#elif defined(__linux__)
+
+// Monotonic clock in microseconds, so host and device durations read the same
+// once divided by ticks_per_second().
+uint32_t ticks_per_second() { return 1000000; }
+
+uint32_t GetCurrentTimeTicks() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((uint64_t)now.tv_sec * 1000000u + now.tv_nsec / 1000);
+}
+
+#elif !defined(TF_LITE_USE_CTIME)
 
 // Reference implementation of the ticks_per_second() function that's required
 // for a platform to support Tensorflow Lite for Microcontrollers profiling.
@@ -0,0 +1,320 @@
+// Sizes the tensor arena for the signsaya model with RecordingMicroAllocator
+// and writes main/arenaPlan.h, which AiModel uses for the arena size and its
+// SRAM/PSRAM placement. Rerun it whenever ACTIVE_MODEL changes (main/model.h,
+// or main/modelFused.h with USE_FUSED_MODEL), the header records the model
+// size and aiTest.h refuses to build against a stale one.
+// Run: ./arena_plan [--sram-budget BYTES] [--header path/to/arenaPlan.h]
+//
+// The host runs the reference kernels. The esp_nn kernels on the S3 request
+// extra scratch of their own, estimated here the way esp-nn sizes it. Host
+// pointers are 64 bit, so the persistent part is an upper bound for the S3.
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+#include "config.h"
+#include "activeModel.h"
+#include "modelOps.h"
+#include "tensorflow/lite/core/api/flatbuffer_conversions.h"
+#include "tensorflow/lite/micro/arena_allocator/recording_single_arena_buffer_allocator.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+#include "tensorflow/lite/micro/recording_micro_interpreter.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+static const size_t kArenaLimit = 2 * 1024 * 1024;
+static const size_t kArenaGranularity = 1024;  // generated size is rounded up to this
+// on top of the minimum, covers bookkeeping that differs from the host run,
+// e.g. the fast arena's planner when the arena is split
+static const size_t kArenaHeadroom = 1024;
+static const size_t kDefaultSramBudget = 160 * 1024;
+
+static size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+static tflite::BuiltinOperator opCode(const tflite::Model *model, const tflite::Operator *op) {
+  const tflite::OperatorCode *code = model->operator_codes()->Get(op->opcode_index());
+  return std::max(static_cast<tflite::BuiltinOperator>(code->deprecated_builtin_code()), code->builtin_code());
+}
+
+static int dimOf(const tflite::Tensor *tensor, int index) {
+  return tensor->shape()->Get(index);
+}
+
+static size_t tensorBytes(const tflite::Tensor *tensor) {
+  TfLiteType type;
+  size_t typeSize = 0;
+  if (tflite::ConvertTensorType(tensor->type(), &type) != kTfLiteOk
+      || tflite::TfLiteTypeSizeOf(type, &typeSize) != kTfLiteOk) {
+    return 0;
+  }
+  size_t elements = 1;
+  if (tensor->shape() != nullptr) {
+    for (uint32_t dim = 0; dim < tensor->shape()->size(); dim++) {
+      elements *= tensor->shape()->Get(dim);
+    }
+  }
+  return elements * typeSize;
+}
+
+static bool isConstant(const tflite::Model *model, const tflite::Tensor *tensor) {
+  const tflite::Buffer *buffer = model->buffers()->Get(tensor->buffer());
+  return buffer != nullptr && buffer->data() != nullptr && buffer->data()->size() > 0;
+}
+
+struct Activation {
+  int tensor;
+  size_t bytes;
+  int firstOp;
+  int lastOp;
+};
+
+// Non constant tensors with the op range they are alive for, the same
+// lifetimes MicroAllocator hands to the memory planner
+static std::vector<Activation> activationsOf(const tflite::Model *model) {
+  const tflite::SubGraph *subgraph = model->subgraphs()->Get(0);
+  int opCount = subgraph->operators()->size();
+  std::vector<Activation> activations;
+  for (uint32_t index = 0; index < subgraph->tensors()->size(); index++) {
+    const tflite::Tensor *tensor = subgraph->tensors()->Get(index);
+    if (isConstant(model, tensor) || tensor->is_variable()) {
+      continue;
+    }
+    Activation entry = { (int)index, tensorBytes(tensor), -1, -1 };
+    for (uint32_t input = 0; input < subgraph->inputs()->size(); input++) {
+      if (subgraph->inputs()->Get(input) == (int)index) entry.firstOp = 0;
+    }
+    for (uint32_t output = 0; output < subgraph->outputs()->size(); output++) {
+      if (subgraph->outputs()->Get(output) == (int)index) entry.lastOp = opCount - 1;
+    }
+    for (int opIndex = 0; opIndex < opCount; opIndex++) {
+      const tflite::Operator *op = subgraph->operators()->Get(opIndex);
+      for (uint32_t output = 0; output < op->outputs()->size(); output++) {
+        if (op->outputs()->Get(output) == (int)index && entry.firstOp < 0) entry.firstOp = opIndex;
+      }
+      for (uint32_t input = 0; input < op->inputs()->size(); input++) {
+        if (op->inputs()->Get(input) == (int)index) entry.lastOp = std::max(entry.lastOp, opIndex);
+      }
+    }
+    if (entry.firstOp >= 0 && entry.lastOp >= entry.firstOp) {
+      activations.push_back(entry);
+    }
+  }
+  return activations;
+}
+
+static size_t plannedActivationBytes(const std::vector<Activation> &activations) {
+  static unsigned char plannerScratch[8192];
+  tflite::GreedyMemoryPlanner planner;
+  planner.Init(plannerScratch, sizeof(plannerScratch));
+  for (const Activation &entry : activations) {
+    planner.AddBuffer(alignUp(entry.bytes, tflite::MicroArenaBufferAlignment()), entry.firstOp, entry.lastOp);
+  }
+  return planner.GetMaximumMemorySize();
+}
+
+// Scratch the esp_nn kernels request on the S3 on top of what the reference
+// kernels ask for, after esp_nn_get_conv_scratch_size_esp32s3 and
+// esp_nn_get_softmax_scratch_size_opt. Alive for their own op only.
+static std::vector<Activation> espNnScratchOf(const tflite::Model *model) {
+  const tflite::SubGraph *subgraph = model->subgraphs()->Get(0);
+  std::vector<Activation> buffers;
+  for (uint32_t opIndex = 0; opIndex < subgraph->operators()->size(); opIndex++) {
+    const tflite::Operator *op = subgraph->operators()->Get(opIndex);
+    const tflite::Tensor *input = subgraph->tensors()->Get(op->inputs()->Get(0));
+    size_t bytes = 0;
+    if (opCode(model, op) == tflite::BuiltinOperator_CONV_2D) {
+      const tflite::Tensor *filter = subgraph->tensors()->Get(op->inputs()->Get(1));
+      // VALID padding only, SAME would add the padded border to the input copy
+      size_t inputBytes = (size_t)dimOf(input, 1) * dimOf(input, 2) * dimOf(input, 3);
+      size_t transposeBytes = dimOf(input, 1) * dimOf(input, 2) < 8 ? 0 : 2 * 8 * dimOf(input, 3);
+      bytes = 2 * (tensorBytes(filter) + inputBytes) + transposeBytes + 32;
+    } else if (opCode(model, op) == tflite::BuiltinOperator_SOFTMAX) {
+      bytes = 4 * dimOf(input, input->shape()->size() - 1);
+    }
+    if (bytes > 0) {
+      buffers.push_back({ -1, bytes, (int)opIndex, (int)opIndex });
+    }
+  }
+  return buffers;
+}
+
+// AllocateTensors with a given arena size, quietly, the failures are expected
+static bool allocates(uint8_t *arena, size_t size, const ModelOpResolver &resolver) {
+  fflush(stderr);
+  int savedStderr = dup(STDERR_FILENO);
+  int devNull = open("/dev/null", O_WRONLY);
+  dup2(devNull, STDERR_FILENO);
+  close(devNull);
+  tflite::MicroInterpreter interpreter(tflite::GetModel(ACTIVE_MODEL), resolver, arena, size);
+  bool fits = interpreter.AllocateTensors() == kTfLiteOk;
+  fflush(stderr);
+  dup2(savedStderr, STDERR_FILENO);
+  close(savedStderr);
+  return fits;
+}
+
+struct AllocationType {
+  tflite::RecordedAllocationType type;
+  const char *name;
+};
+
+static const AllocationType allocationTypes[] = {
+  { tflite::RecordedAllocationType::kTfLiteEvalTensorData, "eval tensors" },
+  { tflite::RecordedAllocationType::kPersistentTfLiteTensorData, "persistent tensors" },
+  { tflite::RecordedAllocationType::kPersistentTfLiteTensorQuantizationData, "quantization data" },
+  { tflite::RecordedAllocationType::kPersistentBufferData, "persistent buffers" },
+  { tflite::RecordedAllocationType::kTfLiteTensorVariableBufferData, "variable buffers" },
+  { tflite::RecordedAllocationType::kNodeAndRegistrationArray, "nodes and registrations" },
+  { tflite::RecordedAllocationType::kOpData, "op data" },
+};
+
+int main(int argc, char **argv) {
+  size_t sramBudget = kDefaultSramBudget;
+  const char *headerPath = nullptr;
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "--sram-budget") == 0 && arg + 1 < argc) {
+      sramBudget = strtoul(argv[++arg], nullptr, 0);
+    } else if (strcmp(argv[arg], "--header") == 0 && arg + 1 < argc) {
+      headerPath = argv[++arg];
+    } else {
+      fprintf(stderr, "usage: %s [--sram-budget BYTES] [--header arenaPlan.h]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  const tflite::Model *model = tflite::GetModel(ACTIVE_MODEL);
+  if (model->version() != TFLITE_SCHEMA_VERSION) {
+    fprintf(stderr, "schema version %lu, expected %d\n", (unsigned long)model->version(), TFLITE_SCHEMA_VERSION);
+    return 1;
+  }
+  static ModelOpResolver resolver;
+  if (registerModelOps(resolver) != kTfLiteOk) {
+    fprintf(stderr, "registering ops failed\n");
+    return 1;
+  }
+
+  std::vector<uint8_t> arena(kArenaLimit);
+  tflite::RecordingMicroInterpreter recorder(model, resolver, arena.data(), arena.size());
+  if (recorder.AllocateTensors() != kTfLiteOk) {
+    fprintf(stderr, "AllocateTensors() failed even with %lu bytes\n", (unsigned long)kArenaLimit);
+    return 1;
+  }
+  const tflite::RecordingMicroAllocator &allocator = recorder.GetMicroAllocator();
+  size_t persistentBytes = allocator.GetSimpleMemoryAllocator()->GetPersistentUsedBytes();
+  size_t nonPersistentBytes = allocator.GetSimpleMemoryAllocator()->GetNonPersistentUsedBytes();
+
+  std::vector<Activation> activations = activationsOf(model);
+  size_t activationBytes = std::min(plannedActivationBytes(activations), nonPersistentBytes);
+  size_t scratchBytes = nonPersistentBytes - activationBytes;
+  std::vector<Activation> kernelScratch = espNnScratchOf(model);
+  size_t kernelScratchBytes = 0;
+  for (const Activation &entry : kernelScratch) {
+    kernelScratchBytes += entry.bytes;
+  }
+  // what the esp_nn scratch adds to the head once planned around the
+  // activations, usually less than its size as it fits in their gaps
+  std::vector<Activation> withKernelScratch = activations;
+  withKernelScratch.insert(withKernelScratch.end(), kernelScratch.begin(), kernelScratch.end());
+  size_t kernelScratchGrowth = plannedActivationBytes(withKernelScratch) - plannedActivationBytes(activations);
+
+  // smallest arena AllocateTensors gets through with, it needs a little
+  // temporary room on top of what ends up used
+  size_t low = 0;
+  size_t high = alignUp(recorder.arena_used_bytes() + kArenaGranularity, tflite::MicroArenaBufferAlignment());
+  while (!allocates(arena.data(), high, resolver)) {
+    high *= 2;
+  }
+  while (high - low > tflite::MicroArenaBufferAlignment()) {
+    size_t middle = alignUp((low + high) / 2, tflite::MicroArenaBufferAlignment());
+    if (middle >= high) break;
+    if (allocates(arena.data(), middle, resolver)) {
+      high = middle;
+    } else {
+      low = middle;
+    }
+  }
+  size_t minimumBytes = high;
+  size_t arenaBytes = alignUp(minimumBytes + kernelScratchGrowth + kArenaHeadroom, kArenaGranularity);
+
+  // Hottest first: kernel scratch is walked in the innermost loops, then the
+  // other scratch. Each class goes to SRAM whole or not at all. The PSRAM
+  // part keeps the rest of the plan, which only shrinks by a class's growth
+  // of the head, so the two together can be more than the single arena.
+  size_t sramBytes = 0;
+  size_t psramBytes = minimumBytes + kernelScratchGrowth + kArenaHeadroom;
+  if (arenaBytes <= sramBudget) {
+    sramBytes = arenaBytes;
+    psramBytes = 0;
+  } else {
+    if (kernelScratchBytes > 0 && kernelScratchBytes <= sramBudget) {
+      sramBytes += alignUp(kernelScratchBytes, tflite::MicroArenaBufferAlignment());
+      psramBytes -= kernelScratchGrowth;
+    }
+    if (scratchBytes > 0 && sramBytes + scratchBytes <= sramBudget) {
+      sramBytes += scratchBytes;
+    }
+    sramBytes = alignUp(sramBytes, kArenaGranularity);
+    psramBytes = alignUp(psramBytes, kArenaGranularity);
+  }
+
+  printf("model: %lu bytes, %lu ops\n", (unsigned long)sizeof(ACTIVE_MODEL),
+         (unsigned long)model->subgraphs()->Get(0)->operators()->size());
+  printf("persistent (tail): %lu bytes\n", (unsigned long)persistentBytes);
+  printf("  %-24s %10s %10s %6s\n", "type", "requested", "used", "count");
+  for (const AllocationType &entry : allocationTypes) {
+    tflite::RecordedAllocation recorded = allocator.GetRecordedAllocation(entry.type);
+    printf("  %-24s %10lu %10lu %6lu\n", entry.name, (unsigned long)recorded.requested_bytes,
+           (unsigned long)recorded.used_bytes, (unsigned long)recorded.count);
+  }
+  printf("non-persistent (head): %lu bytes\n", (unsigned long)nonPersistentBytes);
+  printf("  activations: %lu bytes planned\n", (unsigned long)activationBytes);
+  printf("  scratch: %lu bytes\n", (unsigned long)scratchBytes);
+  std::sort(activations.begin(), activations.end(),
+            [](const Activation &a, const Activation &b) { return a.bytes > b.bytes; });
+  for (const Activation &entry : activations) {
+    const tflite::Tensor *tensor = model->subgraphs()->Get(0)->tensors()->Get(entry.tensor);
+    printf("    %8lu bytes ops %d..%d %s\n", (unsigned long)entry.bytes, entry.firstOp, entry.lastOp,
+           tensor->name() != nullptr ? tensor->name()->c_str() : "");
+  }
+  printf("esp_nn scratch on the S3 (estimated): %lu bytes, grows the head by %lu\n",
+         (unsigned long)kernelScratchBytes, (unsigned long)kernelScratchGrowth);
+  printf("minimum arena on the host: %lu bytes\n", (unsigned long)minimumBytes);
+  printf("arena: %lu bytes, %lu in SRAM (budget %lu), %lu in PSRAM\n", (unsigned long)arenaBytes,
+         (unsigned long)sramBytes, (unsigned long)sramBudget, (unsigned long)psramBytes);
+
+  if (headerPath == nullptr) {
+    return 0;
+  }
+  FILE *header = fopen(headerPath, "w");
+  if (header == nullptr) {
+    fprintf(stderr, "can't write %s\n", headerPath);
+    return 1;
+  }
+  fprintf(header, "// Generated by host/arena_plan from ACTIVE_MODEL (activeModel.h), do not edit.\n");
+  fprintf(header, "#pragma once\n\n");
+  fprintf(header, "#define ARENA_PLAN_MODEL_BYTES %lu  // sizeof(ACTIVE_MODEL) this plan was made for\n",
+          (unsigned long)sizeof(ACTIVE_MODEL));
+  fprintf(header, "#define ARENA_PLAN_PERSISTENT_BYTES %lu\n", (unsigned long)persistentBytes);
+  fprintf(header, "#define ARENA_PLAN_ACTIVATION_BYTES %lu\n", (unsigned long)activationBytes);
+  fprintf(header, "#define ARENA_PLAN_SCRATCH_BYTES %lu\n", (unsigned long)scratchBytes);
+  fprintf(header, "#define ARENA_PLAN_KERNEL_SCRATCH_BYTES %lu  // esp_nn only, estimated\n",
+          (unsigned long)kernelScratchBytes);
+  fprintf(header, "#define ARENA_PLAN_MINIMUM_BYTES %lu  // smallest arena the host allocates with\n",
+          (unsigned long)minimumBytes);
+  fprintf(header, "#define ARENA_PLAN_ARENA_SIZE %lu  // one arena holding everything\n", (unsigned long)arenaBytes);
+  fprintf(header, "#define ARENA_PLAN_SRAM_BUDGET %lu\n", (unsigned long)sramBudget);
+  fprintf(header, "#define ARENA_PLAN_SRAM_BYTES %lu  // recommended internal part, hot scratch\n",
+          (unsigned long)sramBytes);
+  fprintf(header, "#define ARENA_PLAN_PSRAM_BYTES %lu  // recommended external part, 0 when it all fits in SRAM\n",
+          (unsigned long)psramBytes);
+  fclose(header);
+  printf("wrote %s\n", headerPath);
+  return 0;
+}
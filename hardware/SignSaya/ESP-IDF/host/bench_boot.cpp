@@ -0,0 +1,221 @@
+// Measures what AiModel::begin costs for ACTIVE_MODEL: time to build the
+// allocator and interpreter and run AllocateTensors, and the peak stack of
+// doing so, measured on a painted thread stack. When the model carries the
+// OfflineMemoryAllocation plan host/fuse_model --offline-plan embeds, it is
+// measured against the same model with the plan stripped, so
+// GreedyMemoryPlanner runs like it does by default. Exits 1 when
+// AllocateTensors does not put the graph outputs where the plan says, or the
+// two variants disagree.
+// Run: ./bench_boot [boots]
+#include <pthread.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "arenaPlan.h"
+#include "config.h"
+#include "activeModel.h"
+#include "modelOps.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+static const char kOfflinePlanName[] = "OfflineMemoryAllocation";
+static const size_t kStackSize = 256 * 1024;
+static const uint8_t kStackPaint = 0xcd;
+
+alignas(16) static uint8_t tensorArena[ARENA_PLAN_ARENA_SIZE];
+static ModelOpResolver resolver;
+
+// The int32 plan of model, or nullptr when it has none
+static const int32_t *offlinePlan(const tflite::Model *model) {
+  if (model->metadata() == nullptr) {
+    return nullptr;
+  }
+  for (const tflite::Metadata *metadata : *model->metadata()) {
+    if (metadata->name() != nullptr && metadata->name()->str() == kOfflinePlanName) {
+      return reinterpret_cast<const int32_t *>(model->buffers()->Get(metadata->buffer())->data()->data());
+    }
+  }
+  return nullptr;
+}
+
+static std::vector<uint64_t> withoutPlan(const uint8_t *source) {
+  std::unique_ptr<tflite::ModelT> model(tflite::GetModel(source)->UnPack());
+  for (size_t index = 0; index < model->metadata.size();) {
+    if (model->metadata[index]->name == kOfflinePlanName) {
+      model->metadata.erase(model->metadata.begin() + index);
+    } else {
+      index++;
+    }
+  }
+  // TFLM's flatbuffers has no fallback for a null allocator, pass one
+  flatbuffers::DefaultAllocator allocator;
+  flatbuffers::FlatBufferBuilder builder(1024, &allocator);
+  builder.Finish(tflite::Model::Pack(builder, model.get()), tflite::ModelIdentifier());
+  std::vector<uint64_t> aligned((builder.GetSize() + 15) / 8);
+  memcpy(aligned.data(), builder.GetBufferPointer(), builder.GetSize());
+  return aligned;
+}
+
+// What AiModel::begin does, on the stack like there
+static bool boot(const tflite::Model *model, size_t *arenaUsed) {
+  tflite::MicroAllocator *allocator = tflite::MicroAllocator::Create(tensorArena, sizeof(tensorArena));
+  tflite::MicroInterpreter interpreter(model, resolver, allocator);
+  if (interpreter.AllocateTensors() != kTfLiteOk) {
+    return false;
+  }
+  if (arenaUsed != nullptr) {
+    *arenaUsed = interpreter.arena_used_bytes();
+  }
+  return true;
+}
+
+struct StackRun {
+  const tflite::Model *model;
+  bool ok;
+};
+
+static void *bootThread(void *argument) {
+  StackRun *run = static_cast<StackRun *>(argument);
+  run->ok = run->model == nullptr || boot(run->model, nullptr);
+  return nullptr;
+}
+
+// Bytes of a painted thread stack touched by one boot, nullptr model for the
+// thread's own overhead
+static size_t peakStack(const tflite::Model *model, bool *ok) {
+  std::vector<uint8_t> stack(kStackSize);
+  memset(stack.data(), kStackPaint, stack.size());
+  pthread_attr_t attributes;
+  pthread_attr_init(&attributes);
+  pthread_attr_setstack(&attributes, stack.data(), stack.size());
+  StackRun run = {model, false};
+  pthread_t thread;
+  if (pthread_create(&thread, &attributes, bootThread, &run) != 0) {
+    pthread_attr_destroy(&attributes);
+    *ok = false;
+    return 0;
+  }
+  pthread_join(thread, nullptr);
+  pthread_attr_destroy(&attributes);
+  *ok = run.ok;
+  // the stack grows down, the lowest repainted byte is the high-water mark
+  size_t untouched = 0;
+  while (untouched < stack.size() && stack[untouched] == kStackPaint) {
+    untouched++;
+  }
+  return stack.size() - untouched;
+}
+
+// The graph outputs sit where the plan puts them relative to the input, the
+// interpreter only hands out those tensors without preserving all of them
+static bool followsPlan(const tflite::Model *model, const int32_t *plan) {
+  tflite::MicroAllocator *allocator = tflite::MicroAllocator::Create(tensorArena, sizeof(tensorArena));
+  tflite::MicroInterpreter interpreter(model, resolver, allocator);
+  if (interpreter.AllocateTensors() != kTfLiteOk) {
+    return false;
+  }
+  const tflite::SubGraph *graph = model->subgraphs()->Get(0);
+  const int32_t *offsets = plan + 3;
+  const uint8_t *base = interpreter.input(0)->data.uint8 - offsets[graph->inputs()->Get(0)];
+  for (size_t index = 0; index < graph->outputs()->size(); index++) {
+    int32_t offset = offsets[graph->outputs()->Get(index)];
+    long placed = (long)(interpreter.output(index)->data.uint8 - base);
+    if (offset < 0 || placed != offset) {
+      fprintf(stderr, "output %lu at %ld, plan says %d\n", (unsigned long)index, placed, (int)offset);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool sameOutputs(const tflite::Model *online, const tflite::Model *offline) {
+  std::vector<uint8_t> onlineArena(ARENA_PLAN_ARENA_SIZE);
+  std::vector<uint8_t> offlineArena(ARENA_PLAN_ARENA_SIZE);
+  tflite::MicroInterpreter first(online, resolver, onlineArena.data(), onlineArena.size());
+  tflite::MicroInterpreter second(offline, resolver, offlineArena.data(), offlineArena.size());
+  if (first.AllocateTensors() != kTfLiteOk || second.AllocateTensors() != kTfLiteOk) {
+    return false;
+  }
+  srand(1);
+  for (int window = 0; window < 8; window++) {
+    for (size_t index = 0; index < first.input(0)->bytes; index++) {
+      first.input(0)->data.uint8[index] = (uint8_t)(rand() % 256);
+    }
+    memcpy(second.input(0)->data.uint8, first.input(0)->data.uint8, first.input(0)->bytes);
+    if (first.Invoke() != kTfLiteOk || second.Invoke() != kTfLiteOk
+        || memcmp(first.output(0)->data.uint8, second.output(0)->data.uint8, first.output(0)->bytes) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  uint32_t boots = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 20000;
+  if (boots == 0) {
+    boots = 1;
+  }
+  if (registerModelOps(resolver) != kTfLiteOk) {
+    return 1;
+  }
+  struct Variant {
+    const char *name;
+    const tflite::Model *model;
+  } variants[2];
+  int variantCount = 0;
+  const tflite::Model *shipped = tflite::GetModel(ACTIVE_MODEL);
+  const int32_t *plan = offlinePlan(shipped);
+  std::vector<uint64_t> stripped;
+  if (plan != nullptr) {
+    stripped = withoutPlan(ACTIVE_MODEL);
+    const tflite::Model *online = tflite::GetModel(stripped.data());
+    if (!followsPlan(shipped, plan)) {
+      fprintf(stderr, "AllocateTensors did not follow the offline plan\n");
+      return 1;
+    }
+    if (!sameOutputs(online, shipped)) {
+      fprintf(stderr, "the planned and unplanned model disagree\n");
+      return 1;
+    }
+    variants[variantCount++] = {"online", online};
+    variants[variantCount++] = {"offline", shipped};
+  } else {
+    variants[variantCount++] = {"online", shipped};
+  }
+
+  bool ok;
+  size_t threadOverhead = peakStack(nullptr, &ok);
+  printf("%-8s %10s %10s %12s\n", "plan", "boot_us", "stack_b", "arena_used_b");
+  for (int index = 0; index < variantCount; index++) {
+    const Variant &variant = variants[index];
+    size_t arenaUsed = 0;
+    // warm up, then time the same sequence begin() runs once per power-up
+    if (!boot(variant.model, &arenaUsed)) {
+      fprintf(stderr, "AllocateTensors failed for the %s variant\n", variant.name);
+      return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t repeat = 0; repeat < boots; repeat++) {
+      boot(variant.model, nullptr);
+    }
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / boots;
+    size_t stack = peakStack(variant.model, &ok);
+    if (!ok) {
+      fprintf(stderr, "AllocateTensors failed on the measuring thread for the %s variant\n", variant.name);
+      return 1;
+    }
+    printf("%-8s %10.2f %10lu %12lu\n", variant.name, micros, (unsigned long)(stack - threadOverhead),
+           (unsigned long)arenaUsed);
+  }
+  if (plan != nullptr) {
+    printf("%d tensors, offline plan followed, outputs identical\n", (int)plan[2]);
+  } else {
+    printf("no %s plan in ACTIVE_MODEL, fuse_model --offline-plan adds one to compare\n", kOfflinePlanName);
+  }
+  return 0;
+}
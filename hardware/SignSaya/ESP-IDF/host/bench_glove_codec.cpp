@@ -0,0 +1,308 @@
+// Compression ratio and speed of the gloveCodec.h codec over a recorded
+// session. Every block is decoded again and has to give back the exact rows
+// and timestamps; a second pass drops one block in 7 and checks the decoder
+// skips to the next keyframe and is exact from there on. Exits 1 on any
+// mismatch.
+// Sessions are a rows file (INFERENCE_FEATURES bytes per row, Inference_t
+// order, stamped at FUSION_RATE), a Training Data Gatherer CSV (timestamp in
+// seconds, thumb, index, middle, ring, pinky, quaternion x, y, z, w) or, with
+// neither, a synthetic random walk.
+// Run: ./bench_glove_codec [--input rows.bin | --csv session.csv] [--rows N]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "config.h"
+#include "bleFrame.h"
+#include "gloveCodec.h"
+
+static const int kChannels = INFERENCE_FEATURES;
+typedef GloveEncoder<kChannels> Encoder;
+typedef GloveDecoder<kChannels> Decoder;
+
+struct Session {
+  std::vector<uint8_t> values;  // kChannels per row
+  std::vector<uint32_t> timestamps;
+  size_t rows() const {
+    return timestamps.size();
+  }
+  const uint8_t *row(size_t index) const {
+    return &values[index * kChannels];
+  }
+};
+
+static bool loadRows(const char *path, Session &session) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  uint8_t row[kChannels];
+  uint32_t time = 0;
+  while (fread(row, 1, kChannels, file) == kChannels) {
+    session.values.insert(session.values.end(), row, row + kChannels);
+    session.timestamps.push_back(time);
+    time += 1000000 / FUSION_RATE;
+  }
+  fclose(file);
+  return true;
+}
+
+static bool loadCsv(const char *path, Session &session) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    double seconds;
+    int thumb, index, middle, ring, pinky, x, y, z, w;
+    // the header and the lines fix.py would throw away do not scan
+    if (sscanf(line, "%lf,%d,%d,%d,%d,%d,%d,%d,%d,%d", &seconds, &thumb, &index, &middle, &ring, &pinky, &x, &y, &z,
+               &w) != 10) {
+      continue;
+    }
+    Inference_t row = {(uint8_t)pinky, (uint8_t)ring, (uint8_t)middle, (uint8_t)index, (uint8_t)thumb,
+                       (uint8_t)w, (uint8_t)x, (uint8_t)y, (uint8_t)z};
+    uint8_t values[kChannels];
+    packRow(row, values);
+    session.values.insert(session.values.end(), values, values + kChannels);
+    session.timestamps.push_back((uint32_t)(uint64_t)(seconds * 1e6));
+  }
+  fclose(file);
+  return true;
+}
+
+// Slow drift with some noise and a held value now and then, like a glove
+static void synthetic(size_t rows, Session &session) {
+  int level[kChannels];
+  for (int channel = 0; channel < kChannels; channel++) {
+    level[channel] = 128;
+  }
+  srand(1);
+  uint32_t time = 0xffffffffu - 3000000u;
+  for (size_t row = 0; row < rows; row++) {
+    for (int channel = 0; channel < kChannels; channel++) {
+      if (rand() % 4 != 0) {
+        level[channel] = std::min(255, std::max(0, level[channel] + rand() % 5 - 2));
+      }
+      session.values.push_back((uint8_t)level[channel]);
+    }
+    session.timestamps.push_back(time);
+    time += 1000000 / FUSION_RATE;
+  }
+}
+
+// One encoded session, blocks back to back
+struct Encoded {
+  std::vector<uint8_t> bytes;
+  std::vector<size_t> offsets;  // start of every block, plus the end
+  std::vector<size_t> firstRows;  // first row of every block
+};
+
+// The same push, finish, clear and push again pattern as accelGyroSender,
+// blocks are also closed after rowsPerBlock rows like its flush deadline does
+static Encoded encode(const Session &session, size_t limit, size_t rowsPerBlock) {
+  Encoded encoded;
+  static Encoder encoder;
+  encoder.reset();
+  encoder.setLimit(limit);
+  size_t blockRows = 0;
+  auto close = [&](size_t nextRow) {
+    encoder.finish();
+    encoded.offsets.push_back(encoded.bytes.size());
+    encoded.firstRows.push_back(nextRow - blockRows);
+    encoded.bytes.insert(encoded.bytes.end(), encoder.data(), encoder.data() + encoder.size());
+    encoder.clear();
+    blockRows = 0;
+  };
+  for (size_t index = 0; index < session.rows(); index++) {
+    if (!encoder.push(session.row(index), session.timestamps[index])) {
+      close(index);
+      encoder.push(session.row(index), session.timestamps[index]);
+    }
+    blockRows++;
+    if (encoder.isFull() || blockRows == rowsPerBlock) {
+      close(index + 1);
+    }
+  }
+  if (!encoder.isEmpty()) {
+    close(session.rows());
+  }
+  encoded.offsets.push_back(encoded.bytes.size());
+  return encoded;
+}
+
+// Decodes every block not in the dropped set and compares it with the
+// session, rows of skipped blocks are counted in skippedRows
+static bool decodeAll(const Session &session, const Encoded &encoded, uint32_t dropEvery, size_t *skippedRows,
+                      size_t *droppedBlocks) {
+  static Decoder decoder;
+  decoder.reset();
+  static uint8_t rows[GLOVE_CODEC_BLOCK_ROWS][kChannels];
+  static uint32_t timestamps[GLOVE_CODEC_BLOCK_ROWS];
+  size_t blocks = encoded.firstRows.size();
+  *skippedRows = 0;
+  *droppedBlocks = 0;
+  size_t expectedSkips = 0;
+  bool synced = false;
+  for (size_t block = 0; block < blocks; block++) {
+    if (dropEvery > 0 && block % dropEvery == dropEvery - 1) {
+      (*droppedBlocks)++;
+      synced = false;
+      continue;
+    }
+    const uint8_t *data = &encoded.bytes[encoded.offsets[block]];
+    size_t length = encoded.offsets[block + 1] - encoded.offsets[block];
+    int count = decoder.decode(data, length, rows, timestamps, GLOVE_CODEC_BLOCK_ROWS);
+    size_t firstRow = encoded.firstRows[block];
+    size_t blockRows = (block + 1 < blocks ? encoded.firstRows[block + 1] : session.rows()) - firstRow;
+    // the first block is a keyframe, after a loss only the next keyframe decodes
+    synced = synced || (data[1] & 0x80) != 0;
+    if (!synced) {
+      if (count != 0) {
+        fprintf(stderr, "block %lu decoded without a keyframe after a loss\n", (unsigned long)block);
+        return false;
+      }
+      *skippedRows += blockRows;
+      expectedSkips++;
+      continue;
+    }
+    if (count != (int)blockRows) {
+      fprintf(stderr, "block %lu decoded to %d rows, %lu were encoded\n", (unsigned long)block, count,
+              (unsigned long)blockRows);
+      return false;
+    }
+    for (int row = 0; row < count; row++) {
+      if (memcmp(rows[row], session.row(firstRow + row), kChannels) != 0
+          || timestamps[row] != session.timestamps[firstRow + row]) {
+        fprintf(stderr, "row %lu differs after decoding\n", (unsigned long)(firstRow + row));
+        return false;
+      }
+    }
+  }
+  bool lastDropped = dropEvery > 0 && blocks % dropEvery == 0;
+  if (decoder.lost() != *droppedBlocks - (lastDropped ? 1 : 0) || decoder.skipped() != expectedSkips) {
+    fprintf(stderr, "decoder counted %lu lost and %lu skipped blocks, %lu were dropped\n",
+            (unsigned long)decoder.lost(), (unsigned long)decoder.skipped(), (unsigned long)*droppedBlocks);
+    return false;
+  }
+  return true;
+}
+
+// Every channel at 8 bits and the widest jitter, the most work one block can be
+static double worstBlockMicros() {
+  static uint8_t rows[GLOVE_CODEC_BLOCK_ROWS][kChannels];
+  static uint32_t timestamps[GLOVE_CODEC_BLOCK_ROWS];
+  srand(2);
+  for (int row = 0; row < GLOVE_CODEC_BLOCK_ROWS; row++) {
+    for (int channel = 0; channel < kChannels; channel++) {
+      rows[row][channel] = (uint8_t)(rand() % 256);
+    }
+    timestamps[row] = row == 0 ? 0 : timestamps[row - 1] + 1000 + rand() % 60000;
+  }
+  static Encoder encoder;
+  const int repeats = 20000;
+  auto start = std::chrono::steady_clock::now();
+  for (int repeat = 0; repeat < repeats; repeat++) {
+    encoder.reset();
+    for (int row = 0; row < GLOVE_CODEC_BLOCK_ROWS; row++) {
+      encoder.push(rows[row], timestamps[row]);
+    }
+    encoder.finish();
+  }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+template <typename Function>
+static double nanosPerRow(size_t rows, Function function) {
+  const int repeats = 20;
+  auto start = std::chrono::steady_clock::now();
+  for (int repeat = 0; repeat < repeats; repeat++) {
+    function();
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / repeats / rows;
+}
+
+int main(int argc, char **argv) {
+  const char *rowsPath = nullptr;
+  const char *csvPath = nullptr;
+  size_t syntheticRows = 60000;
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "--input") == 0 && arg + 1 < argc) {
+      rowsPath = argv[++arg];
+    } else if (strcmp(argv[arg], "--csv") == 0 && arg + 1 < argc) {
+      csvPath = argv[++arg];
+    } else if (strcmp(argv[arg], "--rows") == 0 && arg + 1 < argc) {
+      syntheticRows = strtoul(argv[++arg], nullptr, 10);
+    } else {
+      fprintf(stderr, "usage: %s [--input rows.bin | --csv session.csv] [--rows N]\n", argv[0]);
+      return 2;
+    }
+  }
+  Session session;
+  if (rowsPath != nullptr ? !loadRows(rowsPath, session) : csvPath != nullptr ? !loadCsv(csvPath, session) : false) {
+    fprintf(stderr, "cannot read %s\n", rowsPath != nullptr ? rowsPath : csvPath);
+    return 1;
+  }
+  if (rowsPath == nullptr && csvPath == nullptr) {
+    synthetic(syntheticRows, session);
+  }
+  if (session.rows() < 2) {
+    fprintf(stderr, "no session to encode\n");
+    return 1;
+  }
+
+  // what the same rows cost today: trainPrintFunc's CSV line and a bleFrame.h frame at BLE_FRAME_MTU
+  double csvBytes = 0;
+  for (size_t index = 0; index < session.rows(); index++) {
+    const uint8_t *row = session.row(index);
+    char line[48];
+    csvBytes += snprintf(line, sizeof(line), "%d,%d,%d,%d,%d,%d,%d,%d,%d", row[4], row[3], row[2], row[1], row[0],
+                         row[6], row[7], row[8], row[5]) + 2;
+  }
+  csvBytes /= session.rows();
+  size_t frameRows = (BLE_FRAME_MTU - BLE_ATT_HEADER_BYTES - BLE_FRAME_HEADER_BYTES) / BLE_FRAME_SAMPLE_BYTES;
+  double frameBytes = (double)(BLE_FRAME_HEADER_BYTES + frameRows * BLE_FRAME_SAMPLE_BYTES) / frameRows;
+  printf("%lu rows; per row: %.1f bytes as CSV over serial, %.2f in a bleFrame.h frame, %d raw\n",
+         (unsigned long)session.rows(), csvBytes, frameBytes, kChannels);
+
+  struct Setting {
+    const char *name;
+    size_t limit;
+    size_t rowsPerBlock;
+  } settings[] = {
+    {"mtu 247, 500ms flush", BLE_FRAME_MTU - BLE_ATT_HEADER_BYTES, (size_t)FUSION_RATE * BLE_FRAME_FLUSH_MS / 1000},
+    {"mtu 247", BLE_FRAME_MTU - BLE_ATT_HEADER_BYTES, GLOVE_CODEC_BLOCK_ROWS},
+    {"mtu 185", 185 - BLE_ATT_HEADER_BYTES, GLOVE_CODEC_BLOCK_ROWS},
+    {"mtu 517", 517 - BLE_ATT_HEADER_BYTES, GLOVE_CODEC_BLOCK_ROWS},
+  };
+  bool ok = true;
+  printf("%-22s %8s %10s %8s %8s %10s %10s\n", "setting", "blocks", "bytes/row", "vs_frame", "vs_csv", "enc_ns/row",
+         "dec_ns/row");
+  for (const Setting &setting : settings) {
+    Encoded encoded = encode(session, setting.limit, setting.rowsPerBlock);
+    size_t skippedRows, droppedBlocks;
+    bool exact = decodeAll(session, encoded, 0, &skippedRows, &droppedBlocks) && skippedRows == 0;
+    bool resyncs = decodeAll(session, encoded, 7, &skippedRows, &droppedBlocks);
+    ok = ok && exact && resyncs;
+
+    double encodeNanos = nanosPerRow(session.rows(), [&]() {
+      encode(session, setting.limit, setting.rowsPerBlock);
+    });
+    double decodeNanos = nanosPerRow(session.rows(), [&]() {
+      size_t skipped, dropped;
+      decodeAll(session, encoded, 0, &skipped, &dropped);
+    });
+    double bytesPerRow = (double)encoded.bytes.size() / session.rows();
+    printf("%-22s %8lu %10.2f %7.2fx %7.2fx %10.1f %10.1f%s\n", setting.name,
+           (unsigned long)encoded.firstRows.size(), bytesPerRow, frameBytes / bytesPerRow, csvBytes / bytesPerRow,
+           encodeNanos, decodeNanos, exact ? (resyncs ? "" : "  NO RESYNC") : "  MISMATCH");
+  }
+  printf("worst case, %d rows of noise: %.2f us to push and finish a %lu byte block\n", GLOVE_CODEC_BLOCK_ROWS,
+         worstBlockMicros(), (unsigned long)Encoder::kMaxBytes);
+  printf("%s\n", ok ? "every block decoded exactly, losses resynced at the next keyframe" : "codec check FAILED");
+  return ok ? 0 : 1;
+}
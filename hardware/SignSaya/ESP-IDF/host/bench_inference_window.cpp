@@ -0,0 +1,94 @@
+// Bytes moved and time per sample of the old shifting inference array
+// against InferenceWindow. Run: ./bench_inference_window [samples]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "config.h"
+#include "types.h"
+#include "inferenceWindow.h"
+
+static Inference_t makeSample(uint32_t n) {
+  Inference_t entry;
+  entry.pinky = n;
+  entry.ring = n + 1;
+  entry.middle = n + 2;
+  entry.index = n + 3;
+  entry.thumb = n + 4;
+  entry.w = (n + 5) | 1;
+  entry.x = (n + 6) | 1;
+  entry.y = (n + 7) | 1;
+  entry.z = (n + 8) | 1;
+  return entry;
+}
+
+// Same work the parser did before the ring buffer: shift everything left
+// and rewrite the whole flattened array on every sample.
+static uint64_t shiftInsert(Inference_t *inferenceArray, uint8_t *finalInferenceArray, const Inference_t &entry) {
+  for (uint16_t arrayIndex = 0; arrayIndex < INFERENCE_LENGTH - 1; arrayIndex++) {
+    inferenceArray[arrayIndex] = inferenceArray[arrayIndex + 1];
+    uint8_t *row = &finalInferenceArray[arrayIndex * INFERENCE_FEATURES];
+    row[0] = inferenceArray[arrayIndex].thumb;
+    row[1] = inferenceArray[arrayIndex].index;
+    row[2] = inferenceArray[arrayIndex].middle;
+    row[3] = inferenceArray[arrayIndex].ring;
+    row[4] = inferenceArray[arrayIndex].pinky;
+    row[5] = inferenceArray[arrayIndex].x;
+    row[6] = inferenceArray[arrayIndex].y;
+    row[7] = inferenceArray[arrayIndex].z;
+    row[8] = inferenceArray[arrayIndex].w;
+  }
+  inferenceArray[INFERENCE_LENGTH - 1] = entry;
+  uint8_t *row = &finalInferenceArray[(INFERENCE_LENGTH - 1) * INFERENCE_FEATURES];
+  row[0] = entry.thumb;
+  row[1] = entry.index;
+  row[2] = entry.middle;
+  row[3] = entry.ring;
+  row[4] = entry.pinky;
+  row[5] = entry.x;
+  row[6] = entry.y;
+  row[7] = entry.z;
+  row[8] = entry.w;
+  // every Inference_t copied (read + write) and every output byte written
+  return 2ULL * INFERENCE_LENGTH * sizeof(Inference_t) + INFERENCE_LENGTH * INFERENCE_FEATURES;
+}
+
+int main(int argc, char **argv) {
+  uint32_t samples = argc > 1 ? strtoul(argv[1], nullptr, 10) : 20000;
+
+  std::vector<Inference_t> inferenceArray(INFERENCE_LENGTH);
+  std::vector<uint8_t> shiftOutput(INFERENCE_LENGTH * INFERENCE_FEATURES);
+  std::vector<uint8_t> ringOutput(INFERENCE_LENGTH * INFERENCE_FEATURES);
+  InferenceWindow *window = new InferenceWindow();
+
+  uint64_t shiftBytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < samples; n++) {
+    shiftBytes += shiftInsert(inferenceArray.data(), shiftOutput.data(), makeSample(n));
+  }
+  double shiftNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  uint64_t ringBytes = 0;
+  start = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < samples; n++) {
+    window->push(makeSample(n));
+    ringBytes += INFERENCE_FEATURES;
+    if (window->pending() >= INFERENCE_WINDOW) {
+      window->linearize(ringOutput.data());
+      ringBytes += 2ULL * INFERENCE_LENGTH * INFERENCE_FEATURES;
+    }
+  }
+  double ringNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  // Both paths must hand the interpreter the same window
+  window->linearize(ringOutput.data());
+  bool match = shiftOutput == ringOutput;
+
+  printf("samples: %u, window: %d x %d, trigger every %d samples\n", samples, INFERENCE_LENGTH, INFERENCE_FEATURES, INFERENCE_WINDOW);
+  printf("%-12s %14s %12s\n", "method", "bytes/sample", "ns/sample");
+  printf("%-12s %14.1f %12.1f\n", "shift", (double)shiftBytes / samples, shiftNs / samples);
+  printf("%-12s %14.1f %12.1f\n", "ring", (double)ringBytes / samples, ringNs / samples);
+  printf("windows match: %s\n", match ? "yes" : "NO");
+  delete window;
+  return match ? 0 : 1;
+}
@@ -0,0 +1,252 @@
+// Runs the signsaya model end to end on the host with the same op set as
+// AiModel::begin and reports invoke latency percentiles, the arena high-water
+// mark and throughput. Windows slide by INFERENCE_WINDOW rows like on the
+// glove, over a recording of raw rows (INFERENCE_FEATURES bytes each, the
+// order the parser linearizes) or a synthetic random walk when none is given.
+// --fast-arena splits the arena like USE_SRAM_ARENA does on the glove, with
+// activations up to the given size in the fast part too. --streaming and
+// --compiled also run StreamingModel and CompiledModel on every window and
+// count the windows where they disagree with the interpreter.
+// Run: ./bench_model [--invokes N] [--input rows.bin] [--streaming] [--compiled]
+//                    [--csv] [--fast-arena [--fast-activations BYTES]]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "arenaPlan.h"
+#include "compiledModel.h"
+#include "config.h"
+#include "activeModel.h"
+#include "modelOps.h"
+#include "opProfiler.h"
+#include "streamingModel.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+static const size_t kRowBytes = INFERENCE_FEATURES;
+static const size_t kWindowBytes = INFERENCE_LENGTH * INFERENCE_FEATURES;
+
+alignas(16) static uint8_t tensorArena[ARENA_PLAN_ARENA_SIZE];
+alignas(16) static uint8_t fastTensorArena[ARENA_PLAN_SRAM_BYTES];
+static StreamingModel streamingModel;
+
+// Slow drift with some noise, keeps the quantized values moving like a glove would
+static std::vector<uint8_t> syntheticRows(size_t rows) {
+  std::vector<uint8_t> data(rows * kRowBytes);
+  int32_t level[INFERENCE_FEATURES];
+  for (size_t feature = 0; feature < kRowBytes; feature++) {
+    level[feature] = 128;
+  }
+  srand(1);
+  for (size_t row = 0; row < rows; row++) {
+    for (size_t feature = 0; feature < kRowBytes; feature++) {
+      level[feature] = std::min(255, std::max(0, level[feature] + rand() % 5 - 2));
+      data[row * kRowBytes + feature] = (uint8_t)level[feature];
+    }
+  }
+  return data;
+}
+
+static bool loadRows(const char *path, std::vector<uint8_t> &data) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  uint8_t chunk[4096];
+  size_t length;
+  while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    data.insert(data.end(), chunk, chunk + length);
+  }
+  fclose(file);
+  data.resize(data.size() - data.size() % kRowBytes);
+  return data.size() >= kWindowBytes;
+}
+
+static uint8_t topClass(const uint8_t *scores, int count) {
+  return (uint8_t)(std::max_element(scores, scores + count) - scores);
+}
+
+static double percentile(const std::vector<double> &sorted, double percent) {
+  size_t index = (size_t)(percent / 100.0 * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+int main(int argc, char **argv) {
+  uint32_t invokes = 50;
+  const char *inputPath = nullptr;
+  bool streaming = false;
+  bool compiled = false;
+  bool csv = false;
+  bool fastArena = false;
+  size_t fastActivationBytes = 0;
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "--invokes") == 0 && arg + 1 < argc) {
+      invokes = (uint32_t)strtoul(argv[++arg], nullptr, 10);
+    } else if (strcmp(argv[arg], "--input") == 0 && arg + 1 < argc) {
+      inputPath = argv[++arg];
+    } else if (strcmp(argv[arg], "--streaming") == 0) {
+      streaming = true;
+    } else if (strcmp(argv[arg], "--compiled") == 0) {
+      compiled = true;
+    } else if (strcmp(argv[arg], "--csv") == 0) {
+      csv = true;
+    } else if (strcmp(argv[arg], "--fast-arena") == 0) {
+      fastArena = true;
+    } else if (strcmp(argv[arg], "--fast-activations") == 0 && arg + 1 < argc) {
+      fastActivationBytes = strtoul(argv[++arg], nullptr, 0);
+    } else {
+      fprintf(stderr, "usage: %s [--invokes N] [--input rows.bin] [--streaming] [--compiled] [--csv]"
+                      " [--fast-arena [--fast-activations BYTES]]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (invokes == 0) {
+    invokes = 1;
+  }
+
+  std::vector<uint8_t> rows;
+  if (inputPath != nullptr) {
+    if (!loadRows(inputPath, rows)) {
+      fprintf(stderr, "%s: needs at least %d rows of %d bytes\n", inputPath, INFERENCE_LENGTH, INFERENCE_FEATURES);
+      return 1;
+    }
+  } else {
+    rows = syntheticRows(INFERENCE_LENGTH + (size_t)INFERENCE_WINDOW * invokes);
+  }
+  size_t totalRows = rows.size() / kRowBytes;
+
+  const tflite::Model *model = tflite::GetModel(ACTIVE_MODEL);
+  if (model->version() != TFLITE_SCHEMA_VERSION) {
+    fprintf(stderr, "schema version %lu, expected %d\n", (unsigned long)model->version(), TFLITE_SCHEMA_VERSION);
+    return 1;
+  }
+  static ModelOpResolver resolver;
+  if (registerModelOps(resolver) != kTfLiteOk) {
+    fprintf(stderr, "registering ops failed\n");
+    return 1;
+  }
+  static OpProfiler opProfiler;
+  tflite::MicroAllocator *allocator;
+  if (fastArena) {
+    tflite::ArenaPlacementPolicy placement;
+    placement.scratch = tflite::ArenaTier::kFast;
+    placement.activations = fastActivationBytes > 0 ? tflite::ArenaTier::kFast : tflite::ArenaTier::kMain;
+    placement.activation_fast_max_bytes = fastActivationBytes;
+    allocator = tflite::MicroAllocator::Create(tensorArena, ARENA_PLAN_ARENA_SIZE, fastTensorArena,
+                                               ARENA_PLAN_SRAM_BYTES, placement);
+  } else {
+    allocator = tflite::MicroAllocator::Create(tensorArena, ARENA_PLAN_ARENA_SIZE);
+  }
+  static tflite::MicroInterpreter interpreter(model, resolver, allocator, nullptr, &opProfiler);
+  if (interpreter.AllocateTensors() != kTfLiteOk) {
+    fprintf(stderr, "AllocateTensors() failed with a %d byte arena\n", ARENA_PLAN_ARENA_SIZE);
+    return 1;
+  }
+  TfLiteTensor *input = interpreter.input(0);
+  TfLiteTensor *output = interpreter.output(0);
+  if (input->bytes != kWindowBytes) {
+    fprintf(stderr, "input tensor is %lu bytes, config.h says %lu\n", (unsigned long)input->bytes, (unsigned long)kWindowBytes);
+    return 1;
+  }
+  if (streaming) {
+    if (!streamingModel.begin(tflite::GetModel(signsaya_model))) {
+      fprintf(stderr, "streaming model does not match this graph\n");
+      return 1;
+    }
+    streamingModel.setProfiler(&opProfiler);
+  }
+  if (compiled && sizeof(ACTIVE_MODEL) != CompiledModel::kSourceBytes) {
+    fprintf(stderr, "compiledModel.h is stale, rerun host/compile_model\n");
+    return 1;
+  }
+
+  std::vector<double> invokeMicros;
+  std::vector<double> streamingMicros;
+  std::vector<double> compiledMicros;
+  uint32_t disagreements = 0;
+  uint32_t compiledDisagreements = 0;
+  size_t start = 0;
+  size_t newRows = INFERENCE_LENGTH;
+  auto benchStart = std::chrono::steady_clock::now();
+  for (uint32_t run = 0; run < invokes; run++) {
+    const uint8_t *window = &rows[start * kRowBytes];
+    memcpy(input->data.uint8, window, kWindowBytes);
+
+    auto before = std::chrono::steady_clock::now();
+    if (interpreter.Invoke() != kTfLiteOk) {
+      fprintf(stderr, "Invoke() failed on window %lu\n", (unsigned long)run);
+      return 1;
+    }
+    auto after = std::chrono::steady_clock::now();
+    invokeMicros.push_back(std::chrono::duration<double, std::micro>(after - before).count());
+
+    if (streaming) {
+      before = std::chrono::steady_clock::now();
+      const uint8_t *scores = streamingModel.update(window, newRows);
+      after = std::chrono::steady_clock::now();
+      streamingMicros.push_back(std::chrono::duration<double, std::micro>(after - before).count());
+      if (memcmp(scores, output->data.uint8, StreamingModel::kClasses) != 0) {
+        disagreements++;
+      }
+    }
+
+    if (compiled) {
+      before = std::chrono::steady_clock::now();
+      const uint8_t *scores = CompiledModel::invoke(window, &opProfiler);
+      after = std::chrono::steady_clock::now();
+      compiledMicros.push_back(std::chrono::duration<double, std::micro>(after - before).count());
+      if (memcmp(scores, output->data.uint8, CompiledModel::kOutputBytes) != 0) {
+        compiledDisagreements++;
+      }
+    }
+
+    // next window, wrapping to the start of a recording that runs out
+    newRows = INFERENCE_WINDOW;
+    start += INFERENCE_WINDOW;
+    if (start + INFERENCE_LENGTH > totalRows) {
+      start = 0;
+      newRows = INFERENCE_LENGTH;
+    }
+  }
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - benchStart).count();
+
+  std::sort(invokeMicros.begin(), invokeMicros.end());
+  printf("windows: %lu of %d rows, stride %d, %s\n", (unsigned long)invokes, INFERENCE_LENGTH, INFERENCE_WINDOW,
+         inputPath != nullptr ? inputPath : "synthetic");
+  if (fastArena) {
+    printf("arena: %lu bytes used, %lu of them in the %d byte fast arena\n",
+           (unsigned long)interpreter.arena_used_bytes(), (unsigned long)allocator->fast_used_bytes(),
+           ARENA_PLAN_SRAM_BYTES);
+  } else {
+    printf("arena: %lu of %d bytes used\n", (unsigned long)interpreter.arena_used_bytes(), ARENA_PLAN_ARENA_SIZE);
+  }
+  printf("invoke_us: p50 %.0f p90 %.0f p99 %.0f max %.0f\n", percentile(invokeMicros, 50),
+         percentile(invokeMicros, 90), percentile(invokeMicros, 99), invokeMicros.back());
+  if (streaming) {
+    std::sort(streamingMicros.begin(), streamingMicros.end());
+    printf("streaming_us: p50 %.0f p90 %.0f p99 %.0f max %.0f\n", percentile(streamingMicros, 50),
+           percentile(streamingMicros, 90), percentile(streamingMicros, 99), streamingMicros.back());
+    printf("streaming disagreements: %lu\n", (unsigned long)disagreements);
+  }
+  if (compiled) {
+    std::sort(compiledMicros.begin(), compiledMicros.end());
+    printf("compiled_us: p50 %.0f p90 %.0f p99 %.0f max %.0f\n", percentile(compiledMicros, 50),
+           percentile(compiledMicros, 90), percentile(compiledMicros, 99), compiledMicros.back());
+    printf("compiled disagreements: %lu\n", (unsigned long)compiledDisagreements);
+  }
+  printf("throughput: %.1f inferences/s, %.0f rows/s\n", invokes / elapsed, invokes * (double)INFERENCE_WINDOW / elapsed);
+  printf("last result: class %u\n", topClass(output->data.uint8, output->bytes));
+
+  if (csv) {
+    char row[128];
+    printf("%s\n", OpProfiler::csvHeader());
+    for (uint8_t index = 0; index < opProfiler.size(); index++) {
+      opProfiler.formatCsvRow(index, row, sizeof(row));
+      printf("%s\n", row);
+    }
+  }
+  return disagreements == 0 && compiledDisagreements == 0 ? 0 : 1;
+}
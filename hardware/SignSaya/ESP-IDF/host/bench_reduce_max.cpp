@@ -0,0 +1,119 @@
+// Checks the contiguous-axis int8 ReduceMax in kernels/esp_nn/reduce.cc
+// against reference_ops::ReduceGeneric byte for byte and times both. The
+// first case is the model's max over time of the conv output. Exits 1 on
+// any mismatch. Run: ./bench_reduce_max [repeats]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "tensorflow/lite/kernels/internal/reference/reduce.h"
+#include "tensorflow/lite/micro/kernels/reduce.h"
+
+struct ReduceCase {
+  const char *name;
+  std::vector<int> dims;
+  std::vector<int> axis;
+  size_t misalign;  // bytes the input is shifted off 16 byte alignment
+};
+
+static int8_t maxReducer(const int8_t current, const int8_t in) {
+  return in > current ? in : current;
+}
+
+// Output dims with keep_dims false and the [outer, reduced, inner] view,
+// valid because every case reduces one contiguous run of axes
+static void describe(const ReduceCase &test, std::vector<int> &outputDims, int &outer, int &reduced, int &inner) {
+  std::vector<bool> reducedDim(test.dims.size(), false);
+  for (int axis : test.axis) {
+    reducedDim[axis < 0 ? axis + test.dims.size() : axis] = true;
+  }
+  outer = reduced = inner = 1;
+  bool seen = false;
+  for (size_t dim = 0; dim < test.dims.size(); dim++) {
+    if (reducedDim[dim]) {
+      reduced *= test.dims[dim];
+      seen = true;
+    } else {
+      outputDims.push_back(test.dims[dim]);
+      (seen ? inner : outer) *= test.dims[dim];
+    }
+  }
+  if (outputDims.empty()) {
+    outputDims.push_back(1);
+  }
+}
+
+template <typename Function>
+static double microsPerCall(uint32_t repeats, Function function) {
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t repeat = 0; repeat < repeats; repeat++) {
+    function();
+  }
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+int main(int argc, char **argv) {
+  uint32_t repeats = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 200;
+  if (repeats == 0) {
+    repeats = 1;
+  }
+  const ReduceCase cases[] = {
+    {"model conv output", {1, 7440, 32}, {1}, 0},
+    {"negative axis", {1, 7440, 32}, {-2}, 0},
+    {"unaligned input", {1, 7440, 32}, {1}, 1},
+    {"odd channel count", {4, 100, 17}, {1}, 0},
+    {"last axis", {2, 3, 500}, {2}, 0},
+    {"last axis, short", {1000, 9}, {1}, 0},
+    {"two axes", {3, 5, 7, 11}, {1, 2}, 0},
+    {"every axis", {64}, {0}, 0},
+  };
+
+  srand(1);
+  int failures = 0;
+  printf("%-20s %-16s %10s %10s %8s\n", "case", "shape", "ref_us", "fast_us", "speedup");
+  for (const ReduceCase &test : cases) {
+    std::vector<int> outputDims;
+    int outer, reduced, inner;
+    describe(test, outputDims, outer, reduced, inner);
+    size_t elements = (size_t)outer * reduced * inner;
+
+    std::vector<int8_t> storage(elements + 32);
+    int8_t *input = (int8_t *)(((uintptr_t)storage.data() + 15) / 16 * 16) + test.misalign;
+    for (size_t index = 0; index < elements; index++) {
+      input[index] = (int8_t)(rand() % 256 - 128);
+    }
+    std::vector<int8_t> expected((size_t)outer * inner);
+    std::vector<int8_t> actual((size_t)outer * inner, 0x55);
+    std::vector<int> tempIndex(test.dims.size());
+    std::vector<int> resolvedAxis(test.axis.size());
+
+    auto reference = [&]() {
+      tflite::reference_ops::ReduceGeneric<int8_t>(
+          input, test.dims.data(), test.dims.size(), expected.data(), outputDims.data(), outputDims.size(),
+          test.axis.data(), test.axis.size(), false, tempIndex.data(), resolvedAxis.data(),
+          std::numeric_limits<int8_t>::lowest(), maxReducer);
+    };
+    auto fast = [&]() {
+      tflite::ReduceMaxContiguousInt8(input, outer, reduced, inner, actual.data());
+    };
+    reference();
+    fast();
+    bool match = memcmp(expected.data(), actual.data(), expected.size()) == 0;
+    failures += match ? 0 : 1;
+
+    double referenceMicros = microsPerCall(repeats, reference);
+    double fastMicros = microsPerCall(repeats, fast);
+    char shape[32];
+    int length = 0;
+    for (size_t dim = 0; dim < test.dims.size(); dim++) {
+      length += snprintf(shape + length, sizeof(shape) - length, dim == 0 ? "%d" : "x%d", test.dims[dim]);
+    }
+    printf("%-20s %-16s %10.1f %10.1f %7.1fx%s\n", test.name, shape, referenceMicros, fastMicros,
+           referenceMicros / fastMicros, match ? "" : "  MISMATCH");
+  }
+  printf("%d of %d cases bit exact\n", (int)(sizeof(cases) / sizeof(cases[0])) - failures,
+         (int)(sizeof(cases) / sizeof(cases[0])));
+  return failures == 0 ? 0 : 1;
+}
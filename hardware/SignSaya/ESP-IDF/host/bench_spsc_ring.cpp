@@ -0,0 +1,275 @@
+// Stress test and throughput of the spscRing.h ring on two threads, against
+// a ring of the same size behind a mutex, which is what an xQueueSend or
+// xQueueReceive with no wait amounts to. The stress runs push and pop handData_t
+// samples in random batch sizes, single items in between, and check every
+// sample arrives once and in order; the lossy run never retries a full ring
+// and checks the overflow count makes up the difference. Exits 1 on any
+// mismatch. Timings are per sample on two threads and, for the bare cost of
+// the link, pushed and popped on one.
+// Run: ./bench_spsc_ring [items]
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include "types.h"
+#include "spscRing.h"
+
+// The locked baseline, same interface as SpscRing
+template <typename T, uint32_t Capacity>
+class MutexRing {
+private:
+  std::mutex lock;
+  uint32_t head = 0;
+  uint32_t tail = 0;
+  uint32_t overflows = 0;
+  T slots[Capacity];
+
+public:
+  bool push(const T &item) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (head - tail == Capacity) {
+      overflows++;
+      return false;
+    }
+    slots[head++ % Capacity] = item;
+    return true;
+  }
+
+  uint32_t push(const T *items, uint32_t count) {
+    uint32_t accepted = 0;
+    while (accepted < count && push(items[accepted])) {
+      accepted++;
+    }
+    return accepted;
+  }
+
+  bool pop(T &item) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (head == tail) {
+      return false;
+    }
+    item = slots[tail++ % Capacity];
+    return true;
+  }
+
+  uint32_t pop(T *items, uint32_t count) {
+    uint32_t taken = 0;
+    while (taken < count && pop(items[taken])) {
+      taken++;
+    }
+    return taken;
+  }
+};
+
+static handData_t sample(uint32_t sequence) {
+  handData_t data;
+  data.pinky = (uint8_t)sequence;
+  data.ring = (uint8_t)(sequence >> 8);
+  data.middle = (uint8_t)(sequence >> 16);
+  data.index = (uint8_t)(sequence >> 24);
+  data.thumb = (uint8_t)(sequence * 31);
+  data.timestamp = sequence;
+  return data;
+}
+
+static bool isSample(const handData_t &data, uint32_t sequence) {
+  handData_t expected = sample(sequence);
+  return data.timestamp == sequence && data.pinky == expected.pinky && data.ring == expected.ring
+      && data.middle == expected.middle && data.index == expected.index && data.thumb == expected.thumb;
+}
+
+// xorshift, one per thread
+static uint32_t nextRandom(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static const uint32_t kMaxBatch = 24;
+
+// Every sample once and in order with the producer retrying what did not fit,
+// or when lossy, in order with the refused samples missing
+template <typename Ring>
+static bool stress(Ring &ring, uint32_t items, bool lossy, uint32_t *overflowed) {
+  bool ok = true;
+  uint32_t refused = 0;
+  std::atomic<bool> finished{ false };
+  std::thread producer([&]() {
+    uint32_t random = 0x9e3779b9;
+    handData_t batch[kMaxBatch];
+    uint32_t sequence = 0;
+    while (sequence < items) {
+      uint32_t count = nextRandom(random) % kMaxBatch + 1;
+      count = count > items - sequence ? items - sequence : count;
+      for (uint32_t index = 0; index < count; index++) {
+        batch[index] = sample(sequence + index);
+      }
+      uint32_t sent;
+      if (count == 1 || nextRandom(random) % 4 == 0) {
+        count = 1;
+        sent = ring.push(batch[0]) ? 1 : 0;
+      } else {
+        sent = ring.push(batch, count);
+      }
+      if (lossy) {
+        // what did not fit is gone, like a sensor sample the consumer was too late for
+        refused += count - sent;
+        sequence += count;
+      } else {
+        sequence += sent;
+      }
+      if (sent == 0) {
+        std::this_thread::yield();
+      }
+    }
+    finished.store(true);
+  });
+
+  uint32_t random = 0x85ebca6b;
+  handData_t batch[kMaxBatch];
+  uint32_t expected = 0;
+  uint32_t received = 0;
+  for (;;) {
+    // read first: once the producer is done, an empty pop means nothing is left
+    bool last = finished.load();
+    uint32_t count = nextRandom(random) % kMaxBatch + 1;
+    uint32_t taken = count == 1 ? (ring.pop(batch[0]) ? 1 : 0) : ring.pop(batch, count);
+    for (uint32_t index = 0; index < taken && ok; index++) {
+      uint32_t sequence = batch[index].timestamp;
+      if (lossy ? sequence < expected || !isSample(batch[index], sequence) : !isSample(batch[index], expected)) {
+        fprintf(stderr, "sample %u arrived, %u expected\n", sequence, expected);
+        ok = false;
+      }
+      expected = sequence + 1;
+      received++;
+    }
+    if (!ok) {
+      break;
+    }
+    if (taken == 0) {
+      if (last) {
+        break;
+      }
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  *overflowed = refused;
+  if (ok && received + refused != items) {
+    fprintf(stderr, "%u received and %u refused of %u\n", received, refused, items);
+    ok = false;
+  }
+  return ok;
+}
+
+// Samples a second through the ring, both threads yielding only when they
+// cannot make progress
+template <typename Ring>
+static double throughput(Ring &ring, uint32_t items, uint32_t batchSize) {
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer([&]() {
+    handData_t batch[kMaxBatch];
+    uint32_t sequence = 0;
+    while (sequence < items) {
+      uint32_t count = batchSize < items - sequence ? batchSize : items - sequence;
+      for (uint32_t index = 0; index < count; index++) {
+        batch[index] = sample(sequence + index);
+      }
+      uint32_t sent = count == 1 ? (ring.push(batch[0]) ? 1 : 0) : ring.push(batch, count);
+      sequence += sent;
+      if (sent == 0) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  handData_t batch[kMaxBatch];
+  uint32_t received = 0;
+  uint32_t checksum = 0;
+  while (received < items) {
+    uint32_t taken = batchSize == 1 ? (ring.pop(batch[0]) ? 1 : 0) : ring.pop(batch, batchSize);
+    for (uint32_t index = 0; index < taken; index++) {
+      checksum += batch[index].timestamp;
+    }
+    received += taken;
+    if (taken == 0) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  // keeps the copies from being optimized out
+  if (checksum == 1) {
+    printf(" ");
+  }
+  return items / seconds;
+}
+
+// Push then pop on one thread, the cost of the link itself without any
+// scheduling, which is all a sample pays on the S3 when the other core keeps up
+template <typename Ring>
+static double uncontended(Ring &ring, uint32_t items, uint32_t batchSize) {
+  handData_t batch[kMaxBatch];
+  uint32_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t sequence = 0; sequence < items; sequence += batchSize) {
+    for (uint32_t index = 0; index < batchSize; index++) {
+      batch[index] = sample(sequence + index);
+    }
+    if (batchSize == 1) {
+      ring.push(batch[0]);
+      ring.pop(batch[0]);
+    } else {
+      ring.push(batch, batchSize);
+      ring.pop(batch, batchSize);
+    }
+    checksum += batch[0].timestamp;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (checksum == 1) {
+    printf(" ");
+  }
+  return items / seconds;
+}
+
+int main(int argc, char **argv) {
+  uint32_t items = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 1000000;
+  if (items == 0) {
+    items = 1;
+  }
+  bool ok = true;
+
+  // a 2 slot ring is full or empty nearly every call, 16 is what main.cpp uses
+  static SpscRing<handData_t, 2> tiny;
+  static SpscRing<handData_t, 16> small;
+  static SpscRing<handData_t, 16> lossyRing;
+  uint32_t overflowed;
+  bool tinyOk = stress(tiny, items, false, &overflowed);
+  bool smallOk = stress(small, items, false, &overflowed);
+  bool lossyOk = stress(lossyRing, items, true, &overflowed) && lossyRing.overflowed() == overflowed;
+  if (!lossyOk) {
+    fprintf(stderr, "ring counted %u overflows, the producer saw %u\n", lossyRing.overflowed(), overflowed);
+  }
+  printf("stress, %u samples: 2 slots %s, 16 slots %s, lossy 16 slots %s (%u refused)\n", items, tinyOk ? "ok" : "FAILED",
+         smallOk ? "ok" : "FAILED", lossyOk ? "ok" : "FAILED", overflowed);
+  ok = tinyOk && smallOk && lossyOk;
+
+  printf("%u hardware threads\n", std::thread::hardware_concurrency());
+  printf("%-8s %6s %16s %12s %16s %12s\n", "ring", "batch", "two_threads_ns", "speedup", "one_thread_ns", "speedup");
+  for (uint32_t batchSize : {1u, 8u}) {
+    static SpscRing<handData_t, 16> ring;
+    static MutexRing<handData_t, 16> locked;
+    double lockedRate = throughput(locked, items, batchSize);
+    double ringRate = throughput(ring, items, batchSize);
+    double lockedAlone = uncontended(locked, items, batchSize);
+    double ringAlone = uncontended(ring, items, batchSize);
+    printf("%-8s %6u %16.1f %12s %16.1f %12s\n", "mutex", batchSize, 1e9 / lockedRate, "", 1e9 / lockedAlone, "");
+    printf("%-8s %6u %16.1f %11.1fx %16.1f %11.1fx\n", "spsc", batchSize, 1e9 / ringRate, ringRate / lockedRate,
+           1e9 / ringAlone, ringAlone / lockedAlone);
+  }
+  printf("%s\n", ok ? "every sample delivered once and in order" : "ring check FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+// Round-trips a stream of fused rows through the bleFrame.h writer and
+// reference decoder at several ATT MTUs, dropping every Nth frame on the way
+// like a lossy link would. Every row of a delivered frame has to come back
+// with its timestamp, every dropped frame has to show up in the sequence
+// gaps, and no frame may exceed what the MTU allows. Also prints the radio
+// airtime per row against the legacy one finger plus one IMU notification.
+// Rows come from a recording (INFERENCE_FEATURES bytes each, Inference_t
+// order) or a synthetic random walk, stamped at FUSION_RATE with a long gap
+// now and then, starting just before micros() wraps. Exits 1 on any mismatch.
+// Run: ./ble_frame_check [--input rows.bin] [--rows N] [--drop N]
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "config.h"
+#include "bleFrame.h"
+
+static const size_t kRowBytes = INFERENCE_FEATURES;
+static const uint16_t kMtus[] = {23, 64, 185, BLE_FRAME_MTU, 517};
+static const uint16_t kFirstSequence = 65500;  // wraps within the run
+
+// LE 1M PHY with data length extension: each LL packet of up to 251 payload
+// bytes is preamble, access address, header and CRC (10 bytes) around the
+// payload at 8us a byte, then T_IFS, the central's empty packet and T_IFS.
+static double notificationMicros(size_t valueBytes) {
+  size_t l2cap = valueBytes + BLE_ATT_HEADER_BYTES + 4;
+  double micros = 0;
+  while (l2cap > 0) {
+    size_t payload = std::min<size_t>(l2cap, 251);
+    micros += (10 + payload) * 8 + 150 + 10 * 8 + 150;
+    l2cap -= payload;
+  }
+  return micros;
+}
+
+static bool loadRows(const char *path, std::vector<StreamSample_t> &samples) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  uint8_t row[kRowBytes];
+  while (fread(row, 1, kRowBytes, file) == kRowBytes) {
+    StreamSample_t sample;
+    memcpy(&sample.row, row, kRowBytes);
+    samples.push_back(sample);
+  }
+  fclose(file);
+  return true;
+}
+
+static void syntheticRows(size_t rows, std::vector<StreamSample_t> &samples) {
+  uint8_t level[kRowBytes];
+  memset(level, 128, sizeof(level));
+  srand(1);
+  for (size_t row = 0; row < rows; row++) {
+    for (size_t feature = 0; feature < kRowBytes; feature++) {
+      level[feature] = (uint8_t)std::min(255, std::max(0, level[feature] + rand() % 5 - 2));
+    }
+    StreamSample_t sample;
+    memcpy(&sample.row, level, kRowBytes);
+    samples.push_back(sample);
+  }
+}
+
+static void stamp(std::vector<StreamSample_t> &samples) {
+  uint32_t time = 0xffffffffu - 5000000u;
+  for (size_t index = 0; index < samples.size(); index++) {
+    samples[index].timestamp = time;
+    // a 200ms stall every 500 rows, more than a frame's 16 bit deltas cover
+    time += index % 500 == 499 ? 200000 : 1000000 / FUSION_RATE;
+  }
+}
+
+static bool sameSample(const StreamSample_t &a, const StreamSample_t &b) {
+  return a.timestamp == b.timestamp && memcmp(&a.row, &b.row, kRowBytes) == 0;
+}
+
+struct RunResult {
+  size_t frames = 0;
+  size_t dropped = 0;
+  size_t droppedRows = 0;
+  size_t delivered = 0;
+  size_t bytes = 0;
+  double airMicros = 0;
+  bool ok = true;
+};
+
+static RunResult roundTrip(const std::vector<StreamSample_t> &samples, uint16_t mtu, uint32_t dropEvery) {
+  RunResult result;
+  BleFrameWriter writer;
+  BleFrameReader reader;
+  writer.reset(kFirstSequence);
+  writer.setLimit(mtu - BLE_ATT_HEADER_BYTES);
+  StreamSample_t decoded[BLE_FRAME_MAX_SAMPLES];
+  size_t frameStart = 0;  // first row of the frame being filled
+  bool lastDropped = false;
+
+  auto send = [&](size_t frameEnd) {
+    bool drop = dropEvery > 0 && result.frames % dropEvery == dropEvery - 1;
+    lastDropped = drop;
+    result.frames++;
+    result.bytes += writer.size();
+    result.airMicros += notificationMicros(writer.size());
+    if (writer.size() > (size_t)(mtu - BLE_ATT_HEADER_BYTES)) {
+      fprintf(stderr, "mtu %u: frame of %lu bytes\n", mtu, (unsigned long)writer.size());
+      result.ok = false;
+    }
+    if (drop) {
+      result.dropped++;
+      result.droppedRows += frameEnd - frameStart;
+    } else {
+      int count = reader.decode(writer.data(), writer.size(), decoded, BLE_FRAME_MAX_SAMPLES);
+      if (count != (int)(frameEnd - frameStart)) {
+        fprintf(stderr, "mtu %u: frame %lu decoded %d rows, sent %lu\n", mtu, (unsigned long)result.frames, count,
+                (unsigned long)(frameEnd - frameStart));
+        result.ok = false;
+      } else {
+        for (int index = 0; index < count; index++) {
+          if (!sameSample(decoded[index], samples[frameStart + index])) {
+            fprintf(stderr, "mtu %u: row %lu differs after decoding\n", mtu, (unsigned long)(frameStart + index));
+            result.ok = false;
+            break;
+          }
+        }
+        result.delivered += count;
+      }
+    }
+    writer.clear();
+  };
+
+  // the same push, send, push again pattern as accelGyroSender
+  for (size_t index = 0; index < samples.size(); index++) {
+    if (!writer.push(samples[index].row, samples[index].timestamp)) {
+      send(index);
+      frameStart = index;
+      writer.push(samples[index].row, samples[index].timestamp);
+    }
+    if (writer.isFull()) {
+      send(index + 1);
+      frameStart = index + 1;
+    }
+  }
+  if (!writer.isEmpty()) {
+    send(samples.size());
+  }
+  // a dropped last frame leaves no later frame to reveal the gap
+  if (reader.lost() != result.dropped - (lastDropped ? 1 : 0)) {
+    fprintf(stderr, "mtu %u: decoder counted %lu lost frames, %lu were dropped\n", mtu, (unsigned long)reader.lost(),
+            (unsigned long)result.dropped);
+    result.ok = false;
+  }
+  if (result.delivered + result.droppedRows != samples.size()) {
+    fprintf(stderr, "mtu %u: %lu of %lu rows accounted for\n", mtu,
+            (unsigned long)(result.delivered + result.droppedRows), (unsigned long)samples.size());
+    result.ok = false;
+  }
+  return result;
+}
+
+// Truncated, padded and foreign frames are refused instead of misread
+static bool rejectsDamage(const std::vector<StreamSample_t> &samples) {
+  BleFrameWriter writer;
+  writer.setLimit(BLE_FRAME_MTU - BLE_ATT_HEADER_BYTES);
+  for (size_t index = 0; index < 4 && index < samples.size(); index++) {
+    writer.push(samples[index].row, samples[index].timestamp);
+  }
+  std::vector<uint8_t> frame(writer.data(), writer.data() + writer.size());
+  StreamSample_t decoded[BLE_FRAME_MAX_SAMPLES];
+  BleFrameReader reader;
+  std::vector<uint8_t> padded = frame;
+  padded.push_back(0);
+  std::vector<uint8_t> foreign = frame;
+  foreign[0] = BLE_FRAME_VERSION + 1;
+  return reader.decode(frame.data(), frame.size() - 1, decoded, BLE_FRAME_MAX_SAMPLES) < 0
+      && reader.decode(padded.data(), padded.size(), decoded, BLE_FRAME_MAX_SAMPLES) < 0
+      && reader.decode(foreign.data(), foreign.size(), decoded, BLE_FRAME_MAX_SAMPLES) < 0
+      && reader.decode(frame.data(), frame.size(), decoded, 1) < 0
+      && reader.decode(frame.data(), frame.size(), decoded, BLE_FRAME_MAX_SAMPLES) == 4;
+}
+
+int main(int argc, char **argv) {
+  const char *inputPath = nullptr;
+  size_t rows = 20000;
+  uint32_t dropEvery = 9;
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "--input") == 0 && arg + 1 < argc) {
+      inputPath = argv[++arg];
+    } else if (strcmp(argv[arg], "--rows") == 0 && arg + 1 < argc) {
+      rows = strtoul(argv[++arg], nullptr, 10);
+    } else if (strcmp(argv[arg], "--drop") == 0 && arg + 1 < argc) {
+      dropEvery = (uint32_t)strtoul(argv[++arg], nullptr, 10);
+    } else {
+      fprintf(stderr, "usage: %s [--input rows.bin] [--rows N] [--drop N]\n", argv[0]);
+      return 2;
+    }
+  }
+  std::vector<StreamSample_t> samples;
+  if (inputPath != nullptr) {
+    if (!loadRows(inputPath, samples)) {
+      fprintf(stderr, "cannot read %s\n", inputPath);
+      return 1;
+    }
+  } else {
+    syntheticRows(rows, samples);
+  }
+  if (samples.empty()) {
+    fprintf(stderr, "no rows to stream\n");
+    return 1;
+  }
+  stamp(samples);
+
+  bool ok = rejectsDamage(samples);
+  if (!ok) {
+    fprintf(stderr, "the decoder accepted a damaged frame\n");
+  }
+  // what fingerWrite and imuWrite cost for the same row
+  double legacyMicros = notificationMicros(5) + notificationMicros(4);
+  printf("%lu rows, 1 frame in %u dropped (0 none), legacy airtime %.0f us/row in 2 notifications\n",
+         (unsigned long)samples.size(), dropEvery, legacyMicros);
+  printf("%5s %12s %8s %10s %12s %12s %8s\n", "mtu", "rows/frame", "frames", "notify/s", "bytes/row", "air_us/row",
+         "vs_2x1");
+  for (uint16_t mtu : kMtus) {
+    RunResult result = roundTrip(samples, mtu, dropEvery);
+    ok = ok && result.ok;
+    double rowsPerFrame = (double)samples.size() / result.frames;
+    double airPerRow = result.airMicros / samples.size();
+    printf("%5u %12.1f %8lu %10.1f %12.2f %12.1f %7.1fx%s\n", mtu, rowsPerFrame, (unsigned long)result.frames,
+           FUSION_RATE / rowsPerFrame, (double)result.bytes / samples.size(), airPerRow, legacyMicros / airPerRow,
+           result.ok ? "" : "  FAILED");
+  }
+  printf("%s\n", ok ? "every delivered row decoded exactly, every dropped frame detected" : "round trip FAILED");
+  return ok ? 0 : 1;
+}
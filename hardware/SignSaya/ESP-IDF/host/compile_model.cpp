@@ -0,0 +1,404 @@
+// Compiles ACTIVE_MODEL into main/compiledModel.h: one straight-line kernel
+// call per op with the shapes as constants, the quantization parameters the
+// kernels' Prepare would compute already worked out, and the intermediate
+// tensors at fixed offsets of a static arena planned here. AiModel runs it
+// with USE_COMPILED_MODEL instead of an interpreter, bench_model --compiled
+// checks it against the interpreter. Rerun it whenever ACTIVE_MODEL changes.
+// Run: ./compile_model [--header path/to/compiledModel.h]
+//
+// Covers the ops of the fused graph (host/fuse_model): SIGNSAYA_CONV_MAX,
+// FullyConnected, Softmax and Quantize, all int8.
+#include <algorithm>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "activeModel.h"
+#include "modelHash.h"
+#include "fusedConvMax.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/reference/requantize.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+static const int kScaledDiffIntegerBits = 5;  // as in softmax_common.cc
+
+static const tflite::Model *model;
+static const tflite::SubGraph *graph;
+
+static const tflite::Tensor *tensorAt(int index) {
+  return graph->tensors()->Get(index);
+}
+
+static const void *bufferOf(const tflite::Tensor *tensor) {
+  const tflite::Buffer *buffer = model->buffers()->Get(tensor->buffer());
+  return buffer->data() != nullptr && buffer->data()->size() > 0 ? buffer->data()->data() : nullptr;
+}
+
+static float scaleOf(const tflite::Tensor *tensor, int index = 0) {
+  return tensor->quantization()->scale()->Get(index);
+}
+
+static int32_t zeroPointOf(const tflite::Tensor *tensor) {
+  return static_cast<int32_t>(tensor->quantization()->zero_point()->Get(0));
+}
+
+static int elementsOf(const tflite::Tensor *tensor) {
+  int elements = 1;
+  for (uint32_t dim = 0; dim < tensor->shape()->size(); dim++) {
+    elements *= tensor->shape()->Get(dim);
+  }
+  return elements;
+}
+
+static size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+static tflite::BuiltinOperator opCode(const tflite::Operator *op) {
+  const tflite::OperatorCode *code = model->operator_codes()->Get(op->opcode_index());
+  return std::max(static_cast<tflite::BuiltinOperator>(code->deprecated_builtin_code()), code->builtin_code());
+}
+
+static bool isFusedConvMax(const tflite::Operator *op) {
+  const tflite::OperatorCode *code = model->operator_codes()->Get(op->opcode_index());
+  return opCode(op) == tflite::BuiltinOperator_CUSTOM && code->custom_code() != nullptr
+         && strcmp(code->custom_code()->c_str(), FUSED_CONV_MAX_OP) == 0;
+}
+
+// Collects the generated declarations and statements
+struct Output {
+  std::string tables;
+  std::string body;
+
+  void add(std::string &target, const char *format, ...) __attribute__((format(printf, 3, 4))) {
+    char line[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    target += line;
+  }
+
+  template<typename T>
+  void table(const char *type, const std::string &name, const T *values, int count, int perLine) {
+    add(tables, "  static constexpr %s %s[%d] = {", type, name.c_str(), count);
+    for (int index = 0; index < count; index++) {
+      add(tables, "%s%s%ld", index > 0 ? "," : "", index % perLine == 0 ? "\n    " : " ", (long)values[index]);
+    }
+    add(tables, "\n  };\n");
+  }
+};
+
+// Where the generated invoke() finds a tensor's data
+static std::vector<int> tensorOffsets;
+
+static std::string tensorData(int tensor, const char *type) {
+  if (tensor == graph->inputs()->Get(0)) {
+    return "input";
+  }
+  char expression[96];
+  snprintf(expression, sizeof(expression), "reinterpret_cast<%s *>(&arena[%d])", type, tensorOffsets[tensor]);
+  return expression;
+}
+
+static std::string shapeTable(Output &out, const std::string &name, const tflite::Tensor *tensor) {
+  std::vector<int32_t> dims(tensor->shape()->begin(), tensor->shape()->end());
+  out.table("int32_t", name, dims.data(), dims.size(), 8);
+  return "tflite::RuntimeShape(" + std::to_string(dims.size()) + ", " + name + ")";
+}
+
+// Intermediate tensors at the offsets the greedy planner picks for their
+// lifetimes, the graph input stays with the caller
+static int planArena() {
+  int opCount = graph->operators()->size();
+  tensorOffsets.assign(graph->tensors()->size(), -1);
+  static unsigned char plannerScratch[8192];
+  tflite::GreedyMemoryPlanner planner;
+  planner.Init(plannerScratch, sizeof(plannerScratch));
+  std::vector<int> planned;
+  for (uint32_t index = 0; index < graph->tensors()->size(); index++) {
+    if (bufferOf(tensorAt(index)) != nullptr || (int)index == graph->inputs()->Get(0)) {
+      continue;
+    }
+    int firstOp = -1;
+    int lastOp = -1;
+    for (int opIndex = 0; opIndex < opCount; opIndex++) {
+      const tflite::Operator *op = graph->operators()->Get(opIndex);
+      for (int32_t output : *op->outputs()) {
+        if (output == (int)index && firstOp < 0) firstOp = opIndex;
+      }
+      for (int32_t input : *op->inputs()) {
+        if (input == (int)index) lastOp = std::max(lastOp, opIndex);
+      }
+    }
+    for (int32_t output : *graph->outputs()) {
+      if (output == (int)index) lastOp = opCount - 1;
+    }
+    if (firstOp < 0 || lastOp < firstOp) {
+      continue;
+    }
+    planner.AddBuffer(alignUp(elementsOf(tensorAt(index)), tflite::MicroArenaBufferAlignment()), firstOp, lastOp);
+    planned.push_back(index);
+  }
+  for (size_t buffer = 0; buffer < planned.size(); buffer++) {
+    planner.GetOffsetForBuffer(buffer, &tensorOffsets[planned[buffer]]);
+  }
+  return alignUp(planner.GetMaximumMemorySize(), tflite::MicroArenaBufferAlignment());
+}
+
+static bool compileConvMax(Output &out, int opIndex, const tflite::Operator *op) {
+  const tflite::Tensor *input = tensorAt(op->inputs()->Get(0));
+  const tflite::Tensor *filter = tensorAt(op->inputs()->Get(1));
+  const tflite::Tensor *bias = tensorAt(op->inputs()->Get(2));
+  const tflite::Tensor *output = tensorAt(op->outputs()->Get(0));
+  if (op->custom_options() == nullptr || op->custom_options()->size() != FUSED_CONV_MAX_OPTIONS_BYTES
+      || filter->shape()->size() != 4 || bufferOf(filter) == nullptr || bufferOf(bias) == nullptr) {
+    return false;
+  }
+  float convInputScale;
+  int32_t convInputZeroPoint;
+  memcpy(&convInputScale, op->custom_options()->data(), sizeof(float));
+  memcpy(&convInputZeroPoint, op->custom_options()->data() + sizeof(float), sizeof(int32_t));
+  int channels = filter->shape()->Get(0);
+  int kernelWidth = filter->shape()->Get(2);
+  int features = filter->shape()->Get(3);
+  int rows = input->shape()->Get(1);
+
+  // Same math as FusedConvMax::prepare
+  int32_t requantizeMultiplier;
+  int requantizeShift;
+  tflite::QuantizeMultiplier(static_cast<double>(scaleOf(input)) / static_cast<double>(convInputScale),
+                             &requantizeMultiplier, &requantizeShift);
+  uint8_t levels[256];
+  int8_t quantized[256];
+  for (int level = 0; level < 256; level++) {
+    levels[level] = static_cast<uint8_t>(level);
+  }
+  tflite::reference_ops::Requantize(levels, 256, requantizeMultiplier, requantizeShift, zeroPointOf(input),
+                                    convInputZeroPoint, quantized);
+  std::vector<int32_t> multipliers(channels);
+  std::vector<int32_t> shifts(channels);
+  for (int channel = 0; channel < channels; channel++) {
+    double effectiveScale = static_cast<double>(convInputScale) * static_cast<double>(scaleOf(filter, channel))
+                            / static_cast<double>(scaleOf(output));
+    int shift;
+    tflite::QuantizeMultiplier(effectiveScale, &multipliers[channel], &shift);
+    shifts[channel] = shift;
+  }
+
+  std::string prefix = "op" + std::to_string(opIndex);
+  out.table("int8_t", prefix + "Quantized", quantized, 256, 16);
+  out.table("int8_t", prefix + "Weights", static_cast<const int8_t *>(bufferOf(filter)), elementsOf(filter), 16);
+  out.table("int32_t", prefix + "Bias", static_cast<const int32_t *>(bufferOf(bias)), channels, 8);
+  out.table("int32_t", prefix + "Multipliers", multipliers.data(), channels, 8);
+  out.table("int32_t", prefix + "Shifts", shifts.data(), channels, 8);
+  out.add(out.body, "    {\n      tflite::ScopedMicroProfiler event(\"%s\", profiler);\n", FUSED_CONV_MAX_OP);
+  out.add(out.body, "      FusedConvMax::run(FusedConvMax::FixedDims<%d, %d, %d, %d>(), %sQuantized, %d, %s,\n",
+          rows, kernelWidth, features, channels, prefix.c_str(), -convInputZeroPoint,
+          tensorData(op->inputs()->Get(0), "const uint8_t").c_str());
+  out.add(out.body, "                        %sWeights, %sBias, %sMultipliers, %sShifts, %d,\n", prefix.c_str(),
+          prefix.c_str(), prefix.c_str(), prefix.c_str(), zeroPointOf(output));
+  out.add(out.body, "                        %s);\n    }\n", tensorData(op->outputs()->Get(0), "int8_t").c_str());
+  return true;
+}
+
+static bool compileFullyConnected(Output &out, int opIndex, const tflite::Operator *op) {
+  const tflite::Tensor *input = tensorAt(op->inputs()->Get(0));
+  const tflite::Tensor *filter = tensorAt(op->inputs()->Get(1));
+  const tflite::Tensor *output = tensorAt(op->outputs()->Get(0));
+  const tflite::FullyConnectedOptions *options = op->builtin_options_as_FullyConnectedOptions();
+  const tflite::Tensor *bias = op->inputs()->size() > 2 && op->inputs()->Get(2) >= 0 ? tensorAt(op->inputs()->Get(2)) : nullptr;
+  if (options == nullptr || options->fused_activation_function() != tflite::ActivationFunctionType_NONE
+      || filter->type() != tflite::TensorType_INT8 || bufferOf(filter) == nullptr) {
+    return false;
+  }
+  // Same math as GetQuantizedConvolutionMultipler
+  double scale = static_cast<double>(scaleOf(input) * scaleOf(filter)) / static_cast<double>(scaleOf(output));
+  int32_t multiplier;
+  int shift;
+  tflite::QuantizeMultiplier(scale, &multiplier, &shift);
+
+  std::string prefix = "op" + std::to_string(opIndex);
+  out.table("int8_t", prefix + "Weights", static_cast<const int8_t *>(bufferOf(filter)), elementsOf(filter), 16);
+  if (bias != nullptr) {
+    out.table("int32_t", prefix + "Bias", static_cast<const int32_t *>(bufferOf(bias)), elementsOf(bias), 8);
+  }
+  // the kernel flattens everything but the last output dimension into batches
+  int32_t inputDims[2] = { elementsOf(input) / filter->shape()->Get(1), filter->shape()->Get(1) };
+  out.table("int32_t", prefix + "InputDims", inputDims, 2, 8);
+  std::string filterShape = shapeTable(out, prefix + "FilterDims", filter);
+  std::string outputShape = shapeTable(out, prefix + "OutputDims", output);
+  out.add(out.body, "    {\n      tflite::ScopedMicroProfiler event(\"FULLY_CONNECTED\", profiler);\n");
+  out.add(out.body, "      tflite::FullyConnectedParams params = {};\n");
+  out.add(out.body, "      params.input_offset = %d;\n", -zeroPointOf(input));
+  out.add(out.body, "      params.weights_offset = %d;\n", -zeroPointOf(filter));
+  out.add(out.body, "      params.output_offset = %d;\n", zeroPointOf(output));
+  out.add(out.body, "      params.output_multiplier = %d;\n", multiplier);
+  out.add(out.body, "      params.output_shift = %d;\n", shift);
+  out.add(out.body, "      params.quantized_activation_min = -128;\n");
+  out.add(out.body, "      params.quantized_activation_max = 127;\n");
+  out.add(out.body, "      tflite::reference_integer_ops::FullyConnected(\n");
+  out.add(out.body, "        params, tflite::RuntimeShape(2, %sInputDims), %s,\n", prefix.c_str(),
+          tensorData(op->inputs()->Get(0), "const int8_t").c_str());
+  out.add(out.body, "        %s, %sWeights,\n", filterShape.c_str(), prefix.c_str());
+  if (bias != nullptr) {
+    out.add(out.body, "        tflite::RuntimeShape(1, &%sOutputDims[%d]), %sBias,\n", prefix.c_str(),
+            (int)output->shape()->size() - 1, prefix.c_str());
+  } else {
+    out.add(out.body, "        tflite::RuntimeShape(), nullptr,\n");
+  }
+  out.add(out.body, "        %s, %s);\n    }\n", outputShape.c_str(), tensorData(op->outputs()->Get(0), "int8_t").c_str());
+  return true;
+}
+
+static bool compileSoftmax(Output &out, int opIndex, const tflite::Operator *op) {
+  const tflite::Tensor *input = tensorAt(op->inputs()->Get(0));
+  const tflite::Tensor *output = tensorAt(op->outputs()->Get(0));
+  const tflite::SoftmaxOptions *options = op->builtin_options_as_SoftmaxOptions();
+  if (options == nullptr || output->type() != tflite::TensorType_INT8) {
+    return false;
+  }
+  // Same math as CalculateSoftmaxParams for int8
+  int32_t inputMultiplier;
+  int inputLeftShift;
+  tflite::PreprocessSoftmaxScaling(static_cast<double>(options->beta()), static_cast<double>(scaleOf(input)),
+                                   kScaledDiffIntegerBits, &inputMultiplier, &inputLeftShift);
+  int diffMin = -1.0 * tflite::CalculateInputRadius(kScaledDiffIntegerBits, inputLeftShift);
+
+  std::string prefix = "op" + std::to_string(opIndex);
+  std::string shape = shapeTable(out, prefix + "Dims", input);
+  out.add(out.body, "    {\n      tflite::ScopedMicroProfiler event(\"SOFTMAX\", profiler);\n");
+  out.add(out.body, "      tflite::SoftmaxParams params = {};\n");
+  out.add(out.body, "      params.input_multiplier = %d;\n", inputMultiplier);
+  out.add(out.body, "      params.input_left_shift = %d;\n", inputLeftShift);
+  out.add(out.body, "      params.diff_min = %d;\n", diffMin);
+  out.add(out.body, "      tflite::reference_ops::Softmax(params, %s, %s,\n", shape.c_str(),
+          tensorData(op->inputs()->Get(0), "const int8_t").c_str());
+  out.add(out.body, "                                     %s, %s);\n    }\n", shape.c_str(),
+          tensorData(op->outputs()->Get(0), "int8_t").c_str());
+  return true;
+}
+
+// int8 -> uint8 requantization as a table over the 256 input values
+static bool compileQuantize(Output &out, int opIndex, const tflite::Operator *op) {
+  const tflite::Tensor *input = tensorAt(op->inputs()->Get(0));
+  const tflite::Tensor *output = tensorAt(op->outputs()->Get(0));
+  if (input->type() != tflite::TensorType_INT8 || output->type() != tflite::TensorType_UINT8) {
+    return false;
+  }
+  int32_t multiplier;
+  int shift;
+  tflite::QuantizeMultiplier(static_cast<double>(scaleOf(input)) / static_cast<double>(scaleOf(output)),
+                             &multiplier, &shift);
+  int8_t levels[256];
+  uint8_t table[256];
+  for (int level = 0; level < 256; level++) {
+    levels[level] = static_cast<int8_t>(level - 128);
+  }
+  tflite::reference_ops::Requantize(levels, 256, multiplier, shift, zeroPointOf(input), zeroPointOf(output), table);
+
+  std::string prefix = "op" + std::to_string(opIndex);
+  out.table("uint8_t", prefix + "Table", table, 256, 16);
+  out.add(out.body, "    {\n      tflite::ScopedMicroProfiler event(\"QUANTIZE\", profiler);\n");
+  out.add(out.body, "      const int8_t *from = %s;\n", tensorData(op->inputs()->Get(0), "const int8_t").c_str());
+  out.add(out.body, "      uint8_t *to = %s;\n", tensorData(op->outputs()->Get(0), "uint8_t").c_str());
+  out.add(out.body, "      for (int i = 0; i < %d; i++) {\n", elementsOf(input));
+  out.add(out.body, "        to[i] = %sTable[from[i] + 128];\n      }\n    }\n", prefix.c_str());
+  return true;
+}
+
+int main(int argc, char **argv) {
+  const char *headerPath = nullptr;
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "--header") == 0 && arg + 1 < argc) {
+      headerPath = argv[++arg];
+    } else {
+      fprintf(stderr, "usage: %s [--header path/to/compiledModel.h]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  model = tflite::GetModel(ACTIVE_MODEL);
+  if (model->subgraphs()->size() != 1) {
+    fprintf(stderr, "only single subgraph models compile\n");
+    return 1;
+  }
+  graph = model->subgraphs()->Get(0);
+  if (graph->inputs()->size() != 1 || graph->outputs()->size() != 1
+      || tensorAt(graph->inputs()->Get(0))->type() != tflite::TensorType_UINT8
+      || tensorAt(graph->outputs()->Get(0))->type() != tflite::TensorType_UINT8) {
+    fprintf(stderr, "expected one uint8 input and one uint8 output\n");
+    return 1;
+  }
+  int arenaBytes = planArena();
+
+  Output out;
+  for (uint32_t opIndex = 0; opIndex < graph->operators()->size(); opIndex++) {
+    const tflite::Operator *op = graph->operators()->Get(opIndex);
+    bool compiled = false;
+    if (isFusedConvMax(op)) {
+      compiled = compileConvMax(out, opIndex, op);
+    } else if (opCode(op) == tflite::BuiltinOperator_FULLY_CONNECTED) {
+      compiled = compileFullyConnected(out, opIndex, op);
+    } else if (opCode(op) == tflite::BuiltinOperator_SOFTMAX) {
+      compiled = compileSoftmax(out, opIndex, op);
+    } else if (opCode(op) == tflite::BuiltinOperator_QUANTIZE) {
+      compiled = compileQuantize(out, opIndex, op);
+    }
+    if (!compiled) {
+      fprintf(stderr, "op %u (%s) is not supported, compile the fused graph (USE_FUSED_MODEL)\n", opIndex,
+              tflite::EnumNameBuiltinOperator(opCode(op)));
+      return 1;
+    }
+  }
+  int inputBytes = elementsOf(tensorAt(graph->inputs()->Get(0)));
+  int outputTensor = graph->outputs()->Get(0);
+  int outputBytes = elementsOf(tensorAt(outputTensor));
+  printf("compiled %u ops, %d byte arena, %d byte input, %d byte output\n", graph->operators()->size(),
+         arenaBytes, inputBytes, outputBytes);
+  if (headerPath == nullptr) {
+    return 0;
+  }
+
+  FILE *header = fopen(headerPath, "w");
+  if (header == nullptr) {
+    fprintf(stderr, "cannot write %s\n", headerPath);
+    return 1;
+  }
+  fprintf(header, "// Generated by host/compile_model from ACTIVE_MODEL (activeModel.h), do not edit.\n");
+  fprintf(header, "#pragma once\n");
+  fprintf(header, "#include <cstddef>\n#include <cstdint>\n");
+  fprintf(header, "#include \"fusedConvMax.h\"\n");
+  fprintf(header, "#include \"tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h\"\n");
+  fprintf(header, "#include \"tensorflow/lite/kernels/internal/reference/softmax.h\"\n");
+  fprintf(header, "#include \"tensorflow/lite/micro/micro_profiler_interface.h\"\n");
+  fprintf(header, "#include \"tensorflow/lite/micro/micro_profiler.h\"\n\n");
+  fprintf(header, "// The model as straight-line kernel calls, no interpreter, resolver or flatbuffer\n");
+  fprintf(header, "class CompiledModel {\npublic:\n");
+  fprintf(header, "  static constexpr size_t kSourceBytes = %lu;  // sizeof(ACTIVE_MODEL) it was compiled from\n",
+          (unsigned long)sizeof(ACTIVE_MODEL));
+  fprintf(header, "  static constexpr uint32_t kSourceHash = 0x%08xu;  // modelHash() of that ACTIVE_MODEL\n",
+          (unsigned)modelHash(ACTIVE_MODEL, sizeof(ACTIVE_MODEL)));
+  fprintf(header, "  static constexpr int kInputBytes = %d;\n", inputBytes);
+  fprintf(header, "  static constexpr int kOutputBytes = %d;\n", outputBytes);
+  fprintf(header, "  static constexpr int kArenaBytes = %d;\n\n", arenaBytes);
+  fprintf(header, "  // Runs the graph on kInputBytes of input, returns the kOutputBytes output,\n");
+  fprintf(header, "  // valid until the next call. Ops are reported to profiler when given.\n");
+  fprintf(header, "  static const uint8_t *invoke(const uint8_t *input, tflite::MicroProfilerInterface *profiler = nullptr) {\n");
+  fprintf(header, "%s", out.body.c_str());
+  fprintf(header, "    return %s;\n  }\n\n", tensorData(outputTensor, "const uint8_t").c_str());
+  fprintf(header, "private:\n%s", out.tables.c_str());
+  fprintf(header, "  alignas(16) static inline uint8_t arena[kArenaBytes];\n};\n");
+  if (fclose(header) != 0) {
+    fprintf(stderr, "cannot write %s\n", headerPath);
+    return 1;
+  }
+  printf("wrote %s\n", headerPath);
+  return 0;
+}
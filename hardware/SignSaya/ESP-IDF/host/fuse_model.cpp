@@ -0,0 +1,445 @@
+// Rewrites main/model.h into main/modelFused.h: the Quantize -> ExpandDims ->
+// Conv2D -> Reshape -> ReduceMax chain at the head of the graph becomes one
+// SIGNSAYA_CONV_MAX custom op (main/fusedConvMax.h), so the T x C conv output
+// never takes arena space. Tensors, buffers and op codes only the chain used
+// are dropped. With --offline-plan the arena layout of the fused graph is
+// planned here as well and stored in its OfflineMemoryAllocation metadata, so
+// AllocateTensors on the device places every activation at a fixed offset
+// instead of searching for one. host/bench_boot measures no gain from that for
+// this graph, so the shipped model is planned online. Both graphs are then run
+// on the same random windows and the header is only written when every output
+// matches.
+// Run: ./fuse_model [--header path/to/modelFused.h] [--windows N] [--offline-plan]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "config.h"
+#include "fusedConvMax.h"
+#include "model.h"
+#include "modelHash.h"
+#include "modelOps.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+static const size_t kCheckArenaSize = 1024 * 1024;
+static const char kOfflinePlanName[] = "OfflineMemoryAllocation";
+static const int32_t kOnlinePlanned = -1;  // tflite::kOnlinePlannedBuffer
+
+static tflite::BuiltinOperator opCode(const tflite::ModelT &model, const tflite::OperatorT &op) {
+  const tflite::OperatorCodeT &code = *model.operator_codes[op.opcode_index];
+  return std::max(static_cast<tflite::BuiltinOperator>(code.deprecated_builtin_code), code.builtin_code);
+}
+
+// The only op reading tensor, or -1 when there are none or several
+static int soleConsumer(const tflite::SubGraphT &graph, int32_t tensor) {
+  int consumer = -1;
+  for (size_t index = 0; index < graph.operators.size(); index++) {
+    for (int32_t input : graph.operators[index]->inputs) {
+      if (input == tensor) {
+        if (consumer != -1 && consumer != (int)index) {
+          return -1;
+        }
+        consumer = index;
+      }
+    }
+  }
+  for (int32_t output : graph.outputs) {
+    if (output == tensor) {
+      return -1;
+    }
+  }
+  return consumer;
+}
+
+static const int32_t *constantInt32(const tflite::ModelT &model, const tflite::TensorT &tensor, size_t *count) {
+  const std::vector<uint8_t> &data = model.buffers[tensor.buffer]->data;
+  if (tensor.type != tflite::TensorType_INT32 || data.empty()) {
+    return nullptr;
+  }
+  *count = data.size() / sizeof(int32_t);
+  return reinterpret_cast<const int32_t *>(data.data());
+}
+
+struct Chain {
+  int quantize, expandDims, conv, reshape, reduceMax;
+};
+
+static bool findChain(const tflite::ModelT &model, Chain &chain) {
+  const tflite::SubGraphT &graph = *model.subgraphs[0];
+  for (size_t index = 0; index < graph.operators.size(); index++) {
+    const tflite::OperatorT &quantize = *graph.operators[index];
+    if (opCode(model, quantize) != tflite::BuiltinOperator_QUANTIZE
+        || graph.tensors[quantize.inputs[0]]->type != tflite::TensorType_UINT8
+        || graph.tensors[quantize.outputs[0]]->type != tflite::TensorType_INT8) {
+      continue;
+    }
+    chain.quantize = index;
+    chain.expandDims = soleConsumer(graph, quantize.outputs[0]);
+    if (chain.expandDims < 0 || opCode(model, *graph.operators[chain.expandDims]) != tflite::BuiltinOperator_EXPAND_DIMS) {
+      continue;
+    }
+    const tflite::OperatorT &expandDims = *graph.operators[chain.expandDims];
+    const std::vector<int32_t> &expanded = graph.tensors[expandDims.outputs[0]]->shape;
+    if (expanded.size() != 4 || expanded[1] != 1) {
+      continue;
+    }
+    chain.conv = soleConsumer(graph, expandDims.outputs[0]);
+    if (chain.conv < 0 || opCode(model, *graph.operators[chain.conv]) != tflite::BuiltinOperator_CONV_2D) {
+      continue;
+    }
+    const tflite::OperatorT &conv = *graph.operators[chain.conv];
+    const tflite::Conv2DOptionsT *options = conv.builtin_options.AsConv2DOptions();
+    if (options == nullptr || options->padding != tflite::Padding_VALID || options->stride_w != 1
+        || options->stride_h != 1 || options->dilation_w_factor != 1 || options->dilation_h_factor != 1
+        || options->fused_activation_function != tflite::ActivationFunctionType_NONE
+        || conv.inputs[0] != expandDims.outputs[0] || conv.inputs.size() != 3 || conv.inputs[2] < 0) {
+      continue;
+    }
+    chain.reshape = soleConsumer(graph, conv.outputs[0]);
+    if (chain.reshape < 0 || opCode(model, *graph.operators[chain.reshape]) != tflite::BuiltinOperator_RESHAPE) {
+      continue;
+    }
+    const tflite::OperatorT &reshape = *graph.operators[chain.reshape];
+    const std::vector<int32_t> &reshaped = graph.tensors[reshape.outputs[0]]->shape;
+    if (reshaped.size() != 3 || reshaped[1] != expanded[2] - graph.tensors[conv.inputs[1]]->shape[2] + 1) {
+      continue;
+    }
+    chain.reduceMax = soleConsumer(graph, reshape.outputs[0]);
+    if (chain.reduceMax < 0 || opCode(model, *graph.operators[chain.reduceMax]) != tflite::BuiltinOperator_REDUCE_MAX) {
+      continue;
+    }
+    const tflite::OperatorT &reduceMax = *graph.operators[chain.reduceMax];
+    const tflite::ReducerOptionsT *reducer = reduceMax.builtin_options.AsReducerOptions();
+    size_t axisCount = 0;
+    const int32_t *axis = constantInt32(model, *graph.tensors[reduceMax.inputs[1]], &axisCount);
+    if (reducer == nullptr || reducer->keep_dims || axis == nullptr || axisCount != 1
+        || (axis[0] != 1 && axis[0] != -2)) {
+      continue;
+    }
+    return true;
+  }
+  return false;
+}
+
+// Keeps only what the remaining ops, graph inputs and outputs reference
+static void dropUnused(tflite::ModelT &model) {
+  tflite::SubGraphT &graph = *model.subgraphs[0];
+
+  std::vector<int32_t> tensorMap(graph.tensors.size(), -1);
+  std::vector<bool> tensorUsed(graph.tensors.size(), false);
+  for (const auto &op : graph.operators) {
+    for (int32_t tensor : op->inputs) if (tensor >= 0) tensorUsed[tensor] = true;
+    for (int32_t tensor : op->outputs) tensorUsed[tensor] = true;
+  }
+  for (int32_t tensor : graph.inputs) tensorUsed[tensor] = true;
+  for (int32_t tensor : graph.outputs) tensorUsed[tensor] = true;
+  std::vector<std::unique_ptr<tflite::TensorT>> tensors;
+  for (size_t index = 0; index < graph.tensors.size(); index++) {
+    if (tensorUsed[index]) {
+      tensorMap[index] = tensors.size();
+      tensors.push_back(std::move(graph.tensors[index]));
+    }
+  }
+  graph.tensors = std::move(tensors);
+  auto remapTensors = [&](std::vector<int32_t> &indices) {
+    for (int32_t &tensor : indices) if (tensor >= 0) tensor = tensorMap[tensor];
+  };
+  for (auto &op : graph.operators) {
+    remapTensors(op->inputs);
+    remapTensors(op->outputs);
+  }
+  remapTensors(graph.inputs);
+  remapTensors(graph.outputs);
+  for (auto &signature : model.signature_defs) {
+    for (auto &entry : signature->inputs) entry->tensor_index = tensorMap[entry->tensor_index];
+    for (auto &entry : signature->outputs) entry->tensor_index = tensorMap[entry->tensor_index];
+  }
+
+  // the offline plan, if any, was made for the old tensor list
+  for (size_t index = 0; index < model.metadata.size();) {
+    if (model.metadata[index]->name == kOfflinePlanName) {
+      model.metadata.erase(model.metadata.begin() + index);
+    } else {
+      index++;
+    }
+  }
+
+  // buffer 0 stays, it is the empty buffer every activation points at
+  std::vector<int32_t> bufferMap(model.buffers.size(), -1);
+  std::vector<bool> bufferUsed(model.buffers.size(), false);
+  bufferUsed[0] = true;
+  for (const auto &tensor : graph.tensors) bufferUsed[tensor->buffer] = true;
+  for (const auto &entry : model.metadata) bufferUsed[entry->buffer] = true;
+  for (int32_t buffer : model.metadata_buffer) bufferUsed[buffer] = true;
+  std::vector<std::unique_ptr<tflite::BufferT>> buffers;
+  for (size_t index = 0; index < model.buffers.size(); index++) {
+    if (bufferUsed[index]) {
+      bufferMap[index] = buffers.size();
+      buffers.push_back(std::move(model.buffers[index]));
+    }
+  }
+  model.buffers = std::move(buffers);
+  for (auto &tensor : graph.tensors) tensor->buffer = bufferMap[tensor->buffer];
+  for (auto &entry : model.metadata) entry->buffer = bufferMap[entry->buffer];
+  for (int32_t &buffer : model.metadata_buffer) buffer = bufferMap[buffer];
+
+  std::vector<int32_t> codeMap(model.operator_codes.size(), -1);
+  std::vector<std::unique_ptr<tflite::OperatorCodeT>> codes;
+  for (auto &op : graph.operators) {
+    if (codeMap[op->opcode_index] < 0) {
+      codeMap[op->opcode_index] = codes.size();
+      codes.push_back(std::move(model.operator_codes[op->opcode_index]));
+    }
+    op->opcode_index = codeMap[op->opcode_index];
+  }
+  model.operator_codes = std::move(codes);
+}
+
+static bool fuse(tflite::ModelT &model) {
+  Chain chain;
+  if (model.subgraphs.size() != 1 || !findChain(model, chain)) {
+    return false;
+  }
+  tflite::SubGraphT &graph = *model.subgraphs[0];
+  const tflite::OperatorT &quantize = *graph.operators[chain.quantize];
+  const tflite::OperatorT &conv = *graph.operators[chain.conv];
+  const tflite::OperatorT &reduceMax = *graph.operators[chain.reduceMax];
+  const tflite::QuantizationParametersT *convInput = graph.tensors[quantize.outputs[0]]->quantization.get();
+  if (convInput == nullptr || convInput->scale.size() != 1 || convInput->zero_point.size() != 1) {
+    return false;
+  }
+
+  std::unique_ptr<tflite::OperatorCodeT> code(new tflite::OperatorCodeT);
+  code->deprecated_builtin_code = tflite::BuiltinOperator_CUSTOM;
+  code->builtin_code = tflite::BuiltinOperator_CUSTOM;
+  code->custom_code = FUSED_CONV_MAX_OP;
+  model.operator_codes.push_back(std::move(code));
+
+  std::unique_ptr<tflite::OperatorT> fused(new tflite::OperatorT);
+  fused->opcode_index = model.operator_codes.size() - 1;
+  fused->inputs = {quantize.inputs[0], conv.inputs[1], conv.inputs[2]};
+  fused->outputs = {reduceMax.outputs[0]};
+  float scale = convInput->scale[0];
+  int32_t zeroPoint = (int32_t)convInput->zero_point[0];
+  fused->custom_options.resize(FUSED_CONV_MAX_OPTIONS_BYTES);
+  memcpy(&fused->custom_options[0], &scale, sizeof(scale));
+  memcpy(&fused->custom_options[sizeof(scale)], &zeroPoint, sizeof(zeroPoint));
+
+  // the chain is the graph's head, the fused op takes the Quantize's place
+  int chainOps[] = {chain.quantize, chain.expandDims, chain.conv, chain.reshape, chain.reduceMax};
+  std::vector<std::unique_ptr<tflite::OperatorT>> operators;
+  for (size_t index = 0; index < graph.operators.size(); index++) {
+    if ((int)index == chain.quantize) {
+      operators.push_back(std::move(fused));
+    } else if (std::find(std::begin(chainOps), std::end(chainOps), (int)index) == std::end(chainOps)) {
+      operators.push_back(std::move(graph.operators[index]));
+    }
+  }
+  graph.operators = std::move(operators);
+  dropUnused(model);
+  return true;
+}
+
+static size_t tensorBytes(const tflite::TensorT &tensor) {
+  size_t bytes;
+  switch (tensor.type) {
+    case tflite::TensorType_INT8:
+    case tflite::TensorType_UINT8:
+    case tflite::TensorType_BOOL:
+      bytes = 1;
+      break;
+    case tflite::TensorType_INT16:
+    case tflite::TensorType_FLOAT16:
+      bytes = 2;
+      break;
+    case tflite::TensorType_INT64:
+      bytes = 8;
+      break;
+    default:
+      bytes = 4;
+      break;
+  }
+  for (int32_t dim : tensor.shape) {
+    bytes *= dim;
+  }
+  return bytes;
+}
+
+// Plans every activation with the lifetimes MicroAllocator gives them (graph
+// inputs from scope 0, op i at scope i + 1, graph outputs to the last scope)
+// and stores the offsets as [version 1, subgraph 0, tensor count, offset per
+// tensor], -1 for the constants. Scratch buffers are requested by the kernels
+// at Prepare and stay online planned around these.
+static void embedOfflinePlan(tflite::ModelT &model) {
+  const tflite::SubGraphT &graph = *model.subgraphs[0];
+  const int tensorCount = graph.tensors.size();
+  const int lastScope = graph.operators.size();
+  std::vector<int> first(tensorCount, -1);
+  std::vector<int> last(tensorCount, -1);
+  auto use = [&](int32_t tensor, int scope, bool creates) {
+    if (tensor < 0) return;
+    if (creates && first[tensor] < 0) first[tensor] = scope;
+    last[tensor] = std::max(last[tensor], scope);
+  };
+  for (int32_t tensor : graph.inputs) use(tensor, 0, true);
+  for (int index = 0; index < lastScope; index++) {
+    for (int32_t tensor : graph.operators[index]->outputs) use(tensor, index + 1, true);
+    for (int32_t tensor : graph.operators[index]->inputs) use(tensor, index + 1, false);
+  }
+  for (int32_t tensor : graph.outputs) use(tensor, lastScope, true);
+
+  static unsigned char plannerScratch[8192];
+  tflite::GreedyMemoryPlanner planner;
+  planner.Init(plannerScratch, sizeof(plannerScratch));
+  std::vector<int32_t> plan = {1, 0, tensorCount};
+  std::vector<int> planned;
+  std::vector<size_t> live(lastScope + 1, 0);
+  for (int index = 0; index < tensorCount; index++) {
+    const tflite::TensorT &tensor = *graph.tensors[index];
+    size_t bytes = tensorBytes(tensor);
+    plan.push_back(kOnlinePlanned);
+    if (!model.buffers[tensor.buffer]->data.empty() || tensor.is_variable || bytes == 0 || first[index] < 0) {
+      continue;
+    }
+    size_t aligned = (bytes + tflite::MicroArenaBufferAlignment() - 1) / tflite::MicroArenaBufferAlignment()
+        * tflite::MicroArenaBufferAlignment();
+    planner.AddBuffer(aligned, first[index], last[index]);
+    planned.push_back(index);
+    for (int scope = first[index]; scope <= last[index]; scope++) live[scope] += aligned;
+  }
+  for (size_t buffer = 0; buffer < planned.size(); buffer++) {
+    int offset;
+    planner.GetOffsetForBuffer(buffer, &offset);
+    plan[3 + planned[buffer]] = offset;
+  }
+  int planBytes = planner.GetMaximumMemorySize();
+  // no layout can be smaller than the most bytes live in one scope
+  printf("offline plan: %lu of %d tensors, %d bytes, lower bound %lu\n", (unsigned long)planned.size(),
+         tensorCount, planBytes, (unsigned long)*std::max_element(live.begin(), live.end()));
+
+  std::unique_ptr<tflite::BufferT> buffer(new tflite::BufferT);
+  buffer->data.resize(plan.size() * sizeof(int32_t));
+  memcpy(buffer->data.data(), plan.data(), buffer->data.size());
+  model.buffers.push_back(std::move(buffer));
+  std::unique_ptr<tflite::MetadataT> metadata(new tflite::MetadataT);
+  metadata->name = kOfflinePlanName;
+  metadata->buffer = model.buffers.size() - 1;
+  model.metadata.push_back(std::move(metadata));
+}
+
+// Runs both graphs on the same windows, true when every output byte matches
+static bool outputsMatch(const uint8_t *fusedModel, uint32_t windows) {
+  static ModelOpResolver resolver;
+  if (registerModelOps(resolver) != kTfLiteOk) {
+    return false;
+  }
+  std::vector<uint8_t> originalArena(kCheckArenaSize);
+  std::vector<uint8_t> fusedArena(kCheckArenaSize);
+  tflite::MicroInterpreter original(tflite::GetModel(signsaya_model), resolver, originalArena.data(), kCheckArenaSize);
+  tflite::MicroInterpreter fused(tflite::GetModel(fusedModel), resolver, fusedArena.data(), kCheckArenaSize);
+  if (original.AllocateTensors() != kTfLiteOk || fused.AllocateTensors() != kTfLiteOk
+      || original.input(0)->bytes != fused.input(0)->bytes || original.output(0)->bytes != fused.output(0)->bytes) {
+    fprintf(stderr, "fused graph does not load like the original\n");
+    return false;
+  }
+  printf("arena: %lu bytes original, %lu bytes fused\n", (unsigned long)original.arena_used_bytes(),
+         (unsigned long)fused.arena_used_bytes());
+
+  srand(1);
+  size_t bytes = original.input(0)->bytes;
+  for (uint32_t window = 0; window < windows; window++) {
+    // alternate full range noise and a narrow band around a random level
+    int level = rand() % 256;
+    for (size_t index = 0; index < bytes; index++) {
+      int value = window % 2 == 0 ? rand() % 256 : level + rand() % 17 - 8;
+      original.input(0)->data.uint8[index] = (uint8_t)std::min(255, std::max(0, value));
+    }
+    memcpy(fused.input(0)->data.uint8, original.input(0)->data.uint8, bytes);
+    if (original.Invoke() != kTfLiteOk || fused.Invoke() != kTfLiteOk) {
+      fprintf(stderr, "Invoke() failed on window %lu\n", (unsigned long)window);
+      return false;
+    }
+    if (memcmp(original.output(0)->data.uint8, fused.output(0)->data.uint8, original.output(0)->bytes) != 0) {
+      fprintf(stderr, "outputs differ on window %lu\n", (unsigned long)window);
+      return false;
+    }
+  }
+  printf("outputs: %lu windows identical\n", (unsigned long)windows);
+  return true;
+}
+
+static bool writeHeader(const char *path, const uint8_t *data, size_t size, bool offlinePlan) {
+  FILE *header = fopen(path, "w");
+  if (header == nullptr) {
+    return false;
+  }
+  fprintf(header, "// Generated by host/fuse_model from model.h, do not edit. Rerun it when model.h changes.\n");
+  if (offlinePlan) {
+    fprintf(header, "// Carries an OfflineMemoryAllocation plan, AllocateTensors uses it instead of planning.\n");
+  }
+  fprintf(header, "#pragma once\n\n");
+  fprintf(header, "#define MODEL_FUSED_SOURCE_HASH 0x%08xu  // modelHash() of the signsaya_model it was fused from\n\n",
+          (unsigned)modelHash(signsaya_model, sizeof(signsaya_model)));
+  fprintf(header, "alignas(16) const unsigned char signsaya_model_fused[] = {");
+  for (size_t index = 0; index < size; index++) {
+    fprintf(header, "%s0x%02x%s", index % 12 == 0 ? "\n  " : "", data[index], index + 1 < size ? ", " : "");
+  }
+  fprintf(header, "\n};\n");
+  return fclose(header) == 0;
+}
+
+int main(int argc, char **argv) {
+  const char *headerPath = nullptr;
+  uint32_t windows = 20;
+  bool offlinePlan = false;
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "--header") == 0 && arg + 1 < argc) {
+      headerPath = argv[++arg];
+    } else if (strcmp(argv[arg], "--windows") == 0 && arg + 1 < argc) {
+      windows = (uint32_t)strtoul(argv[++arg], nullptr, 10);
+    } else if (strcmp(argv[arg], "--offline-plan") == 0) {
+      offlinePlan = true;
+    } else {
+      fprintf(stderr, "usage: %s [--header path/to/modelFused.h] [--windows N] [--offline-plan]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::unique_ptr<tflite::ModelT> model(tflite::GetModel(signsaya_model)->UnPack());
+  size_t originalOps = model->subgraphs[0]->operators.size();
+  if (!fuse(*model)) {
+    fprintf(stderr, "no Quantize -> ExpandDims -> Conv2D -> Reshape -> ReduceMax chain to fuse\n");
+    return 1;
+  }
+  if (offlinePlan) {
+    embedOfflinePlan(*model);
+  }
+  // TFLM's flatbuffers has no fallback for a null allocator, pass one
+  flatbuffers::DefaultAllocator allocator;
+  flatbuffers::FlatBufferBuilder builder(1024, &allocator);
+  builder.Finish(tflite::Model::Pack(builder, model.get()), tflite::ModelIdentifier());
+  // copy into 16 byte aligned memory like the generated header declares
+  std::vector<uint64_t> aligned((builder.GetSize() + 15) / 8);
+  memcpy(aligned.data(), builder.GetBufferPointer(), builder.GetSize());
+  const uint8_t *fusedModel = reinterpret_cast<const uint8_t *>(aligned.data());
+  printf("model: %lu ops in %lu bytes, fused %lu ops in %lu bytes\n", (unsigned long)originalOps,
+         (unsigned long)sizeof(signsaya_model), (unsigned long)model->subgraphs[0]->operators.size(),
+         (unsigned long)builder.GetSize());
+
+  if (!outputsMatch(fusedModel, windows)) {
+    return 1;
+  }
+  if (headerPath != nullptr) {
+    if (!writeHeader(headerPath, fusedModel, builder.GetSize(), offlinePlan)) {
+      fprintf(stderr, "cannot write %s\n", headerPath);
+      return 1;
+    }
+    printf("wrote %s\n", headerPath);
+  }
+  return 0;
+}
@@ -0,0 +1,274 @@
+// Counts ICM-20948 bus transactions through a mock serif, with and without
+// the driver's shadow register cache. Runs the startup sequence and the
+// steady state FIFO read loop, checks both leave the mock device in the
+// same state and that every cached register still matches the device.
+// Run: ./icm_bus_stats [loops]
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include "ICM_20948_C.h"
+
+// Register file plus a FIFO, enough of the device for the C driver
+struct MockIcm {
+  uint8_t regs[4][128];
+  uint8_t bank = 0;
+  std::deque<uint8_t> fifo;
+  uint32_t reads = 0;
+  uint32_t writes = 0;
+
+  MockIcm() {
+    reset();
+  }
+
+  void reset() {
+    memset(regs, 0, sizeof(regs));
+    regs[0][AGB0_REG_WHO_AM_I] = ICM_20948_WHOAMI;
+    regs[0][AGB0_REG_PWR_MGMT_1] = 0x41;  // sleep, auto clock
+    bank = 0;
+    fifo.clear();
+  }
+
+  void pushQuat9(uint8_t seed) {
+    const uint8_t header[2] = { 0x04, 0x00 };  // DMP_header_bitmap_Quat9
+    fifo.insert(fifo.end(), header, header + 2);
+    for (int i = 0; i < icm_20948_DMP_Quat9_Bytes; i++) {
+      fifo.push_back((uint8_t)(seed + i));
+    }
+    fifo.push_back(0);
+    fifo.push_back(seed);
+  }
+
+  // FIFO_R_W and MEM_R_W are data ports, the address does not auto increment
+  bool isDataPort(uint8_t reg) const {
+    return bank == 0 && (reg == AGB0_REG_FIFO_R_W || reg == AGB0_REG_MEM_R_W);
+  }
+
+  void write(uint8_t reg, const uint8_t *data, uint32_t len) {
+    writes++;
+    if (reg == AGB0_REG_REG_BANK_SEL) {
+      bank = (data[0] >> 4) & 0x03;
+      return;
+    }
+    if (isDataPort(reg)) {
+      return;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+      uint8_t address = reg + i;
+      uint8_t value = data[i];
+      if (bank == 0 && address == AGB0_REG_PWR_MGMT_1 && (value & 0x80)) {
+        reset();
+        return;
+      }
+      if (bank == 0 && address == AGB0_REG_FIFO_RST) {
+        fifo.clear();
+      }
+      if (bank == 0 && address == AGB0_REG_USER_CTRL) {
+        value &= ~0x0E;  // reset bits clear themselves
+      }
+      regs[bank][address] = value;
+    }
+  }
+
+  void read(uint8_t reg, uint8_t *data, uint32_t len) {
+    reads++;
+    for (uint32_t i = 0; i < len; i++) {
+      if (bank == 0 && reg == AGB0_REG_FIFO_R_W) {
+        data[i] = fifo.empty() ? 0 : fifo.front();
+        if (!fifo.empty()) {
+          fifo.pop_front();
+        }
+        continue;
+      }
+      if (isDataPort(reg)) {
+        data[i] = 0;
+        continue;
+      }
+      uint8_t address = reg + i;
+      if (bank == 0 && address == AGB0_REG_FIFO_COUNT_H) {
+        data[i] = (uint8_t)(fifo.size() >> 8);
+      } else if (bank == 0 && address == AGB0_REG_FIFO_COUNT_L) {
+        data[i] = (uint8_t)(fifo.size() & 0xFF);
+      } else if (address == AGB0_REG_REG_BANK_SEL) {
+        data[i] = bank << 4;
+      } else {
+        data[i] = regs[bank][address];
+      }
+    }
+  }
+};
+
+static ICM_20948_Status_e mockWrite(uint8_t regaddr, uint8_t *pdata, uint32_t len, void *user) {
+  ((MockIcm *)user)->write(regaddr, pdata, len);
+  return ICM_20948_Stat_Ok;
+}
+
+static ICM_20948_Status_e mockRead(uint8_t regaddr, uint8_t *pdata, uint32_t len, void *user) {
+  ((MockIcm *)user)->read(regaddr, pdata, len);
+  return ICM_20948_Stat_Ok;
+}
+
+// Same register traffic as ICM_20948::startupDefault followed by the DMP
+// interrupt and FIFO setup done in icmDMP.h, without the DMP image upload
+static void startup(ICM_20948_Device_t *device) {
+  ICM_20948_check_id(device);
+  ICM_20948_sw_reset(device);
+  ICM_20948_sleep(device, false);
+  ICM_20948_low_power(device, false);
+  ICM_20948_set_sample_mode(device, (ICM_20948_InternalSensorID_bm)(ICM_20948_Internal_Acc | ICM_20948_Internal_Gyr), ICM_20948_Sample_Mode_Continuous);
+
+  ICM_20948_fss_t fss;
+  fss.a = gpm2;
+  fss.g = dps250;
+  ICM_20948_set_full_scale(device, (ICM_20948_InternalSensorID_bm)(ICM_20948_Internal_Acc | ICM_20948_Internal_Gyr), fss);
+
+  ICM_20948_dlpcfg_t dlpcfg;
+  dlpcfg.a = acc_d473bw_n499bw;
+  dlpcfg.g = gyr_d361bw4_n376bw5;
+  ICM_20948_set_dlpf_cfg(device, (ICM_20948_InternalSensorID_bm)(ICM_20948_Internal_Acc | ICM_20948_Internal_Gyr), dlpcfg);
+  ICM_20948_enable_dlpf(device, ICM_20948_Internal_Acc, false);
+  ICM_20948_enable_dlpf(device, ICM_20948_Internal_Gyr, false);
+
+  ICM_20948_INT_PIN_CFG_t pinCfg;
+  ICM_20948_int_pin_cfg(device, NULL, &pinCfg);
+  pinCfg.INT1_ACTL = 0;
+  ICM_20948_int_pin_cfg(device, &pinCfg, &pinCfg);
+  ICM_20948_int_pin_cfg(device, NULL, &pinCfg);
+  pinCfg.INT1_LATCH_EN = 0;
+  ICM_20948_int_pin_cfg(device, &pinCfg, &pinCfg);
+
+  ICM_20948_INT_enable_t enable;
+  ICM_20948_int_enable(device, NULL, &enable);
+  enable.DMP_INT1_EN = 1;
+  ICM_20948_int_enable(device, &enable, &enable);
+
+  ICM_20948_enable_FIFO(device, true);
+  ICM_20948_enable_DMP(device, true);
+  ICM_20948_reset_DMP(device);
+  ICM_20948_reset_FIFO(device);
+}
+
+// What accelSensor::drainFIFO does on every interrupt
+static uint32_t burstLoop(ICM_20948_Device_t *device, MockIcm *mock, int loops) {
+  uint8_t buffer[512];
+  uint32_t packets = 0;
+  for (int loop = 0; loop < loops; loop++) {
+    for (int packet = 0; packet < 8; packet++) {
+      mock->pushQuat9((uint8_t)(loop + packet));
+    }
+    uint16_t count = 0;
+    ICM_20948_get_FIFO_count(device, &count);
+    ICM_20948_read_FIFO_burst(device, buffer, count);
+    uint16_t offset = 0;
+    uint16_t consumed = 0;
+    icm_20948_DMP_data_t data;
+    while (offset < count) {
+      inv_icm20948_parse_dmp_data(&buffer[offset], count - offset, &data, &consumed);
+      if (consumed == 0) {
+        break;
+      }
+      offset += consumed;
+      packets++;
+    }
+  }
+  return packets;
+}
+
+// The per packet reader the firmware used before the burst drain
+static uint32_t packetLoop(ICM_20948_Device_t *device, MockIcm *mock, int loops) {
+  uint32_t packets = 0;
+  for (int loop = 0; loop < loops; loop++) {
+    for (int packet = 0; packet < 8; packet++) {
+      mock->pushQuat9((uint8_t)(loop + packet));
+    }
+    icm_20948_DMP_data_t data;
+    ICM_20948_Status_e status;
+    do {
+      status = inv_icm20948_read_dmp_data(device, &data);
+      if (status == ICM_20948_Stat_Ok || status == ICM_20948_Stat_FIFOMoreDataAvail) {
+        packets++;
+      }
+    } while (status == ICM_20948_Stat_FIFOMoreDataAvail);
+  }
+  return packets;
+}
+
+static void printStats(const char *phase, bool cached, const ICM_20948_Bus_Stats_t &stats, uint32_t onBus, uint32_t packets) {
+  printf("%-8s %-6s %8u %8u %8u %8u %8u %8u", phase, cached ? "on" : "off", (unsigned)stats.reads, (unsigned)stats.writes,
+         (unsigned)stats.reads_saved, (unsigned)stats.writes_saved, (unsigned)stats.bank_switches_saved, (unsigned)onBus);
+  if (packets > 0) {
+    printf("   %.3f per packet", (double)onBus / packets);
+  }
+  printf("\n");
+}
+
+static ICM_20948_Bus_Stats_t since(const ICM_20948_Bus_Stats_t &now, const ICM_20948_Bus_Stats_t &before) {
+  ICM_20948_Bus_Stats_t stats;
+  stats.reads = now.reads - before.reads;
+  stats.writes = now.writes - before.writes;
+  stats.reads_saved = now.reads_saved - before.reads_saved;
+  stats.writes_saved = now.writes_saved - before.writes_saved;
+  stats.bank_switches_saved = now.bank_switches_saved - before.bank_switches_saved;
+  return stats;
+}
+
+// Reads every register back through the driver, and for each one served
+// from the shadow cache compares it with what the mock device holds
+static uint32_t staleCacheEntries(ICM_20948_Device_t *device, MockIcm &mock) {
+  uint32_t stale = 0;
+  for (uint8_t bank = 0; bank < 4; bank++) {
+    ICM_20948_set_bank(device, bank);
+    for (uint8_t reg = 0; reg < 128; reg++) {
+      if (reg == AGB0_REG_REG_BANK_SEL || mock.isDataPort(reg)) {
+        continue;
+      }
+      uint32_t saved = device->_bus_stats.reads_saved;
+      uint8_t value = 0;
+      ICM_20948_execute_r(device, reg, &value, 1);
+      if (device->_bus_stats.reads_saved != saved && value != mock.regs[bank][reg]) {
+        printf("bank %u register 0x%02X cached as 0x%02X, device holds 0x%02X\n", bank, reg, value,
+               mock.regs[bank][reg]);
+        stale++;
+      }
+    }
+  }
+  return stale;
+}
+
+static bool run(bool cached, int loops, MockIcm &mock) {
+  ICM_20948_Serif_t serif = { mockWrite, mockRead, &mock };
+  ICM_20948_Device_t device;
+  ICM_20948_init_struct(&device);
+  ICM_20948_link_serif(&device, &serif);
+  device._dmp_firmware_available = true;
+  device._shadow_enabled = cached;
+
+  startup(&device);
+  printStats("startup", cached, device._bus_stats, mock.reads + mock.writes, 0);
+
+  ICM_20948_Bus_Stats_t before = device._bus_stats;
+  uint32_t onBus = mock.reads + mock.writes;
+  uint32_t packets = burstLoop(&device, &mock, loops);
+  printStats("burst", cached, since(device._bus_stats, before), mock.reads + mock.writes - onBus, packets);
+
+  before = device._bus_stats;
+  onBus = mock.reads + mock.writes;
+  packets = packetLoop(&device, &mock, loops);
+  printStats("packet", cached, since(device._bus_stats, before), mock.reads + mock.writes - onBus, packets);
+  return staleCacheEntries(&device, mock) == 0;
+}
+
+int main(int argc, char **argv) {
+  int loops = argc > 1 ? atoi(argv[1]) : 100;
+
+  printf("%-8s %-6s %8s %8s %8s %8s %8s %8s\n", "phase", "cache", "reads", "writes", "rd-saved", "wr-saved", "bank-sav", "on-bus");
+  MockIcm uncached;
+  run(false, loops, uncached);
+  MockIcm cached;
+  bool coherent = run(true, loops, cached);
+
+  bool same = memcmp(uncached.regs, cached.regs, sizeof(uncached.regs)) == 0 && uncached.bank == cached.bank;
+  printf("register state %s\n", same ? "matches" : "DIFFERS");
+  printf("shadow cache %s\n", coherent ? "matches the device" : "is STALE");
+  return same && coherent ? 0 : 1;
+}
@@ -0,0 +1,293 @@
+// Writes a labelled synthetic sensor trace (sensorTrace.h) for pipeline_sim,
+// standing in for glove recordings of the signs. For each sign a hand pose
+// the model calls that sign is found first: random poses, then hill climbing
+// one feature at a time on the compiled model's margin for the sign over a
+// window holding the pose throughout. The trace then starts at rest for as
+// long as the inference window takes to fill, and for each sign has a MARK,
+// a half second move into its pose and the pose held for --hold-s, as raw
+// 12-bit ADC frames at FINGER_SAMPLING_RATE and Quat9 packets at the DMP's
+// 55 Hz, both with timing jitter and sensor noise. The values are inverted
+// through fingers.h's default mapping and quatQuantize.h so the glove's
+// pipeline turns them back into the pose's bytes. Signs no pose was found
+// for are reported and left out. Same --seed, same trace.
+// Run: ./make_trace out.trace [--hold-s S] [--seed N] [--signs 0,3,5]
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "config.h"
+#include "compiledModel.h"
+#include "quatQuantize.h"
+#include "sensorTrace.h"
+
+static const int kFeatures = 8;  // the window's row without w, which follows from x, y and z
+static const int kClasses = CompiledModel::kOutputBytes;
+static const uint32_t kDmpPeriod = 1000000 / 55;
+static const uint32_t kMovePeriod = 500000;
+static const int kRandomPoses = 1500;
+static const int kClimbEvaluations = 400;
+static const int kGoodMargin = 96;  // score points over the runner up, out of 255
+
+struct Pose {
+  uint8_t bytes[kFeatures];  // thumb, index, middle, ring, pinky, x, y, z
+};
+
+alignas(16) static uint8_t window[CompiledModel::kInputBytes];
+
+static uint32_t nextRandom(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// The middle of the Q30 range quantizeQ30 maps to value
+static int32_t q30Of(double value) {
+  return (int32_t)((value + 0.5) * 2147483648.0 / 255.0 - 1073741824.0);
+}
+
+static bool isUnit(const double xyz[3]) {
+  double sum = 0;
+  for (int axis = 0; axis < 3; axis++) {
+    double q = q30Of(xyz[axis]) / 1073741824.0;
+    sum += q * q;
+  }
+  return sum < 1.0;
+}
+
+static bool isUnit(const Pose &pose) {
+  const double xyz[3] = { (double)pose.bytes[5], (double)pose.bytes[6], (double)pose.bytes[7] };
+  return isUnit(xyz);
+}
+
+static const uint8_t *scoresOf(const Pose &pose) {
+  uint8_t row[INFERENCE_FEATURES];
+  memcpy(row, pose.bytes, kFeatures);
+  row[8] = quantizeQuaternionW(q30Of(pose.bytes[5]), q30Of(pose.bytes[6]), q30Of(pose.bytes[7]));
+  for (int index = 0; index < INFERENCE_LENGTH; index++) {
+    memcpy(&window[index * INFERENCE_FEATURES], row, INFERENCE_FEATURES);
+  }
+  return CompiledModel::invoke(window);
+}
+
+static int marginOf(const uint8_t *scores, int sign) {
+  int other = 0;
+  for (int index = 0; index < kClasses; index++) {
+    if (index != sign) {
+      other = std::max(other, (int)scores[index]);
+    }
+  }
+  return (int)scores[sign] - other;
+}
+
+// Coordinate ascent on the margin from start, halving the step when stuck
+static int climb(Pose &pose, int sign, int margin) {
+  int evaluations = 0;
+  for (int step = 32; step >= 2 && margin < kGoodMargin && evaluations < kClimbEvaluations; ) {
+    bool improved = false;
+    for (int feature = 0; feature < kFeatures && evaluations < kClimbEvaluations; feature++) {
+      for (int direction = -1; direction <= 1; direction += 2) {
+        Pose candidate = pose;
+        int value = candidate.bytes[feature] + direction * step;
+        // x, y and z stay off 0 and 255, the ends of the quantizer
+        int low = feature >= 5 ? 1 : 0, high = feature >= 5 ? 254 : 255;
+        candidate.bytes[feature] = (uint8_t)std::min(high, std::max(low, value));
+        if (candidate.bytes[feature] == pose.bytes[feature] || !isUnit(candidate)) {
+          continue;
+        }
+        evaluations++;
+        int candidateMargin = marginOf(scoresOf(candidate), sign);
+        if (candidateMargin > margin) {
+          pose = candidate;
+          margin = candidateMargin;
+          improved = true;
+        }
+      }
+    }
+    if (!improved) {
+      step /= 2;
+    }
+  }
+  return margin;
+}
+
+// Both streams of the trace, written in time order
+class TraceBuilder {
+private:
+  SensorTraceWriter writer;
+  std::vector<uint8_t> &out;
+  uint32_t &random;
+  uint64_t nextFrame;
+  uint64_t nextPacket;
+
+  double noise(double amplitude) {
+    return ((double)(nextRandom(random) % 2001) / 1000.0 - 1.0) * amplitude;
+  }
+
+  uint32_t jitter(uint32_t amplitude) {
+    return nextRandom(random) % (2 * amplitude + 1);
+  }
+
+  void append(const uint8_t *record, size_t length) {
+    out.insert(out.end(), record, record + length);
+  }
+
+public:
+  uint64_t now;
+
+  TraceBuilder(std::vector<uint8_t> &trace, uint32_t &state, uint64_t start)
+    : out(trace), random(state), nextFrame(start), nextPacket(start + 3000), now(start) {
+    uint8_t header[SENSOR_TRACE_HEADER_BYTES];
+    append(header, writer.header(header));
+  }
+
+  void mark(uint8_t sign) {
+    uint8_t record[SENSOR_TRACE_MAX_RECORD_BYTES];
+    append(record, writer.mark(record, (uint32_t)now, sign));
+  }
+
+  // Moves from one pose to the other over moveMicros, then holds until until
+  void run(const Pose &from, const Pose &to, uint64_t moveMicros, uint64_t until) {
+    uint64_t moveStart = now;
+    uint8_t record[SENSOR_TRACE_MAX_RECORD_BYTES];
+    while (std::min(nextFrame, nextPacket) < until) {
+      now = std::min(nextFrame, nextPacket);
+      double progress = moveMicros == 0 ? 1.0 : std::min(1.0, (double)(now - moveStart) / moveMicros);
+      double value[kFeatures];
+      for (int feature = 0; feature < kFeatures; feature++) {
+        value[feature] = from.bytes[feature] + (to.bytes[feature] - from.bytes[feature]) * progress;
+      }
+      if (now == nextFrame) {
+        // handData_t order, the middle of the readings FingerInstance's 0-4095 mapping turns into the value
+        uint16_t raw[FINGER_COUNT];
+        for (int finger = 0; finger < FINGER_COUNT; finger++) {
+          double level = (value[4 - finger] + 0.5) * 4095.0 / 255.0 + noise(6.0);
+          raw[finger] = (uint16_t)std::min(4095.0, std::max(0.0, std::round(level)));
+        }
+        append(record, writer.adc(record, (uint32_t)now, raw));
+        nextFrame += 1000000 / FINGER_SAMPLING_RATE - 150 + jitter(150);
+      } else {
+        double xyz[3];
+        for (int axis = 0; axis < 3; axis++) {
+          xyz[axis] = std::min(254.4, std::max(0.6, value[5 + axis] + noise(0.1)));
+        }
+        // the poses and every blend of two are inside the unit ball, the noise may not be
+        if (!isUnit(xyz)) {
+          xyz[0] = value[5];
+          xyz[1] = value[6];
+          xyz[2] = value[7];
+        }
+        append(record, writer.dmp(record, (uint32_t)now, q30Of(xyz[0]), q30Of(xyz[1]), q30Of(xyz[2])));
+        nextPacket += kDmpPeriod - 300 + jitter(300);
+      }
+    }
+    now = until;
+  }
+};
+
+int main(int argc, char **argv) {
+  const char *outputPath = nullptr;
+  // long enough for a window that is all the pose to be inferred on, whatever the phase
+  double holdSeconds = (double)(INFERENCE_LENGTH + 2 * INFERENCE_WINDOW) / FUSION_RATE;
+  uint32_t seed = 1;
+  std::vector<int> signs;
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "--hold-s") == 0 && arg + 1 < argc) {
+      holdSeconds = atof(argv[++arg]);
+    } else if (strcmp(argv[arg], "--seed") == 0 && arg + 1 < argc) {
+      seed = (uint32_t)strtoul(argv[++arg], nullptr, 10);
+    } else if (strcmp(argv[arg], "--signs") == 0 && arg + 1 < argc) {
+      for (char *token = strtok(argv[++arg], ","); token != nullptr; token = strtok(nullptr, ",")) {
+        signs.push_back(atoi(token));
+      }
+    } else if (outputPath == nullptr && argv[arg][0] != '-') {
+      outputPath = argv[arg];
+    } else {
+      outputPath = nullptr;
+      break;
+    }
+  }
+  if (outputPath == nullptr || holdSeconds <= 0) {
+    fprintf(stderr, "usage: %s out.trace [--hold-s S] [--seed N] [--signs 0,3,5]\n", argv[0]);
+    return 2;
+  }
+  if (signs.empty()) {
+    for (int sign = 0; sign < kClasses; sign++) {
+      signs.push_back(sign);
+    }
+  }
+  uint32_t random = seed * 2654435761u + 1;
+
+  // random poses first, the best one for each sign is where its climb starts
+  Pose best[kClasses];
+  int bestMargin[kClasses];
+  std::fill(bestMargin, bestMargin + kClasses, -256);
+  Pose rest = {};
+  int restSign = -1;
+  for (int attempt = 0; attempt < kRandomPoses; attempt++) {
+    Pose pose;
+    do {
+      for (int feature = 0; feature < kFeatures; feature++) {
+        pose.bytes[feature] = (uint8_t)(feature >= 5 ? 1 + nextRandom(random) % 254 : nextRandom(random) % 256);
+      }
+    } while (!isUnit(pose));
+    const uint8_t *scores = scoresOf(pose);
+    for (int sign = 0; sign < kClasses; sign++) {
+      int margin = marginOf(scores, sign);
+      if (margin > bestMargin[sign]) {
+        bestMargin[sign] = margin;
+        best[sign] = pose;
+      }
+    }
+  }
+
+  std::vector<int> found;
+  for (int sign : signs) {
+    if (sign < 0 || sign >= kClasses) {
+      fprintf(stderr, "no sign %d, the model has %d\n", sign, kClasses);
+      return 2;
+    }
+    int margin = climb(best[sign], sign, bestMargin[sign]);
+    printf("sign %2d: pose", sign);
+    for (int feature = 0; feature < kFeatures; feature++) {
+      printf(" %3u", best[sign].bytes[feature]);
+    }
+    printf(", margin %d%s\n", margin, margin > 0 ? "" : ", not found, left out");
+    if (margin > 0) {
+      found.push_back(sign);
+    }
+  }
+  if (found.empty()) {
+    fprintf(stderr, "no pose found for any sign\n");
+    return 1;
+  }
+  // a hand at rest: fingers straight, palm level
+  const uint8_t restBytes[kFeatures] = { 20, 20, 20, 20, 20, 127, 127, 127 };
+  memcpy(rest.bytes, restBytes, kFeatures);
+  restSign = std::max_element(scoresOf(rest), scoresOf(rest) + kClasses) - scoresOf(rest);
+
+  std::vector<uint8_t> trace;
+  TraceBuilder builder(trace, random, 5000000);
+  uint64_t windowMicros = (uint64_t)INFERENCE_LENGTH * 1000000 / FUSION_RATE;
+  builder.mark(SENSOR_TRACE_NO_SIGN);
+  builder.run(rest, rest, 0, builder.now + windowMicros + 5000000);
+  Pose previous = rest;
+  for (int sign : found) {
+    builder.mark((uint8_t)sign);
+    builder.run(previous, best[sign], kMovePeriod, builder.now + kMovePeriod + (uint64_t)(holdSeconds * 1e6));
+    previous = best[sign];
+  }
+
+  FILE *file = fopen(outputPath, "wb");
+  if (file == nullptr || fwrite(trace.data(), 1, trace.size(), file) != trace.size() || fclose(file) != 0) {
+    fprintf(stderr, "cannot write %s\n", outputPath);
+    return 1;
+  }
+  printf("%s: %lu of %lu signs, %.0f s after %.0f s at rest (the model calls rest %d), %lu bytes\n", outputPath,
+         (unsigned long)found.size(), (unsigned long)signs.size(), found.size() * (holdSeconds + kMovePeriod / 1e6),
+         (windowMicros + 5000000) / 1e6, restSign, (unsigned long)trace.size());
+  return 0;
+}
@@ -0,0 +1,179 @@
+// Drains a simulated MPU6050 FIFO through the driver's own
+// MPU6050_Base::GetFIFOPackets, built against a register file standing in
+// for I2Cdev with the ESP32 Wire buffer length. Every batch size from one
+// packet to MPU_FIFO_PACKETS has to come back whole, in order and without a
+// FIFO reset, which covers the chunk splits at the buffer length. A failing
+// chunk read has to drop the whole batch and count it. Reads report their
+// byte count as an int8_t, like I2Cdev's. Exits 1 on any mismatch.
+// Run: ./mpu_fifo_check
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include "Arduino.h"
+#include "config.h"
+#include "MPU6050.h"
+
+static const uint8_t kPacketBytes = 28;  // MotionApps 6.12 DMP packet
+static const uint32_t kSamplePeriod = 1000000UL / IMU_SAMPLE_RATE;
+
+static uint32_t simulatedMicros = 1000000;
+static uint8_t registers[256];
+static std::deque<uint8_t> fifo;
+static int failReadsIn = -1;  // FIFO reads until one fails, -1 never
+static uint32_t fifoReads = 0;
+
+uint32_t micros() {
+  return simulatedMicros;
+}
+
+uint16_t I2Cdev::readTimeout = I2CDEV_DEFAULT_READ_TIMEOUT;
+
+int8_t I2Cdev::readBytes(uint8_t, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t, void *) {
+  uint8_t count = 0;
+  if (regAddr == MPU6050_RA_FIFO_R_W) {
+    fifoReads++;
+    if (failReadsIn == 0) {
+      failReadsIn = -1;
+      return -1;
+    }
+    if (failReadsIn > 0) {
+      failReadsIn--;
+    }
+    for (; count < length && !fifo.empty(); count++) {
+      data[count] = fifo.front();
+      fifo.pop_front();
+    }
+    return count;
+  }
+  for (; count < length; count++) {
+    if (regAddr + count == MPU6050_RA_FIFO_COUNTH) {
+      data[count] = fifo.size() >> 8;
+    } else if (regAddr + count == MPU6050_RA_FIFO_COUNTH + 1) {
+      data[count] = fifo.size() & 0xFF;
+    } else {
+      data[count] = registers[(uint8_t)(regAddr + count)];
+    }
+  }
+  return count;
+}
+
+bool I2Cdev::writeBytes(uint8_t, uint8_t regAddr, uint8_t length, uint8_t *data, void *) {
+  for (uint8_t i = 0; i < length; i++) {
+    registers[(uint8_t)(regAddr + i)] = data[i];
+  }
+  if (regAddr == MPU6050_RA_USER_CTRL && (data[0] & (1 << MPU6050_USERCTRL_FIFO_RESET_BIT))) {
+    fifo.clear();
+    registers[MPU6050_RA_USER_CTRL] &= ~(1 << MPU6050_USERCTRL_FIFO_RESET_BIT);
+  }
+  return true;
+}
+
+int8_t I2Cdev::readByte(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint16_t timeout, void *wireObj) {
+  return readBytes(devAddr, regAddr, 1, data, timeout, wireObj);
+}
+
+int8_t I2Cdev::readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *data, uint16_t timeout, void *wireObj) {
+  uint8_t b = 0;
+  int8_t count = readByte(devAddr, regAddr, &b, timeout, wireObj);
+  *data = b & (1 << bitNum);
+  return count;
+}
+
+int8_t I2Cdev::readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t *data, uint16_t timeout, void *wireObj) {
+  uint8_t b = 0;
+  int8_t count = readByte(devAddr, regAddr, &b, timeout, wireObj);
+  *data = (b >> (bitStart - length + 1)) & ((1 << length) - 1);
+  return count;
+}
+
+int8_t I2Cdev::readWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16_t *data, uint16_t timeout, void *wireObj) {
+  for (uint8_t i = 0; i < length; i++) {
+    uint8_t b[2];
+    readBytes(devAddr, regAddr + i * 2, 2, b, timeout, wireObj);
+    data[i] = (b[0] << 8) | b[1];
+  }
+  return length;
+}
+
+bool I2Cdev::writeByte(uint8_t devAddr, uint8_t regAddr, uint8_t data, void *wireObj) {
+  return writeBytes(devAddr, regAddr, 1, &data, wireObj);
+}
+
+bool I2Cdev::writeBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t data, void *wireObj) {
+  uint8_t b = registers[regAddr];
+  b = data != 0 ? (b | (1 << bitNum)) : (b & ~(1 << bitNum));
+  return writeByte(devAddr, regAddr, b, wireObj);
+}
+
+bool I2Cdev::writeBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t data, void *wireObj) {
+  uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
+  uint8_t b = (registers[regAddr] & ~mask) | ((data << (bitStart - length + 1)) & mask);
+  return writeByte(devAddr, regAddr, b, wireObj);
+}
+
+bool I2Cdev::writeWord(uint8_t devAddr, uint8_t regAddr, uint16_t data, void *wireObj) {
+  return writeWords(devAddr, regAddr, 1, &data, wireObj);
+}
+
+bool I2Cdev::writeWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16_t *data, void *wireObj) {
+  for (uint8_t i = 0; i < length; i++) {
+    uint8_t b[2] = {(uint8_t)(data[i] >> 8), (uint8_t)data[i]};
+    writeBytes(devAddr, regAddr + i * 2, 2, b, wireObj);
+  }
+  return true;
+}
+
+static uint8_t packetByte(uint32_t packet, uint8_t offset) {
+  return (uint8_t)(packet * 31 + offset * 7 + 1);
+}
+
+static void pushPackets(uint32_t first, uint16_t count) {
+  for (uint32_t packet = first; packet < first + count; packet++) {
+    for (uint8_t offset = 0; offset < kPacketBytes; offset++) {
+      fifo.push_back(packetByte(packet, offset));
+    }
+  }
+}
+
+int main() {
+  MPU6050_Base mpu;
+  uint8_t data[MPU_FIFO_PACKETS * kPacketBytes];
+  uint32_t timestamps[MPU_FIFO_PACKETS];
+  uint32_t next = 0;
+  int failures = 0;
+
+  printf("chunk %d bytes, %d byte packets\n", MPU6050_FIFO_CHUNK_SIZE, kPacketBytes);
+  for (uint16_t batch = 1; batch <= MPU_FIFO_PACKETS; batch++) {
+    pushPackets(next, batch);
+    simulatedMicros += batch * kSamplePeriod;
+    fifoReads = 0;
+    uint16_t got = mpu.GetFIFOPackets(data, kPacketBytes, MPU_FIFO_PACKETS, kSamplePeriod, timestamps);
+    bool same = got == batch;
+    for (uint16_t packet = 0; same && packet < got; packet++) {
+      for (uint8_t offset = 0; offset < kPacketBytes; offset++) {
+        same = same && data[packet * kPacketBytes + offset] == packetByte(next + packet, offset);
+      }
+      same = same && timestamps[packet] == simulatedMicros - (uint32_t)(batch - 1 - packet) * kSamplePeriod;
+    }
+    if (!same || !fifo.empty() || mpu.getFIFODroppedPackets() != 0) {
+      printf("FAIL %2u packets: %u read in %u chunks, %u dropped\n", batch, got, fifoReads,
+             (unsigned)mpu.getFIFODroppedPackets());
+      failures++;
+    }
+    next += batch;
+  }
+
+  // the second chunk of a five packet batch fails, all five are lost
+  pushPackets(next, 5);
+  simulatedMicros += 5 * kSamplePeriod;
+  failReadsIn = 1;
+  uint16_t got = mpu.GetFIFOPackets(data, kPacketBytes, MPU_FIFO_PACKETS, kSamplePeriod, timestamps);
+  if (got != 0 || !fifo.empty() || mpu.getFIFODroppedPackets() != 5) {
+    printf("FAIL failed chunk: %u read, %u dropped\n", got, (unsigned)mpu.getFIFODroppedPackets());
+    failures++;
+  }
+
+  printf("%s\n", failures == 0 ? "ok" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,369 @@
+// Replays a sensor trace (sensorTrace.h) through the glove's pipeline on the
+// host, faster than real time and the same way on every run. The finger
+// filters, fusion, inference window, handoff, model and the BLE send rule are
+// the firmware's own code (signPipeline.h, aiTest.h with config.h's flags);
+// around them a discrete event loop stands in for FreeRTOS and the sensors:
+//   finger task  every ADC record, at its timestamp
+//   IMU task     DMP records collect in a simulated FIFO that is drained on
+//                the watermark or IMU_INTERRUPT_TIMEOUT, packets stamped
+//                like accelSensor does
+//   parser       every 1ms tick, like its vTaskDelay(1)
+//   inference    woken by the parser, busy for --infer-us per window. The
+//                model runs instantly on the host, the cost is the glove's:
+//                take it from a USE_PROFILING dump, the default is a guess.
+//   BLE          every tfWrite is logged at the time inference finished
+// Reports the signs sent, for each MARK'd sign whether and how fast it came
+// out over BLE and how many other signs were sent while it was held, and
+// every place a sample was dropped, held or overwritten.
+// --strict exits 1 when a marked sign is never sent or a sample is dropped,
+// for using a trace as a regression test. Exits 1 on a damaged trace.
+// Run: ./pipeline_sim trace.bin [--infer-us N] [--fifo-packets N] [--log] [--strict]
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "Arduino.h"
+#include "config.h"
+#include "types.h"
+#include "fingers.h"
+#include "quatQuantize.h"
+#include "sensorTrace.h"
+#include "signPipeline.h"
+#include "aiTest.h"
+
+static const uint32_t kTickMicros = 1000;  // CONFIG_FREERTOS_HZ is 1000
+static const uint64_t kNever = UINT64_MAX;
+
+static uint32_t simulatedMicros = 0;
+
+uint32_t micros() {
+  return simulatedMicros;
+}
+
+// The glove's globals, as main.cpp has them with USE_TFLITE
+static AiModel aiInstance;
+static InferenceWindow inferenceWindow;
+static uint8_t windowBuffers[HANDOFF_BUFFERS][INFERENCE_LENGTH * INFERENCE_FEATURES];
+static InferenceHandoff inferenceHandoff;
+#ifdef FUSION_INTERPOLATE
+static SensorFusion sensorFusion(FUSION_RATE, FUSION_DELAY_US, true);
+#else
+static SensorFusion sensorFusion(FUSION_RATE, FUSION_DELAY_US, false);
+#endif
+static SpscRing<quaternion_t, IMU_QUEUE_LENGTH> imuInferenceData;
+static SpscRing<handData_t, HAND_QUEUE_LENGTH> fingerInferenceData;
+static FingerInstance<FINGER_FILTER> fingers[FINGER_COUNT];
+
+struct Notification {
+  uint64_t time;
+  Result_t result;
+};
+
+struct Mark {
+  uint64_t time;
+  uint8_t sign;
+};
+
+// The IMU task and the ICM's FIFO in front of it
+class SimulatedImu {
+private:
+  std::vector<rawQuaternion_t> fifo;
+  uint32_t watermarkPackets;
+  uint32_t drainPackets = ICM_FIFO_BUFFER / ICM_PACKET_BYTES;
+  uint64_t lastWake = 0;
+  uint32_t lastDrainTime = 0;
+  uint32_t drainTime = 0;
+
+public:
+  uint32_t drains = 0;
+  uint32_t timeouts = 0;
+  uint32_t newestPacket = 0;
+
+  SimulatedImu(uint32_t watermark, uint64_t now) : watermarkPackets(watermark), lastWake(now) {
+  }
+
+  // The DMP wrote a packet, true when that raised the watermark interrupt
+  bool write(const rawQuaternion_t &packet) {
+    fifo.push_back(packet);
+    return fifo.size() >= watermarkPackets;
+  }
+
+  uint64_t timeoutAt() const {
+    return lastWake + (uint64_t)IMU_INTERRUPT_TIMEOUT * 1000;
+  }
+
+  // accelGyroFunc after a wake-up: what fits the burst buffer, spread evenly
+  // between the previous drain and this one
+  void drain(uint64_t now, bool timedOut) {
+    lastWake = now;
+    drains++;
+    timeouts += timedOut ? 1 : 0;
+    uint32_t count = std::min<uint32_t>((uint32_t)fifo.size(), drainPackets);
+    lastDrainTime = drainTime == 0 ? (uint32_t)now : drainTime;
+    drainTime = (uint32_t)now;
+    for (uint32_t index = 0; index < count; index++) {
+      quaternion_t sample;
+      quantizeQuat9(fifo[index].q1, fifo[index].q2, fifo[index].q3, sample);
+      sample.timestamp = lastDrainTime + (uint32_t)((uint64_t)(drainTime - lastDrainTime) * (index + 1) / count);
+      imuInferenceData.push(sample);
+      newestPacket = sample.timestamp;
+    }
+    fifo.erase(fifo.begin(), fifo.begin() + count);
+  }
+};
+
+static bool readFile(const char *path, std::vector<uint8_t> &data) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  uint8_t chunk[65536];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    data.insert(data.end(), chunk, chunk + read);
+  }
+  fclose(file);
+  return true;
+}
+
+static const char *signName(uint8_t sign, char *buffer) {
+  if (sign == SENSOR_TRACE_NO_SIGN) {
+    return "rest";
+  }
+  snprintf(buffer, 8, "%u", sign);
+  return buffer;
+}
+
+int main(int argc, char **argv) {
+  const char *tracePath = nullptr;
+  uint32_t inferMicros = 100000;
+  // the DMP interrupts once the FIFO count is past the watermark
+  uint32_t fifoPackets = ICM_FIFO_WATERMARK / ICM_PACKET_BYTES + 1;
+  bool log = false;
+  bool strict = false;
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "--infer-us") == 0 && arg + 1 < argc) {
+      inferMicros = (uint32_t)strtoul(argv[++arg], nullptr, 10);
+    } else if (strcmp(argv[arg], "--fifo-packets") == 0 && arg + 1 < argc) {
+      fifoPackets = std::max(1UL, strtoul(argv[++arg], nullptr, 10));
+    } else if (strcmp(argv[arg], "--log") == 0) {
+      log = true;
+    } else if (strcmp(argv[arg], "--strict") == 0) {
+      strict = true;
+    } else if (tracePath == nullptr && argv[arg][0] != '-') {
+      tracePath = argv[arg];
+    } else {
+      tracePath = nullptr;
+      break;
+    }
+  }
+  if (tracePath == nullptr) {
+    fprintf(stderr, "usage: %s trace.bin [--infer-us N] [--fifo-packets N] [--log] [--strict]\n", argv[0]);
+    return 2;
+  }
+  std::vector<uint8_t> trace;
+  SensorTraceReader reader;
+  if (!readFile(tracePath, trace) || !reader.begin(trace.data(), trace.size())) {
+    fprintf(stderr, "%s is not a version %d sensor trace\n", tracePath, SENSOR_TRACE_VERSION);
+    return 1;
+  }
+  std::vector<SensorTraceRecord_t> records;
+  SensorTraceRecord_t record;
+  while (reader.next(record)) {
+    records.push_back(record);
+  }
+  if (!reader.atEnd()) {
+    fprintf(stderr, "%s is damaged after %lu records\n", tracePath, (unsigned long)records.size());
+    return 1;
+  }
+  if (records.empty()) {
+    fprintf(stderr, "%s has no records\n", tracePath);
+    return 1;
+  }
+
+  aiInstance.begin();
+  inferenceHandoff.begin(windowBuffers[0], windowBuffers[1]);
+  FingerInstance<FINGER_FILTER> *const fingerInstances[FINGER_COUNT] = { &fingers[0], &fingers[1], &fingers[2],
+                                                                         &fingers[3], &fingers[4] };
+  // the trace's micros() carried on past any wrap, so events order on 64 bits
+  uint64_t start = records[0].timestamp;
+  uint64_t clock = start;
+  std::vector<uint64_t> recordTimes(records.size());
+  for (size_t index = 0; index < records.size(); index++) {
+    clock += index == 0 ? 0 : (uint32_t)(records[index].timestamp - records[index - 1].timestamp);
+    recordTimes[index] = clock;
+  }
+  uint64_t end = recordTimes.back();
+  SimulatedImu imu(fifoPackets, start);
+
+  std::vector<Notification> notifications;
+  std::vector<Mark> marks;
+  uint64_t nextTick = (start / kTickMicros + 1) * kTickMicros;
+  uint64_t inferenceDone = kNever;
+  bool inferenceBusy = false;
+  Result_t pending = {};
+  uint8_t lastSent = NO_SIGN_SENT;
+  uint32_t windowsPublished = 0, windowsInferred = 0, handFrames = 0, imuPackets = 0;
+  uint32_t rowsChecked = 0, imuHeld = 0, handHeld = 0;
+  uint32_t lastTick = 0;
+  uint32_t newestFrame = 0;
+  size_t next = 0;
+
+  auto startInference = [&](uint64_t now) {
+    inferenceBusy = inferStep(inferenceHandoff, aiInstance, pending);
+    if (inferenceBusy) {
+      windowsInferred++;
+      inferenceDone = now + inferMicros;
+    }
+  };
+
+  // aiInferenceFunc finishing a window, then straight on to a newer one
+  auto finishInference = [&](uint64_t now, bool takeNext) {
+    if (shouldSend(pending, lastSent)) {
+      notifications.push_back({ now, pending });
+    }
+    inferenceBusy = false;
+    if (takeNext) {
+      startInference(now);
+    }
+  };
+
+  auto wallStart = std::chrono::steady_clock::now();
+  for (;;) {
+    uint64_t recordAt = next < records.size() ? recordTimes[next] : kNever;
+    uint64_t timeoutAt = imu.timeoutAt();
+    uint64_t now = std::min({ recordAt, timeoutAt, nextTick, inferenceBusy ? inferenceDone : kNever });
+    if (now > end) {
+      // past the trace only the window being inferred on finishes
+      if (inferenceBusy) {
+        simulatedMicros = (uint32_t)inferenceDone;
+        finishInference(inferenceDone, false);
+      }
+      break;
+    }
+    simulatedMicros = (uint32_t)now;
+
+    if (now == recordAt) {
+      const SensorTraceRecord_t &current = records[next++];
+      if (current.kind == SENSOR_TRACE_ADC) {
+        handData_t frame = fingerFrame(fingerInstances, current.adc, simulatedMicros);
+        fingerInferenceData.push(frame);
+        newestFrame = frame.timestamp;
+        handFrames++;
+      } else if (current.kind == SENSOR_TRACE_DMP) {
+        rawQuaternion_t packet = { current.quat[0], current.quat[1], current.quat[2], simulatedMicros };
+        imuPackets++;
+        if (imu.write(packet)) {
+          imu.drain(now, false);
+        }
+      } else if (current.kind == SENSOR_TRACE_MARK) {
+        marks.push_back({ now, current.sign });
+      }
+    } else if (now == timeoutAt) {
+      imu.drain(now, true);
+    } else if (now == nextTick) {
+      nextTick += kTickMicros;
+      if (parseStep(imuInferenceData, fingerInferenceData, sensorFusion, inferenceWindow, inferenceHandoff,
+                    simulatedMicros)) {
+        windowsPublished++;
+        if (!inferenceBusy) {
+          startInference(now);
+        }
+      }
+      // a row past the newest sample of a stream holds that sample instead of interpolating
+      if (sensorFusion.tickTime() != lastTick) {
+        lastTick = sensorFusion.tickTime();
+        rowsChecked++;
+        imuHeld += elapsedMicros(imu.newestPacket, lastTick) > 0 ? 1 : 0;
+        handHeld += elapsedMicros(newestFrame, lastTick) > 0 ? 1 : 0;
+      }
+    } else {
+      finishInference(now, true);
+    }
+  }
+  double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  double simulatedSeconds = (end - start) / 1e6;
+
+  char nameBuffer[2][8];
+  if (log) {
+    printf("time_s,sign,confidence\n");
+    for (const Notification &sent : notifications) {
+      printf("%.3f,%u,%u\n", (sent.time - start) / 1e6, sent.result.result, sent.result.confidence);
+    }
+  }
+  printf("trace: %s, %.1f s, %u finger frames, %u DMP packets, %lu marks\n", tracePath, simulatedSeconds, handFrames,
+         imuPackets, (unsigned long)marks.size());
+  printf("simulated %.1f s in %.2f s of wall time, %.0fx real time\n", simulatedSeconds, wallSeconds,
+         simulatedSeconds / std::max(wallSeconds, 1e-9));
+  printf("inference: %u windows published, %u run at %u us each, %u overwritten before they ran\n", windowsPublished,
+         windowsInferred, inferMicros, inferenceHandoff.coalesced());
+  printf("ble: %lu sign notifications\n", (unsigned long)notifications.size());
+
+  // per marked sign: when BLE first showed it, from the mark to the next one
+  uint32_t marked = 0, recognized = 0;
+  std::vector<double> latencies;
+  if (!marks.empty()) {
+    printf("%-6s %10s %10s %12s %12s\n", "sign", "start_s", "length_s", "latency_ms", "other_signs");
+  }
+  for (size_t index = 0; index < marks.size(); index++) {
+    const Mark &mark = marks[index];
+    if (mark.sign == SENSOR_TRACE_NO_SIGN) {
+      continue;
+    }
+    uint64_t until = index + 1 < marks.size() ? marks[index + 1].time : end;
+    marked++;
+    // the sign the phone shows is the last one sent
+    uint8_t showing = NO_SIGN_SENT;
+    uint64_t seenAt = kNever;
+    uint32_t others = 0;
+    for (const Notification &sent : notifications) {
+      if (sent.time <= mark.time) {
+        showing = sent.result.result;
+        continue;
+      }
+      if (sent.time >= until) {
+        break;
+      }
+      if (sent.result.result == mark.sign) {
+        seenAt = seenAt == kNever ? sent.time : seenAt;
+      } else {
+        others++;
+      }
+    }
+    if (showing == mark.sign) {
+      seenAt = mark.time;
+    }
+    if (seenAt != kNever) {
+      recognized++;
+      latencies.push_back((seenAt - mark.time) / 1e3);
+      printf("%-6s %10.1f %10.1f %12.0f %12u\n", signName(mark.sign, nameBuffer[0]), (mark.time - start) / 1e6,
+             (until - mark.time) / 1e6, latencies.back(), others);
+    } else {
+      printf("%-6s %10.1f %10.1f %12s %12u\n", signName(mark.sign, nameBuffer[0]), (mark.time - start) / 1e6,
+             (until - mark.time) / 1e6, "missed", others);
+    }
+  }
+  if (marked > 0) {
+    printf("recognized: %u of %u marked signs", recognized, marked);
+    if (!latencies.empty()) {
+      std::sort(latencies.begin(), latencies.end());
+      printf(", latency p50 %.0f ms, max %.0f ms", latencies[latencies.size() / 2], latencies.back());
+    }
+    printf("\n");
+  }
+
+  uint32_t dropped = fingerInferenceData.overflowed() + imuInferenceData.overflowed();
+  printf("dropped: %u finger frames and %u IMU samples at full rings, %u fusion ticks skipped\n",
+         fingerInferenceData.overflowed(), imuInferenceData.overflowed(), sensorFusion.skipped());
+  printf("imu: %u FIFO drains, %u on the timeout\n", imu.drains, imu.timeouts);
+  printf("held: %u of %u fused rows past the newest IMU sample, %u past the newest finger frame\n", imuHeld,
+         rowsChecked, handHeld);
+  if (strict && (dropped > 0 || sensorFusion.skipped() > 0 || recognized < marked)) {
+    printf("strict: FAILED\n");
+    return 1;
+  }
+  return 0;
+}
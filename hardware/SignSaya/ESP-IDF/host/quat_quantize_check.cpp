@@ -0,0 +1,88 @@
+// Checks the integer quaternion quantization in quatQuantize.h against the
+// double precision code accelSensor::getData used before it.
+// x, y, z (and the MPU's w) are compared over every Q30 value from -1 to 1,
+// the ICM's derived w over random and edge case x, y, z triples.
+// Run: ./quat_quantize_check [triples]
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "quatQuantize.h"
+
+static uint8_t quantizeDouble(int32_t q) {
+  double value = ((double)q) / 1073741824.0;
+  return (uint8_t)((value + 1.0f) * 127.5f);
+}
+
+static uint8_t wDouble(int32_t x, int32_t y, int32_t z) {
+  double q1 = ((double)x) / 1073741824.0;
+  double q2 = ((double)y) / 1073741824.0;
+  double q3 = ((double)z) / 1073741824.0;
+  double q0 = sqrt(1.0 - ((q1 * q1) + (q2 * q2) + (q3 * q3)));
+  return (uint8_t)((q0 + 1.0f) * 127.5f);
+}
+
+static bool checkTriple(int32_t x, int32_t y, int32_t z, uint64_t &mismatches) {
+  // only unit quaternions are valid, sqrt of a negative is NaN in the double path
+  uint64_t sum = (uint64_t)((int64_t)x * x) + (uint64_t)((int64_t)y * y) + (uint64_t)((int64_t)z * z);
+  if (sum > ((uint64_t)1 << 60)) {
+    return false;
+  }
+  if (quantizeQuaternionW(x, y, z) != wDouble(x, y, z)) {
+    mismatches++;
+    if (mismatches <= 5) {
+      printf("  w mismatch x=%ld y=%ld z=%ld fixed=%u double=%u\n", (long)x, (long)y, (long)z,
+             quantizeQuaternionW(x, y, z), wDouble(x, y, z));
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  long triples = argc > 1 ? atol(argv[1]) : 10000000;
+
+  uint64_t componentMismatches = 0;
+  for (int64_t q = -Q30_ONE; q <= Q30_ONE; q++) {
+    if (quantizeQ30((int32_t)q) != quantizeDouble((int32_t)q)) {
+      componentMismatches++;
+    }
+  }
+  printf("components: %llu values, %llu mismatches\n", (unsigned long long)(2 * (uint64_t)Q30_ONE + 1),
+         (unsigned long long)componentMismatches);
+
+  uint64_t wMismatches = 0;
+  uint64_t checked = 0;
+  const int32_t edges[] = { 0, 1, -1, Q30_ONE, -Q30_ONE, Q30_ONE - 1, -Q30_ONE + 1, Q30_ONE / 2, 759250125, -759250125 };
+  for (int32_t x : edges) {
+    for (int32_t y : edges) {
+      for (int32_t z : edges) {
+        checked += checkTriple(x, y, z, wMismatches);
+      }
+    }
+  }
+
+  // near rest x, y and z are tiny and the double rounding decides w = 255
+  for (int32_t x = -4096; x <= 4096; x++) {
+    for (int32_t y = 0; y <= 16; y++) {
+      checked += checkTriple(x, y, 0, wMismatches);
+    }
+  }
+
+  std::mt19937_64 random(20948);
+  std::uniform_int_distribution<int32_t> any(-Q30_ONE, Q30_ONE);
+  std::uniform_int_distribution<int32_t> small(-(1 << 20), 1 << 20);
+  for (long i = 0; i < triples; i++) {
+    int32_t x = any(random);
+    int32_t y = any(random);
+    int32_t z = any(random);
+    // half of the samples near the rest pose, where the real data sits
+    if (i & 1) {
+      y = small(random);
+      z = small(random);
+    }
+    checked += checkTriple(x, y, z, wMismatches);
+  }
+  printf("w: %llu triples, %llu mismatches\n", (unsigned long long)checked, (unsigned long long)wMismatches);
+
+  return (componentMismatches == 0 && wMismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Host stand-in for the bits of the Arduino core the pipeline headers and the
+// MPU6050 driver use, for host/pipeline_sim and host/mpu_fifo_check. micros()
+// is the simulated clock, not the wall clock, and there are no pins: samples
+// come from the trace being replayed. Serial output goes nowhere.
+
+using std::max;
+using std::min;
+
+#define INPUT 0x01
+#define EXT_RAM_BSS_ATTR
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+
+uint32_t micros();  // defined by the simulator
+
+inline void delay(uint32_t) {
+}
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+struct HostSerial {
+  template <typename... Args>
+  void print(Args...) {
+  }
+  template <typename... Args>
+  void println(Args...) {
+  }
+  template <typename... Args>
+  void write(Args...) {
+  }
+};
+inline HostSerial Serial;
+
+inline void pinMode(uint8_t, uint8_t) {
+}
+
+inline uint16_t analogRead(uint8_t) {
+  return 0;
+}
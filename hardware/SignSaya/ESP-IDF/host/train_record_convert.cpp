@@ -0,0 +1,366 @@
+// Converts USE_TRAIN_RECORDER captures (trainRecord.h blocks) to the Training
+// Data Gatherer CSV or a NumPy .npy array. The input is a /TRN*.BIN file off
+// the ffat partition or a raw dump of the whole partition
+// (esptool.py read_flash 0x610000 0x9E0000 ffat.bin): blocks are found by
+// their magic and CRC wherever they sit, so a dump works without mounting it.
+// Blocks are ordered by session and sequence, damaged blocks are skipped and
+// missing ones reported. Each finger frame becomes a row with the newest IMU
+// sample at or before it, columns timestamp, thumb, index, middle, ring,
+// pinky, quaternionX, quaternionY, quaternionZ, quaternionW like fix.py
+// writes them; the timestamp is in seconds in the CSV and microseconds in
+// the .npy (uint32 columns). With USE_SENSOR_TRACE the capture also has the
+// raw samples, --trace writes those as a sensor trace (sensorTrace.h) for
+// host/pipeline_sim, with a MARK for each "seconds,sign" line of --marks
+// (seconds from the first raw sample, sign -1 for none). Exits 1 when no
+// valid block is found.
+// Run: ./train_record_convert capture.bin [--csv out.csv | --npy out.npy] [--session N]
+//                            [--trace out.trace [--marks labels.csv]]
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include "trainRecord.h"
+#include "sensorTrace.h"
+
+static const int kColumns = 10;
+
+struct Block {
+  TrainBlockHeader_t header;
+  size_t offset;
+};
+
+static bool readFile(const char *path, std::vector<uint8_t> &data) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  uint8_t chunk[65536];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    data.insert(data.end(), chunk, chunk + read);
+  }
+  fclose(file);
+  return true;
+}
+
+// Every valid block, in session and sequence order, a copy found twice (a
+// stale FAT sector) kept once
+static std::vector<Block> findBlocks(const std::vector<uint8_t> &data, size_t *damaged) {
+  std::vector<Block> blocks;
+  *damaged = 0;
+  const uint8_t magic[4] = {(uint8_t)TRAIN_RECORD_MAGIC, (uint8_t)(TRAIN_RECORD_MAGIC >> 8),
+                            (uint8_t)(TRAIN_RECORD_MAGIC >> 16), (uint8_t)(TRAIN_RECORD_MAGIC >> 24)};
+  size_t offset = 0;
+  while (offset + TRAIN_BLOCK_HEADER_BYTES <= data.size()) {
+    const uint8_t *found = (const uint8_t *)memmem(&data[offset], data.size() - offset, magic, sizeof(magic));
+    if (found == nullptr) {
+      break;
+    }
+    offset = found - data.data();
+    Block block;
+    if (readTrainBlock(found, data.size() - offset, block.header)) {
+      block.offset = offset;
+      blocks.push_back(block);
+      offset += TRAIN_BLOCK_HEADER_BYTES + block.header.payloadBytes;
+    } else {
+      (*damaged)++;
+      offset++;
+    }
+  }
+  std::stable_sort(blocks.begin(), blocks.end(), [](const Block &a, const Block &b) {
+    return a.header.session != b.header.session ? a.header.session < b.header.session
+                                                : a.header.sequence < b.header.sequence;
+  });
+  blocks.erase(std::unique(blocks.begin(), blocks.end(),
+                           [](const Block &a, const Block &b) {
+                             return a.header.session == b.header.session && a.header.sequence == b.header.sequence;
+                           }),
+               blocks.end());
+  return blocks;
+}
+
+// timestamps are micros() and wrap after 71 minutes, keep them increasing
+static uint64_t unwrap(uint32_t timestamp, uint64_t &last) {
+  uint64_t value = (last & ~0xffffffffull) | timestamp;
+  if (value + 0x80000000ull < last) {
+    value += 0x100000000ull;
+  }
+  last = value;
+  return value;
+}
+
+static uint32_t timestampOf(const TrainRecord_t &record) {
+  switch (record.kind) {
+    case TRAIN_RECORD_HAND:
+      return record.hand.timestamp;
+    case TRAIN_RECORD_IMU:
+      return record.imu.timestamp;
+    case TRAIN_RECORD_RAW_HAND:
+      return record.rawHand.timestamp;
+    default:
+      return record.rawImu.timestamp;
+  }
+}
+
+struct Row {
+  uint64_t timestamp;
+  uint32_t values[kColumns - 1];
+};
+
+static bool writeCsv(const char *path, const std::vector<Row> &rows) {
+  FILE *file = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+  if (file == nullptr) {
+    return false;
+  }
+  fprintf(file, "timestamp,thumb,index,middle,ring,pinky,quaternionX,quaternionY,quaternionZ,quaternionW\n");
+  for (const Row &row : rows) {
+    fprintf(file, "%.6f", row.timestamp / 1e6);
+    for (int column = 0; column < kColumns - 1; column++) {
+      fprintf(file, ",%u", row.values[column]);
+    }
+    fprintf(file, "\n");
+  }
+  return file == stdout || fclose(file) == 0;
+}
+
+struct Mark {
+  double seconds;
+  uint8_t sign;
+};
+
+static bool readMarks(const char *path, std::vector<Mark> &marks) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+  char line[128];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    double seconds;
+    int sign;
+    if (sscanf(line, "%lf,%d", &seconds, &sign) == 2) {
+      marks.push_back({std::max(0.0, seconds), sign < 0 ? (uint8_t)SENSOR_TRACE_NO_SIGN : (uint8_t)sign});
+    }
+  }
+  fclose(file);
+  std::stable_sort(marks.begin(), marks.end(), [](const Mark &a, const Mark &b) { return a.seconds < b.seconds; });
+  return true;
+}
+
+// The raw records in time order with the marks between them, returns the samples written
+static size_t writeTrace(const char *path, const std::vector<TrainRecord_t> &records,
+                         const std::vector<std::pair<uint64_t, size_t>> &order, const std::vector<Mark> &marks) {
+  std::vector<uint8_t> trace;
+  SensorTraceWriter writer;
+  uint8_t record[SENSOR_TRACE_MAX_RECORD_BYTES];
+  trace.resize(writer.header(record));
+  memcpy(trace.data(), record, trace.size());
+  size_t samples = 0;
+  size_t nextMark = 0;
+  uint64_t first = 0;
+  for (const std::pair<uint64_t, size_t> &entry : order) {
+    const TrainRecord_t &next = records[entry.second];
+    if (next.kind != TRAIN_RECORD_RAW_HAND && next.kind != TRAIN_RECORD_RAW_IMU) {
+      continue;
+    }
+    if (samples == 0) {
+      first = entry.first;
+    }
+    while (nextMark < marks.size() && first + (uint64_t)(marks[nextMark].seconds * 1e6) <= entry.first) {
+      uint64_t time = first + (uint64_t)(marks[nextMark].seconds * 1e6);
+      size_t length = writer.mark(record, (uint32_t)time, marks[nextMark++].sign);
+      trace.insert(trace.end(), record, record + length);
+    }
+    size_t length = next.kind == TRAIN_RECORD_RAW_HAND
+                        ? writer.adc(record, (uint32_t)entry.first, next.rawHand.raw)
+                        : writer.dmp(record, (uint32_t)entry.first, next.rawImu.q1, next.rawImu.q2, next.rawImu.q3);
+    trace.insert(trace.end(), record, record + length);
+    samples++;
+  }
+  FILE *file = fopen(path, "wb");
+  if (file == nullptr) {
+    return 0;
+  }
+  bool written = fwrite(trace.data(), 1, trace.size(), file) == trace.size();
+  return fclose(file) == 0 && written ? samples : 0;
+}
+
+static bool writeNpy(const char *path, const std::vector<Row> &rows) {
+  FILE *file = fopen(path, "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  char header[128];
+  int length = snprintf(header, sizeof(header), "{'descr': '<u4', 'fortran_order': False, 'shape': (%lu, %d), }",
+                        (unsigned long)rows.size(), kColumns);
+  // magic, version 1.0 and a header padded so the data starts 64 byte aligned
+  int total = (10 + length + 1 + 63) / 64 * 64;
+  std::string padded(header, length);
+  padded.append(total - 10 - length - 1, ' ');
+  padded += '\n';
+  const uint8_t preamble[8] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0};
+  uint8_t headerLength[2] = {(uint8_t)padded.size(), (uint8_t)(padded.size() >> 8)};
+  fwrite(preamble, 1, sizeof(preamble), file);
+  fwrite(headerLength, 1, sizeof(headerLength), file);
+  fwrite(padded.data(), 1, padded.size(), file);
+  for (const Row &row : rows) {
+    uint8_t out[kColumns * 4];
+    putU32(out, (uint32_t)row.timestamp);
+    for (int column = 0; column < kColumns - 1; column++) {
+      putU32(out + 4 * (column + 1), row.values[column]);
+    }
+    fwrite(out, 1, sizeof(out), file);
+  }
+  return fclose(file) == 0;
+}
+
+int main(int argc, char **argv) {
+  const char *inputPath = nullptr;
+  const char *csvPath = nullptr;
+  const char *npyPath = nullptr;
+  const char *tracePath = nullptr;
+  const char *marksPath = nullptr;
+  long wantedSession = -1;
+  for (int arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "--csv") == 0 && arg + 1 < argc) {
+      csvPath = argv[++arg];
+    } else if (strcmp(argv[arg], "--npy") == 0 && arg + 1 < argc) {
+      npyPath = argv[++arg];
+    } else if (strcmp(argv[arg], "--trace") == 0 && arg + 1 < argc) {
+      tracePath = argv[++arg];
+    } else if (strcmp(argv[arg], "--marks") == 0 && arg + 1 < argc) {
+      marksPath = argv[++arg];
+    } else if (strcmp(argv[arg], "--session") == 0 && arg + 1 < argc) {
+      wantedSession = strtol(argv[++arg], nullptr, 10);
+    } else if (inputPath == nullptr && argv[arg][0] != '-') {
+      inputPath = argv[arg];
+    } else {
+      inputPath = nullptr;
+      break;
+    }
+  }
+  if (inputPath == nullptr) {
+    fprintf(stderr, "usage: %s capture.bin [--csv out.csv | --npy out.npy] [--session N]"
+                    " [--trace out.trace [--marks labels.csv]]\n", argv[0]);
+    return 2;
+  }
+  std::vector<uint8_t> data;
+  if (!readFile(inputPath, data)) {
+    fprintf(stderr, "cannot read %s\n", inputPath);
+    return 1;
+  }
+  size_t damaged;
+  std::vector<Block> blocks = findBlocks(data, &damaged);
+  if (blocks.empty()) {
+    fprintf(stderr, "no recorded blocks in %s\n", inputPath);
+    return 1;
+  }
+  // a dump can hold several sessions, the newest one unless asked otherwise
+  uint16_t session = wantedSession >= 0 ? (uint16_t)wantedSession : blocks.back().header.session;
+
+  size_t blockCount = 0, missingBlocks = 0, badBlocks = 0;
+  uint32_t lost = 0;
+  bool started = false;
+  uint32_t expected = 0;
+  // each stream is in time order, the two only roughly interleaved
+  std::vector<TrainRecord_t> records;
+  std::vector<std::pair<uint64_t, size_t>> order;
+  uint64_t lastTimes[TRAIN_RECORD_RAW_IMU + 1] = {};  // per kind, each is one stream
+  for (const Block &block : blocks) {
+    if (block.header.session != session) {
+      continue;
+    }
+    if (started) {
+      missingBlocks += block.header.sequence - expected;
+    }
+    started = true;
+    expected = block.header.sequence + 1;
+    blockCount++;
+    lost = block.header.lost;
+
+    const uint8_t *payload = &data[block.offset + TRAIN_BLOCK_HEADER_BYTES];
+    size_t remaining = block.header.payloadBytes;
+    size_t first = records.size();
+    TrainRecord_t record;
+    size_t used;
+    while ((used = readTrainRecord(payload, remaining, record)) > 0) {
+      order.push_back({unwrap(timestampOf(record), lastTimes[record.kind]), records.size()});
+      records.push_back(record);
+      payload += used;
+      remaining -= used;
+    }
+    if (remaining != 0 || records.size() - first != block.header.records) {
+      badBlocks++;
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&](const std::pair<uint64_t, size_t> &a,
+                                                   const std::pair<uint64_t, size_t> &b) {
+    // an IMU sample at the same microsecond goes first, it is at or before the frame
+    return a.first != b.first ? a.first < b.first
+                              : records[a.second].kind == TRAIN_RECORD_IMU && records[b.second].kind == TRAIN_RECORD_HAND;
+  });
+
+  std::vector<Row> rows;
+  size_t handRecords = 0, imuRecords = 0, rawRecords = 0;
+  bool haveImu = false;
+  quaternion_t imu = {};
+  for (const std::pair<uint64_t, size_t> &entry : order) {
+    const TrainRecord_t &next = records[entry.second];
+    if (next.kind == TRAIN_RECORD_IMU) {
+      imu = next.imu;
+      haveImu = true;
+      imuRecords++;
+      continue;
+    }
+    if (next.kind != TRAIN_RECORD_HAND) {
+      rawRecords++;
+      continue;
+    }
+    handRecords++;
+    if (!haveImu) {
+      continue;
+    }
+    Row row;
+    row.timestamp = entry.first;
+    const uint32_t values[kColumns - 1] = {next.hand.thumb, next.hand.index, next.hand.middle, next.hand.ring,
+                                           next.hand.pinky, imu.x, imu.y, imu.z, imu.w};
+    memcpy(row.values, values, sizeof(values));
+    rows.push_back(row);
+  }
+  fprintf(stderr,
+          "session %u: %lu blocks (%lu missing, %lu damaged spots skipped, %lu with bad records), %lu finger and %lu "
+          "IMU samples, %lu raw, %u lost on the device, %lu rows\n",
+          session, (unsigned long)blockCount, (unsigned long)missingBlocks, (unsigned long)damaged,
+          (unsigned long)badBlocks, (unsigned long)handRecords, (unsigned long)imuRecords, (unsigned long)rawRecords,
+          lost, (unsigned long)rows.size());
+  if (tracePath != nullptr) {
+    std::vector<Mark> marks;
+    if (marksPath != nullptr && !readMarks(marksPath, marks)) {
+      fprintf(stderr, "cannot read %s\n", marksPath);
+      return 1;
+    }
+    if (rawRecords == 0) {
+      fprintf(stderr, "no raw samples in session %u, record it with USE_SENSOR_TRACE\n", session);
+      return 1;
+    }
+    size_t samples = writeTrace(tracePath, records, order, marks);
+    if (samples == 0) {
+      fprintf(stderr, "cannot write %s\n", tracePath);
+      return 1;
+    }
+    fprintf(stderr, "%lu raw samples and %lu marks to %s\n", (unsigned long)samples, (unsigned long)marks.size(),
+            tracePath);
+  }
+  if (npyPath != nullptr && !writeNpy(npyPath, rows)) {
+    fprintf(stderr, "cannot write %s\n", npyPath);
+    return 1;
+  }
+  if ((csvPath != nullptr || (npyPath == nullptr && tracePath == nullptr)) && !writeCsv(csvPath != nullptr ? csvPath : "-", rows)) {
+    fprintf(stderr, "cannot write %s\n", csvPath);
+    return 1;
+  }
+  return 0;
+}
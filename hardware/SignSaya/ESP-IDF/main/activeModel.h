@@ -0,0 +1,13 @@
+#pragma once
+#include "model.h"
+#ifdef USE_FUSED_MODEL
+#include "modelFused.h"
+#endif
+
+// The flatbuffer the interpreter and arenaPlan.h are built for. The streaming
+// path always reads the original graph, it needs the separate conv weights.
+#ifdef USE_FUSED_MODEL
+#define ACTIVE_MODEL signsaya_model_fused
+#else
+#define ACTIVE_MODEL signsaya_model
+#endif
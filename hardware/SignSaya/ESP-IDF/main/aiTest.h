@@ -16,94 +16,223 @@ limitations under the License.
 
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
 #include "tensorflow/lite/micro/system_setup.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 #include "tensorflow/lite/micro/micro_log.h"
 #include "tensorflow/lite/c/common.h"
+#ifdef ESP_PLATFORM
 #include "esp_nn.h"
+#endif
 // #include "espnn"
 
 // #include "main_functions.h"
-#include "model.h"
+#include "activeModel.h"
+#include "modelHash.h"
+#include "modelOps.h"
+#include "arenaPlan.h"
+#ifdef USE_COMPILED_MODEL
+#if !defined(USE_FUSED_MODEL)
+#error "USE_COMPILED_MODEL is generated from the fused graph, define USE_FUSED_MODEL too"
+#endif
+#include "compiledModel.h"
+#endif
+#ifdef USE_STREAMING_INFERENCE
+#include "streamingModel.h"
+#endif
+#ifdef USE_PROFILING
+#include "opProfiler.h"
+#endif
 // #include "constants.h"
 // #include "output_handler.h"
 
 // Globals, used for compatibility with Arduino-style sketches.
 namespace {
+// int inference_count = 0;
+// EXT_RAM_BSS_ATTR uint8_t[INFERENCE_LENGTH][INFERENCE_FEATURES] arrayWrapper[1];
+#ifdef USE_COMPILED_MODEL
+// Generated by host/compile_model, regenerate compiledModel.h when the model changes
+static_assert(sizeof(ACTIVE_MODEL) == CompiledModel::kSourceBytes, "compiledModel.h is stale, rerun host/compile_model");
+#else
 const tflite::Model* model = nullptr;
 tflite::MicroInterpreter* interpreter = nullptr;
 TfLiteTensor* input = nullptr; 
 TfLiteTensor* output = nullptr;
-// int inference_count = 0;
-// EXT_RAM_BSS_ATTR uint8_t[INFERENCE_LENGTH][INFERENCE_FEATURES] arrayWrapper[1];
-constexpr int kTensorArenaSize =  478624;
+// Sized by host/arena_plan, regenerate arenaPlan.h when the model changes
+static_assert(sizeof(ACTIVE_MODEL) == ARENA_PLAN_MODEL_BYTES, "arenaPlan.h is stale, rerun host/arena_plan");
+#if defined(USE_SRAM_ARENA) && ARENA_PLAN_SRAM_BYTES > 0 && ARENA_PLAN_PSRAM_BYTES > 0
+#define SPLIT_TENSOR_ARENA
+// The buffer classes picked in config.h live in SRAM, everything else in PSRAM
+constexpr int kTensorArenaSize = ARENA_PLAN_PSRAM_BYTES;
+constexpr int kFastTensorArenaSize = ARENA_PLAN_SRAM_BYTES + SRAM_ARENA_ACTIVATION_MAX;
 EXT_RAM_BSS_ATTR uint8_t tensor_arena[kTensorArenaSize];
+alignas(16) uint8_t fast_tensor_arena[kFastTensorArenaSize];
+#else
+constexpr int kTensorArenaSize = ARENA_PLAN_ARENA_SIZE;
+#if ARENA_PLAN_PSRAM_BYTES == 0
+uint8_t tensor_arena[kTensorArenaSize];
+#else
+EXT_RAM_BSS_ATTR uint8_t tensor_arena[kTensorArenaSize];
+#endif
+#endif
+#endif
+#ifdef USE_STREAMING_INFERENCE
+EXT_RAM_BSS_ATTR StreamingModel streamingModel;
+#endif
+#ifdef USE_PROFILING
+OpProfiler opProfiler;
+#endif
 }  // namespace
 
 Result_t inferResult;
 class AiModel{
-public:
+private:
+  Result_t pickResult(const uint8_t *scores, int count) {
+    int maxNumber = 0;
+    int maxIndex = 0;
+    for (int i = 0; i < count; ++i) {
+      int currentValue = scores[i];
+      // MicroPrintf("[%d]: %f", i, confidenceLevel);
+        if(maxNumber < currentValue) {
+          maxNumber = currentValue;
+          maxIndex = i;
+          }
+    }
 
-  // The name of this function is important for Arduino compatibility.
-  void begin() {
+    inferResult.result = maxIndex;
+    inferResult.confidence = maxNumber;
+    return inferResult;
+  }
+
+  bool ready = false;  // infer() has a model to run
+
+  // Sets up ACTIVE_MODEL for infer()
+  bool beginActiveModel() {
     // esp_nn_init();
     // Map the model into a usable data structure. This doesn't involve any
     // copying or parsing, it's a very lightweight operation.
     // MicroPrintf("ESP Free heap: %d", esp_get_free_heap_size());
-    model = tflite::GetModel(signsaya_model);
+#ifdef USE_COMPILED_MODEL
+    // kSourceBytes only catches a model of another size, a retrained one changes the hash
+    if (modelHash(ACTIVE_MODEL, sizeof(ACTIVE_MODEL)) != CompiledModel::kSourceHash) {
+      MicroPrintf("compiledModel.h is stale, rerun host/compile_model");
+      return false;
+    }
+    MicroPrintf("Compiled model: %d byte arena", CompiledModel::kArenaBytes);
+#else
+    model = tflite::GetModel(ACTIVE_MODEL);
     if (model->version() != TFLITE_SCHEMA_VERSION) {
       MicroPrintf("Model provided is schema version %d not equal to supported "
                   "version %d.", model->version(), TFLITE_SCHEMA_VERSION);
-      return;
+      return false;
     }
 
     // Pull in only the operation implementations we need.
-     EXT_RAM_BSS_ATTR static tflite::MicroMutableOpResolver<8> resolver;
-
-    if (resolver.AddReduceMax() != kTfLiteOk) return;
-
-    if (resolver.AddDequantize() != kTfLiteOk) return;
-
-    if (resolver.AddQuantize() != kTfLiteOk) return;
-
-    if (resolver.AddExpandDims() != kTfLiteOk) return;
-
-    if (resolver.AddSoftmax() != kTfLiteOk) return;
-
-    // if (resolver.AddMean() != kTfLiteOk) return;
-
-    if (resolver.AddConv2D()  != kTfLiteOk) return; 
-
-    if (resolver.AddReshape()  != kTfLiteOk) return;
- 
-    if (resolver.AddFullyConnected() != kTfLiteOk) return;
+    // Resolver and interpreter are small and looked at on every invoke, keep them out of PSRAM
+    static ModelOpResolver resolver;
+    if (registerModelOps(resolver) != kTfLiteOk) return false;
 
     // Build an interpreter to run the model with.
-     EXT_RAM_BSS_ATTR static tflite::MicroInterpreter static_interpreter(
-        model, resolver, tensor_arena, kTensorArenaSize);
+#ifdef SPLIT_TENSOR_ARENA
+    tflite::ArenaPlacementPolicy placement;
+#ifdef SRAM_ARENA_SCRATCH
+    placement.scratch = tflite::ArenaTier::kFast;
+#else
+    placement.scratch = tflite::ArenaTier::kMain;
+#endif
+    placement.activations = SRAM_ARENA_ACTIVATION_MAX > 0 ? tflite::ArenaTier::kFast : tflite::ArenaTier::kMain;
+    placement.activation_fast_max_bytes = SRAM_ARENA_ACTIVATION_MAX;
+#ifdef SRAM_ARENA_PERSISTENT
+    placement.persistent = tflite::ArenaTier::kFast;
+#endif
+    tflite::MicroAllocator *allocator = tflite::MicroAllocator::Create(
+        tensor_arena, kTensorArenaSize, fast_tensor_arena, kFastTensorArenaSize, placement);
+#else
+    tflite::MicroAllocator *allocator = tflite::MicroAllocator::Create(tensor_arena, kTensorArenaSize);
+#endif
+#ifdef USE_PROFILING
+    static tflite::MicroInterpreter static_interpreter(
+        model, resolver, allocator, nullptr, &opProfiler);
+#else
+    static tflite::MicroInterpreter static_interpreter(
+        model, resolver, allocator);
+#endif
     interpreter = &static_interpreter;
 
     // Allocate memory from the tensor_arena for the model's tensors.
+#ifdef USE_PROFILING
+    uint32_t allocateStart = micros();
+#endif
     TfLiteStatus allocate_status = interpreter->AllocateTensors();
     if (allocate_status != kTfLiteOk) {
       MicroPrintf("AllocateTensors() failed");
-      return;
+      return false;
     }
+#ifdef USE_PROFILING
+    // host/bench_boot measures the same on the host, with and without an offline plan
+    MicroPrintf("AllocateTensors: %d us, %d bytes of stack left unused", (int)(micros() - allocateStart),
+                (int)uxTaskGetStackHighWaterMark(nullptr));
+#endif
+    MicroPrintf("Arena: %d of %d bytes used", (int)interpreter->arena_used_bytes(), kTensorArenaSize);
+#ifdef SPLIT_TENSOR_ARENA
+    MicroPrintf("SRAM arena: %d of %d bytes used", (int)allocator->fast_used_bytes(), kFastTensorArenaSize);
+#endif
 
     // Obtain pointers to the model's input and output tensors.
     input = interpreter->input(0);
     output = interpreter->output(0);
+#endif
+    return true;
   }
 
+public:
+
   // The name of this function is important for Arduino compatibility.
-  Result_t infer(uint8_t inputArray[INFERENCE_LENGTH * INFERENCE_FEATURES]) {
-    // arrayWrapper[0] = inputArray; 
-    memcpy(input->data.uint8, inputArray, INFERENCE_LENGTH * INFERENCE_FEATURES * sizeof(uint8_t));
-  // Copy data to the input tensor
-    // input->data.uint8[0] = arrayWrapper;
+  void begin() {
+#ifdef USE_FUSED_MODEL
+    // Generated by host/fuse_model, regenerate modelFused.h when model.h changes
+    if (modelHash(signsaya_model, sizeof(signsaya_model)) != MODEL_FUSED_SOURCE_HASH) {
+      MicroPrintf("modelFused.h is stale, rerun host/fuse_model");
+    } else {
+      ready = beginActiveModel();
+    }
+#else
+    ready = beginActiveModel();
+#endif
 
-    // unsigned long startTime = millis();
+#ifdef USE_STREAMING_INFERENCE
+    if (!streamingModel.begin(tflite::GetModel(signsaya_model))) {
+      MicroPrintf("Streaming inference unavailable for this model, using the interpreter");
+    }
+#ifdef USE_PROFILING
+    streamingModel.setProfiler(&opProfiler);
+#endif
+#endif
+  }
+
+#ifdef USE_PROFILING
+  // Per-op latency of every invoke so far, interpreter and streaming path alike
+  OpProfiler &profiler() {
+    return opProfiler;
+  }
+#endif
 
+  // The name of this function is important for Arduino compatibility.
+  // The compiled model reads inputArray in place, the interpreter needs it
+  // copied into its input tensor first.
+  Result_t infer(uint8_t inputArray[INFERENCE_LENGTH * INFERENCE_FEATURES]) {
+    // unsigned long startTime = millis();
+    if (!ready) {
+      return inferResult;
+    }
+#ifdef USE_COMPILED_MODEL
+#ifdef USE_PROFILING
+    return pickResult(CompiledModel::invoke(inputArray, &opProfiler), CompiledModel::kOutputBytes);
+#else
+    return pickResult(CompiledModel::invoke(inputArray), CompiledModel::kOutputBytes);
+#endif
+#else
+    memcpy(input->data.uint8, inputArray, INFERENCE_LENGTH * INFERENCE_FEATURES * sizeof(uint8_t));
     // Run inference, and report any error
     TfLiteStatus invoke_status = interpreter->Invoke();
     if (invoke_status != kTfLiteOk) {
@@ -113,24 +242,18 @@ public:
     }
     // MicroPrintf("Inference Time: %d", millis() - startTime);
 
-    int maxNumber = 0;
-    int maxIndex = 0;
-    for (int i = 0; i < output->bytes; ++i) {
-      // int index = i;
-      // int currentValue = tflite::GetTensorData<uint8_t>(output)[i];
-      //   );
-      int currentValue = output->data.uint8[i];
-      // MicroPrintf("[%d]: %f", i, confidenceLevel);
-        if(maxNumber < currentValue) {
-          maxNumber = currentValue;
-          maxIndex = i;
-          }
-        
-    }
-
-    inferResult.result = maxIndex;
-    inferResult.confidence = maxNumber;
-    return inferResult;
+    return pickResult(output->data.uint8, output->bytes);
+#endif
+  }
 
+#ifdef USE_STREAMING_INFERENCE
+  // Same result as infer(), but only the conv columns of the newRows newest
+  // rows of inputArray are computed, the rest is reused from the last call.
+  Result_t inferStreaming(uint8_t inputArray[INFERENCE_LENGTH * INFERENCE_FEATURES], uint32_t newRows) {
+    if (!streamingModel.isReady()) {
+      return infer(inputArray);
+    }
+    return pickResult(streamingModel.update(inputArray, newRows), StreamingModel::kClasses);
   }
+#endif
 };
\ No newline at end of file
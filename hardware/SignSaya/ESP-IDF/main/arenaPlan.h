@@ -0,0 +1,13 @@
+// Generated by host/arena_plan from ACTIVE_MODEL (activeModel.h), do not edit.
+#pragma once
+
+#define ARENA_PLAN_MODEL_BYTES 4496  // sizeof(ACTIVE_MODEL) this plan was made for
+#define ARENA_PLAN_PERSISTENT_BYTES 1936
+#define ARENA_PLAN_ACTIVATION_BYTES 67024
+#define ARENA_PLAN_SCRATCH_BYTES 0
+#define ARENA_PLAN_KERNEL_SCRATCH_BYTES 56  // esp_nn only, estimated
+#define ARENA_PLAN_MINIMUM_BYTES 68752  // smallest arena the host allocates with
+#define ARENA_PLAN_ARENA_SIZE 70656  // one arena holding everything
+#define ARENA_PLAN_SRAM_BUDGET 163840
+#define ARENA_PLAN_SRAM_BYTES 70656  // recommended internal part, hot scratch
+#define ARENA_PLAN_PSRAM_BYTES 0  // recommended external part, 0 when it all fits in SRAM
@@ -0,0 +1,189 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "types.h"
+
+// Batched raw streaming (USE_BLE_BATCH): fused rows are packed into one
+// notification per frame instead of one notification per sensor sample.
+// A frame, little endian:
+//   byte 0     BLE_FRAME_VERSION
+//   byte 1     sample count
+//   bytes 2-3  sequence number, one more than the frame before, a gap is a lost frame
+//   bytes 4-7  micros() of the first sample
+//   then per sample: 2 bytes of micros since the sample before (0 for the
+//   first) and the 9 Inference_t bytes in declaration order
+// BleFrameReader is the reference decoder for the receiving side.
+
+#define BLE_FRAME_VERSION 1
+#define BLE_FRAME_HEADER_BYTES 8
+#define BLE_FRAME_SAMPLE_BYTES 11
+#define BLE_ATT_HEADER_BYTES 3     // opcode and handle in front of every notification value
+#define BLE_FRAME_MAX_BYTES 514    // notification value at the largest ATT MTU, 517
+#define BLE_FRAME_MAX_SAMPLES ((BLE_FRAME_MAX_BYTES - BLE_FRAME_HEADER_BYTES) / BLE_FRAME_SAMPLE_BYTES)
+
+typedef struct {
+  Inference_t row;
+  uint32_t timestamp;  // micros() of the fusion tick
+} StreamSample_t;
+
+class BleFrameWriter {
+private:
+  uint8_t frame[BLE_FRAME_MAX_BYTES];
+  size_t limit = 20;  // value bytes per notification, the default MTU 23 less the ATT header
+  size_t frameLimit = 20;  // limit when the current frame was started
+  size_t length = 0;
+  uint16_t sequence = 0;
+  uint32_t lastTimestamp = 0;
+
+  void putSample(const Inference_t &row, uint16_t delta) {
+    uint8_t *out = frame + length;
+    out[0] = (uint8_t)delta;
+    out[1] = (uint8_t)(delta >> 8);
+    out[2] = row.pinky;
+    out[3] = row.ring;
+    out[4] = row.middle;
+    out[5] = row.index;
+    out[6] = row.thumb;
+    out[7] = row.w;
+    out[8] = row.x;
+    out[9] = row.y;
+    out[10] = row.z;
+    length += BLE_FRAME_SAMPLE_BYTES;
+    frame[1]++;
+  }
+
+public:
+  // Starts over at firstSequence, e.g. on every new connection
+  void reset(uint16_t firstSequence = 0) {
+    length = 0;
+    sequence = firstSequence;
+  }
+
+  // Value bytes the link takes per notification, the negotiated MTU less
+  // BLE_ATT_HEADER_BYTES. Applies from the next frame.
+  void setLimit(size_t bytes) {
+    if (bytes > BLE_FRAME_MAX_BYTES) {
+      bytes = BLE_FRAME_MAX_BYTES;
+    }
+    limit = bytes < BLE_FRAME_HEADER_BYTES + BLE_FRAME_SAMPLE_BYTES ? BLE_FRAME_HEADER_BYTES + BLE_FRAME_SAMPLE_BYTES : bytes;
+  }
+
+  // Appends one row, false when it does not fit: the frame is full or the
+  // gap since the last row is over 65535us. Send the frame, clear() and
+  // push again.
+  bool push(const Inference_t &row, uint32_t timestamp) {
+    if (length == 0) {
+      frame[0] = BLE_FRAME_VERSION;
+      frame[1] = 0;
+      frame[2] = (uint8_t)sequence;
+      frame[3] = (uint8_t)(sequence >> 8);
+      frame[4] = (uint8_t)timestamp;
+      frame[5] = (uint8_t)(timestamp >> 8);
+      frame[6] = (uint8_t)(timestamp >> 16);
+      frame[7] = (uint8_t)(timestamp >> 24);
+      length = BLE_FRAME_HEADER_BYTES;
+      frameLimit = limit;
+      putSample(row, 0);
+    } else {
+      uint32_t delta = timestamp - lastTimestamp;
+      if (isFull() || delta > 0xffff) {
+        return false;
+      }
+      putSample(row, (uint16_t)delta);
+    }
+    lastTimestamp = timestamp;
+    return true;
+  }
+
+  // No room for another row, send it now rather than on the next push
+  bool isFull() const {
+    return length > 0 && length + BLE_FRAME_SAMPLE_BYTES > frameLimit;
+  }
+
+  bool isEmpty() const {
+    return length == 0;
+  }
+
+  // micros() of the oldest row waiting, for flushing on a deadline
+  uint32_t firstTimestamp() const {
+    return (uint32_t)frame[4] | (uint32_t)frame[5] << 8 | (uint32_t)frame[6] << 16 | (uint32_t)frame[7] << 24;
+  }
+
+  const uint8_t *data() const {
+    return frame;
+  }
+
+  size_t size() const {
+    return length;
+  }
+
+  // Call once the frame is sent, the next one takes the next sequence number
+  void clear() {
+    if (length > 0) {
+      length = 0;
+      sequence++;
+    }
+  }
+};
+
+class BleFrameReader {
+private:
+  uint16_t expected = 0;
+  bool started = false;
+  uint32_t lostFrames = 0;
+  uint32_t frameCount = 0;
+
+public:
+  void reset() {
+    started = false;
+    lostFrames = 0;
+    frameCount = 0;
+  }
+
+  // Decodes one notification value into samples, returns how many or -1
+  // when it is not a frame this reader understands or samples is too small
+  int decode(const uint8_t *frame, size_t length, StreamSample_t *samples, size_t capacity) {
+    if (length < BLE_FRAME_HEADER_BYTES || frame[0] != BLE_FRAME_VERSION) {
+      return -1;
+    }
+    size_t count = frame[1];
+    if (count == 0 || count > capacity || length != BLE_FRAME_HEADER_BYTES + count * BLE_FRAME_SAMPLE_BYTES) {
+      return -1;
+    }
+    uint16_t sequence = (uint16_t)(frame[2] | frame[3] << 8);
+    if (started) {
+      // the 16 bit difference survives the sequence wrapping
+      lostFrames += (uint16_t)(sequence - expected);
+    }
+    started = true;
+    expected = sequence + 1;
+    frameCount++;
+
+    uint32_t timestamp = (uint32_t)frame[4] | (uint32_t)frame[5] << 8 | (uint32_t)frame[6] << 16 | (uint32_t)frame[7] << 24;
+    const uint8_t *in = frame + BLE_FRAME_HEADER_BYTES;
+    for (size_t index = 0; index < count; index++, in += BLE_FRAME_SAMPLE_BYTES) {
+      timestamp += (uint32_t)(in[0] | in[1] << 8);
+      StreamSample_t &sample = samples[index];
+      sample.timestamp = timestamp;
+      sample.row.pinky = in[2];
+      sample.row.ring = in[3];
+      sample.row.middle = in[4];
+      sample.row.index = in[5];
+      sample.row.thumb = in[6];
+      sample.row.w = in[7];
+      sample.row.x = in[8];
+      sample.row.y = in[9];
+      sample.row.z = in[10];
+    }
+    return (int)count;
+  }
+
+  // Frames missing between the ones decoded so far
+  uint32_t lost() const {
+    return lostFrames;
+  }
+
+  uint32_t frames() const {
+    return frameCount;
+  }
+};
@@ -5,33 +5,47 @@
 #include <BLEServer.h>
 #include <BLEUtils.h>
 #include <BLE2902.h>
+#if !defined(USE_TFLITE) && defined(USE_BLE_BATCH)
+#include "bleFrame.h"
+#endif
 
 
 BLEServer* pServer = NULL;
 #ifdef USE_TFLITE
 BLECharacteristic* tfLane;
+#ifdef USE_PROFILING
+BLECharacteristic* profileLane;
+#endif
+#elif defined(USE_BLE_BATCH)
+BLECharacteristic* streamLane;
 #else
 BLECharacteristic* fingerLane;
 BLECharacteristic* imuLane;
 #endif
 bool deviceConnected = false;
 bool oldDeviceConnected = false;
+uint16_t peerMTU = 23;  // ATT MTU of the connection, 23 until the central asks for more
 
 // UUID of Nordic UART Service (NUS)
 #define SERVICE_UUID "6E400001-B5A3-F393-E0A9-E50E24DCCA9E"  // UART service UUID
 #define CHARACTERISTIC_UUID_RX "6E400002-B5A3-F393-E0A9-E50E24DCCA9E"
 #define CHARACTERISTIC_UUID_TX "6E400003-B5A3-F393-E0A9-E50E24DCCA9E"
 #ifndef USE_TFLITE
+#define STREAM_LANE "5E806A35-62E5-477E-89BC-4DDF8DE86387"
 #define FINGER_LANE "806E5CE2-866C-41C6-8C40-F4D5739A6616"
 #define IMU_LANE "58C7A24D-738A-426D-A849-D3EFDF4C16BB"
 #else
 #define RESULT_LANE "806E5CE2-866C-41C6-8C40-F4D5739A6616"
+#ifdef USE_PROFILING
+#define PROFILE_LANE "29EBE3AC-9A42-486F-BA0B-AD59FE1B5723"
+#endif
 #endif
 // #define REQUEST_LANE "29EBE3AC-9A42-486F-BA0B-AD59FE1B5722"
 
 class MyServerCallbacks : public BLEServerCallbacks {
   void onConnect(BLEServer* pServer) {
     deviceConnected = true;
+    peerMTU = 23;
     digitalWrite(BLUETOOTH_INDICATOR, HIGH);
   };
 
@@ -39,6 +53,10 @@ class MyServerCallbacks : public BLEServerCallbacks {
     digitalWrite(BLUETOOTH_INDICATOR, LOW);
     deviceConnected = false;
   }
+
+  void onMtuChanged(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) {
+    peerMTU = param->mtu.mtu;
+  }
 };
 
 class bleInstance {
@@ -61,8 +79,9 @@ public:
     }
     ESP_ERROR_CHECK(ret);
 
-    //BLEDevice::setMTU(64);
     BLEDevice::init(bleName);
+    // the most the glove accepts, the central picks the MTU when it asks
+    BLEDevice::setMTU(BLE_FRAME_MTU);
 
     // Create the BLE Server
     pServer = BLEDevice::createServer();
@@ -72,7 +91,12 @@ public:
     BLEService* pService = pServer->createService(SERVICE_UUID);
 
     // Create a BLE Characteristic
-    #ifndef USE_TFLITE
+    #if !defined(USE_TFLITE) && defined(USE_BLE_BATCH)
+    streamLane = pService->createCharacteristic(
+      STREAM_LANE,
+      BLECharacteristic::PROPERTY_NOTIFY);
+    streamLane->addDescriptor(new BLE2902());
+    #elif !defined(USE_TFLITE)
     fingerLane = pService->createCharacteristic(
       FINGER_LANE,
       BLECharacteristic::PROPERTY_NOTIFY);
@@ -88,6 +112,12 @@ public:
       RESULT_LANE,
       BLECharacteristic::PROPERTY_NOTIFY);
     tfLane->addDescriptor(new BLE2902());
+    #ifdef USE_PROFILING
+    profileLane = pService->createCharacteristic(
+      PROFILE_LANE,
+      BLECharacteristic::PROPERTY_NOTIFY);
+    profileLane->addDescriptor(new BLE2902());
+    #endif
     #endif
     // Start the service
     pService->start();
@@ -110,6 +140,28 @@ public:
     tfLane->notify();
   }
 
+  #ifdef USE_PROFILING
+  // One CSV line per notification, anything past the negotiated MTU is cut
+  void profileWrite(const char* line) {
+    profileLane->setValue((uint8_t*)line, strlen(line));
+    profileLane->notify();
+  }
+  #endif
+
+  #elif defined(USE_BLE_BATCH)
+
+  // One bleFrame.h frame or gloveCodec.h block per notification, at most frameLimit() bytes
+  void frameWrite(const uint8_t* frame, size_t length) {
+    streamLane->setValue((uint8_t*)frame, length);
+    streamLane->notify();
+  }
+
+  // Bytes one notification carries on this connection
+  size_t frameLimit() {
+    uint16_t mtu = peerMTU < BLE_FRAME_MTU ? peerMTU : BLE_FRAME_MTU;
+    return mtu - BLE_ATT_HEADER_BYTES;
+  }
+
   #else
 
   void fingerWrite(uint8_t* message) {
@@ -0,0 +1,223 @@
+// Generated by host/compile_model from ACTIVE_MODEL (activeModel.h), do not edit.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "fusedConvMax.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h"
+#include "tensorflow/lite/kernels/internal/reference/softmax.h"
+#include "tensorflow/lite/micro/micro_profiler_interface.h"
+#include "tensorflow/lite/micro/micro_profiler.h"
+
+// The model as straight-line kernel calls, no interpreter, resolver or flatbuffer
+class CompiledModel {
+public:
+  static constexpr size_t kSourceBytes = 4496;  // sizeof(ACTIVE_MODEL) it was compiled from
+  static constexpr uint32_t kSourceHash = 0xbe111047u;  // modelHash() of that ACTIVE_MODEL
+  static constexpr int kInputBytes = 66978;
+  static constexpr int kOutputBytes = 14;
+  static constexpr int kArenaBytes = 48;
+
+  // Runs the graph on kInputBytes of input, returns the kOutputBytes output,
+  // valid until the next call. Ops are reported to profiler when given.
+  static const uint8_t *invoke(const uint8_t *input, tflite::MicroProfilerInterface *profiler = nullptr) {
+    {
+      tflite::ScopedMicroProfiler event("SIGNSAYA_CONV_MAX", profiler);
+      FusedConvMax::run(FusedConvMax::FixedDims<7442, 3, 9, 32>(), op0Quantized, 128, input,
+                        op0Weights, op0Bias, op0Multipliers, op0Shifts, 41,
+                        reinterpret_cast<int8_t *>(&arena[0]));
+    }
+    {
+      tflite::ScopedMicroProfiler event("FULLY_CONNECTED", profiler);
+      tflite::FullyConnectedParams params = {};
+      params.input_offset = -41;
+      params.weights_offset = 0;
+      params.output_offset = 45;
+      params.output_multiplier = 1389336997;
+      params.output_shift = -7;
+      params.quantized_activation_min = -128;
+      params.quantized_activation_max = 127;
+      tflite::reference_integer_ops::FullyConnected(
+        params, tflite::RuntimeShape(2, op1InputDims), reinterpret_cast<const int8_t *>(&arena[0]),
+        tflite::RuntimeShape(2, op1FilterDims), op1Weights,
+        tflite::RuntimeShape(1, &op1OutputDims[1]), op1Bias,
+        tflite::RuntimeShape(2, op1OutputDims), reinterpret_cast<int8_t *>(&arena[32]));
+    }
+    {
+      tflite::ScopedMicroProfiler event("SOFTMAX", profiler);
+      tflite::SoftmaxParams params = {};
+      params.input_multiplier = 1212010624;
+      params.input_left_shift = 24;
+      params.diff_min = -124;
+      tflite::reference_ops::Softmax(params, tflite::RuntimeShape(2, op2Dims), reinterpret_cast<const int8_t *>(&arena[32]),
+                                     tflite::RuntimeShape(2, op2Dims), reinterpret_cast<int8_t *>(&arena[16]));
+    }
+    {
+      tflite::ScopedMicroProfiler event("QUANTIZE", profiler);
+      const int8_t *from = reinterpret_cast<const int8_t *>(&arena[16]);
+      uint8_t *to = reinterpret_cast<uint8_t *>(&arena[0]);
+      for (int i = 0; i < 14; i++) {
+        to[i] = op3Table[from[i] + 128];
+      }
+    }
+    return reinterpret_cast<const uint8_t *>(&arena[0]);
+  }
+
+private:
+  static constexpr int8_t op0Quantized[256] = {
+    -128, -127, -126, -125, -124, -123, -122, -121, -120, -119, -118, -117, -116, -115, -114, -113,
+    -112, -111, -110, -109, -108, -107, -106, -105, -104, -103, -102, -101, -100, -99, -98, -97,
+    -96, -95, -94, -93, -92, -91, -90, -89, -88, -87, -86, -85, -84, -83, -82, -81,
+    -80, -79, -78, -77, -76, -75, -74, -73, -72, -71, -70, -69, -68, -67, -66, -65,
+    -64, -63, -62, -61, -60, -59, -58, -57, -56, -55, -54, -53, -52, -51, -50, -49,
+    -48, -47, -46, -45, -44, -43, -42, -41, -40, -39, -38, -37, -36, -35, -34, -33,
+    -32, -31, -30, -29, -28, -27, -26, -25, -24, -23, -22, -21, -20, -19, -18, -17,
+    -16, -15, -14, -13, -12, -11, -10, -9, -8, -7, -6, -5, -4, -3, -2, -1,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+    32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+    48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63,
+    64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79,
+    80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95,
+    96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111,
+    112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127
+  };
+  static constexpr int8_t op0Weights[864] = {
+    -10, -1, 17, -5, -91, 53, 94, -110, -13, -7, 23, 24, 11, -86, 52, 86,
+    -127, -3, -10, 23, 37, 1, -112, 25, 91, -122, 0, -94, 5, 24, 36, -16,
+    35, -127, -53, 35, -22, 42, -3, 37, -28, 36, -61, -22, 12, -37, 54, -16,
+    45, 5, 21, -69, 6, 33, -65, 17, -51, -4, 12, -49, 95, 8, 38, 31,
+    -1, -62, 16, 10, -127, 73, -4, 37, 32, -15, -79, -20, -40, 23, -57, -26,
+    47, -16, 0, 42, 13, -90, -67, 109, -65, 58, -12, 11, 40, 51, -66, -11,
+    127, -54, 58, -38, -81, -42, -25, -86, -19, 119, -60, 26, -34, 6, 63, 12,
+    57, -22, -54, 92, -21, -127, -9, 85, 24, 40, -34, -40, -46, -24, -29, 12,
+    60, 2, 34, -4, -67, -47, -48, -16, -42, 65, 59, -12, 25, -56, 127, -48,
+    -46, -43, 96, 33, -31, -101, 42, 72, -76, -34, -24, 20, 57, -49, -56, -15,
+    118, -96, -19, -42, 29, 51, -45, -29, -17, 119, -80, -17, -32, 4, 70, -28,
+    -28, -17, 127, -23, -6, -33, -19, 65, -12, -37, -10, 108, -78, -15, -16, 65,
+    -3, 14, -99, 46, -37, -72, -23, 3, 90, 15, 27, -93, 41, -27, -76, -117,
+    2, 127, 6, 29, -34, 26, -25, -88, -45, 7, 0, -43, 65, -120, 17, 20,
+    26, -56, -6, 56, -33, 70, -121, 20, -7, 30, -45, 9, 31, -29, 60, -127,
+    19, 18, 51, -22, -22, 98, -127, -14, 87, 30, -7, -68, -11, 9, 69, -109,
+    3, 81, 17, 6, -43, -3, 11, 93, -95, 4, 80, 28, 1, -65, 70, -19,
+    -32, 18, -102, -35, -6, -113, -21, 77, -1, -41, -7, -109, -105, 60, 65, -19,
+    68, 0, -17, 55, -69, -127, 48, 29, -30, 39, -59, -52, 30, -43, -1, 56,
+    -16, 72, 87, 24, -127, -29, -75, -9, -23, 1, -3, 84, 19, -117, -40, -72,
+    15, 21, 7, 17, -1, -32, 69, -40, -85, 1, -58, 59, -8, -34, -28, 90,
+    -37, -72, 43, 127, -44, 26, -11, -35, 95, -36, -69, 36, 102, -56, 35, 86,
+    41, -21, -33, -81, 42, -51, 7, -57, -16, 52, -11, -16, -87, -96, 105, -3,
+    -76, 66, 73, -14, -18, -84, -87, 127, -12, -78, -42, -7, -56, 7, -70, 114,
+    48, -47, 16, 3, 11, 21, 12, -77, -38, -73, 101, 1, 3, 24, 7, 29,
+    -68, -50, -85, 127, 22, 53, -5, 21, 61, -66, -30, -115, -88, -44, 75, 27,
+    -4, 47, -57, -49, -116, -74, -80, 68, 28, 25, 22, -40, -127, 16, -30, -57,
+    -1, 18, -4, 37, 5, 16, -91, 74, -34, -4, 24, -28, -6, -26, 16, -127,
+    74, -45, -3, 25, -20, 30, 10, 30, 15, 5, -16, 23, -118, -22, -36, -127,
+    47, 63, 22, 60, -101, -112, 67, 90, -31, -102, 8, -13, 31, 66, -30, 88,
+    62, -60, 17, -62, -37, 78, -68, -44, -35, -57, -27, 127, -45, -4, 17, 36,
+    30, -13, -17, 22, 11, 100, 14, 11, 38, 9, -48, -24, -4, -81, -24, -39,
+    18, -32, 33, 46, 43, 1, 23, -74, -39, -54, -24, 37, 52, 39, 10, 8,
+    -82, -36, -44, -30, 46, 46, 48, 4, -127, 31, -33, -80, -18, -1, -10, -15,
+    17, -121, 12, -2, 110, -14, 10, -22, 2, 12, -127, -4, -16, 81, -4, -10,
+    -3, -8, 1, -118, -13, 5, 88, -45, -15, 34, -17, -42, -15, 110, 48, -8,
+    14, -15, -3, -5, -54, -3, 126, 31, -6, 13, -30, 28, 25, -37, -127, -47,
+    -67, -20, 21, 6, -1, -39, -72, 45, 26, 107, 47, -5, 0, -43, -46, -104,
+    100, -12, -127, 84, -65, 6, 48, -33, -48, 123, -32, -110, 75, -8, 3, 83,
+    -35, -72, 22, 42, 36, -44, -9, -6, 78, -43, -75, 33, 77, -127, 7, -7,
+    -13, 81, -47, -52, 46, 88, -127, -17, -51, 42, 65, 22, -9, -127, 45, -28,
+    -103, -76, 18, 60, 27, 43, -77, 54, -18, -89, -22, 40, 91, 23, 7, -52,
+    27, -33, -77, 1, 9, 39, 28, 25, -40, 5, 8, -87, -127, -39, 61, 37,
+    28, -20, -1, -1, -68, -1, 7, 50, 25, 33, -46, 5, 31, -68, 44, 1,
+    -70, 33, 5, -13, -2, -114, 35, 60, 17, -99, 16, 5, -28, 8, -127, 35,
+    19, 15, -41, 31, -26, -41, -7, -76, 43, -3, 15, -65, 124, -106, -5, -41,
+    122, -90, 30, -4, -74, 120, -97, 19, -39, 127, -108, 29, 12, -84, 105, -61,
+    14, -25, 105, -57, -55, -27, 92, -47, -72, 58, 19, -5, 11, -116, 0, 127,
+    13, -16, 81, 11, -10, 14, 0, -26, 31, -65, -57, 75, 82, -34, 8, 81,
+    34, -6, 50, -25, -127, 104, -7, -84, 81, 20, 17, 41, -13, -102, 98, -10,
+    -87, 12, 15, -55, -21, -62, -110, -83, -86, -111, -24, 18, 67, 17, 14, -72,
+    45, -7, -109, 6, -2, 59, 85, 15, -95, -98, -102, -92, 8, 13, 89, 44,
+    58, -127, -106, -91, -68, 7, 83, 17, 6, -27, -90, 18, -100, 45, 22, 77,
+    19, 8, -44, -56, 58, -34, 56, -16, -127, -21, -23, -90, 22, 58, 45, -10
+  };
+  static constexpr int32_t op0Bias[32] = {
+    -2525, -7554, 8019, -3664, -11816, -4789, -12059, -4308,
+    -16708, -2507, 17524, 16074, -11306, 14669, 1697, 16163,
+    -5995, 6884, 6780, -8109, -13011, 2837, 2278, -3930,
+    -11330, -3401, 11975, -1032, -7829, 14039, -3111, -2538
+  };
+  static constexpr int32_t op0Multipliers[32] = {
+    1384900739, 1865092476, 1954134011, 1521604706, 1589376432, 1090413972, 2058456106, 1413375024,
+    1552078950, 1460264640, 1355822790, 1853588261, 1406894255, 1232461598, 1355801251, 1185976267,
+    1924689614, 1082165147, 1660570258, 1403942277, 1876825147, 1669685091, 1505237581, 1542185989,
+    1298532037, 1930170259, 1498613364, 2101873651, 1702122678, 1380638190, 1201237800, 1546496354
+  };
+  static constexpr int32_t op0Shifts[32] = {
+    -9, -9, -9, -9, -9, -9, -10, -9,
+    -9, -9, -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -9, -9, -9, -9, -9,
+    -9, -9, -9, -10, -9, -9, -9, -9
+  };
+  static constexpr int8_t op1Weights[448] = {
+    -9, 39, 80, -82, -2, -3, 0, 1, -17, -47, -51, 101, -71, -16, -15, 51,
+    5, -53, 28, 25, 20, 2, 38, -33, 10, -4, 13, 13, -59, 38, 13, 12,
+    15, 0, 10, 51, 9, 16, 14, 23, -34, -17, -11, -58, 16, 23, -13, 22,
+    -53, 3, -25, 36, -22, 7, -23, 11, 28, 14, -8, -5, -15, 91, 62, 40,
+    27, 14, -4, 24, -28, 3, 2, 33, 8, -50, 26, -2, -11, 8, 25, -12,
+    19, 32, 19, -9, 22, 16, 18, -21, 24, -3, 30, 29, 30, -46, 17, -17,
+    44, 61, -77, 64, -37, 7, 10, -3, 6, 10, 31, -35, 52, 68, -25, 14,
+    -3, -3, -11, 3, 39, 18, 104, 100, 22, -38, 6, 25, 70, 74, 19, 34,
+    19, -37, -89, -42, 8, 6, 4, 35, 28, -10, 43, -30, -12, 4, 20, -15,
+    14, 10, 23, -10, -13, 8, 13, 9, 32, 20, 9, 12, 14, -27, 11, -17,
+    1, -11, -8, -63, -9, -18, -19, -72, 29, 91, 20, -122, -48, -11, 0, 16,
+    5, -74, -39, -23, 55, -65, 23, 58, -27, -104, 8, -13, -3, 0, -26, -38,
+    18, -20, 88, 42, 16, 10, 9, -38, -33, -31, 40, 69, -70, -30, 27, 42,
+    -8, -4, -31, 13, 23, 25, -37, -7, -71, -11, 43, 28, -72, 79, 1, -15,
+    -39, 28, -7, -32, 15, -24, -34, 20, -29, -19, 17, 18, -11, 64, -5, -1,
+    -23, 11, 18, 33, -48, -12, 1, -68, 31, 47, -18, -44, -89, 5, -4, 14,
+    1, -23, 2, -37, -26, 11, 18, 10, -2, -17, -33, 127, 44, -14, 12, -30,
+    43, 4, -10, -36, 5, -42, -6, -9, -11, -4, 35, 52, 14, -34, -42, 16,
+    13, -10, -13, 21, -7, 19, 8, 24, 25, 48, -59, 85, 16, -31, 13, -22,
+    -8, 9, -27, 1, 16, -17, -12, 51, 11, 25, -24, -21, 54, -12, -14, 1,
+    -39, -11, -11, -35, 39, -8, -10, 7, 7, 15, -8, -6, 22, 1, -23, -15,
+    -5, -11, 19, 19, -11, 7, 19, -46, -10, 7, -20, -46, 9, -17, 13, -38,
+    -51, -32, 44, 5, -71, -43, -39, -60, -30, 15, -5, -26, 15, -22, 40, -6,
+    2, 20, 25, -26, -1, 29, -51, -45, -37, -103, -3, -17, -42, -10, -37, 39,
+    9, -30, 28, 65, 51, 21, 4, -11, -6, -4, -24, -70, 36, -26, 14, -20,
+    14, 6, -32, -7, -15, -24, -43, 21, -10, 26, -10, 9, 2, -28, -27, 26,
+    -10, 3, -25, -34, 4, 5, -3, 26, 47, 38, -2, -72, 8, 32, -33, 0,
+    7, -10, 31, -12, 36, 11, -35, -4, 7, 22, 26, -38, 18, -20, 2, -48
+  };
+  static constexpr int32_t op1Bias[14] = {
+    355, -612, 554, -921, 452, -1875, 679, -78,
+    -110, -82, 1600, -1338, -169, 256
+  };
+  static constexpr int32_t op1InputDims[2] = {
+    1, 32
+  };
+  static constexpr int32_t op1FilterDims[2] = {
+    14, 32
+  };
+  static constexpr int32_t op1OutputDims[2] = {
+    1, 14
+  };
+  static constexpr int32_t op2Dims[2] = {
+    1, 14
+  };
+  static constexpr uint8_t op3Table[256] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+    32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+    48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63,
+    64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79,
+    80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95,
+    96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111,
+    112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127,
+    128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143,
+    144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159,
+    160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175,
+    176, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191,
+    192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207,
+    208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223,
+    224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+    240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255
+  };
+  alignas(16) static inline uint8_t arena[kArenaBytes];
+};
@@ -2,14 +2,30 @@
 #define USE_ICM // 6.9kb bigger than MPU6050
 // #define USE_LOGGING // 2.8kb bigger than with no logging
 #define USE_TFLITE
+#define USE_FUSED_MODEL // run modelFused.h, conv and max over time in one op without the conv output in the arena
+#define USE_COMPILED_MODEL // run compiledModel.h, the fused graph as straight-line kernel calls without an interpreter
+#define USE_STREAMING_INFERENCE // reuse conv columns across overlapping windows, the default path. Falls back to the
+                                // compiled model, or the interpreter without USE_COMPILED_MODEL, when the model has no streaming form
+// #define USE_PROFILING // per-op latency histograms, dumped as CSV over serial and BLE
+#define USE_SRAM_ARENA // split the tensor arena, hot buffers in internal SRAM and the rest in PSRAM, sized by arenaPlan.h
 #define SEND_DATA
+#define USE_BLE_BATCH // without USE_TFLITE: stream fused rows, many per MTU sized notification (bleFrame.h)
+#define USE_BLE_COMPRESSION // with USE_BLE_BATCH: delta coded blocks (gloveCodec.h) in place of bleFrame.h frames, about 3x the rows per notification.
+                            // bleFrame.h frames still go out while the MTU is too small for a keyframe
 #define USE_FINGERS
 #define USE_IMU
+#define USE_FIXED_QUATERNION // integer Q30 to byte conversion, same output as the double path
 // #define USE_CALIBRATION
 // #define USE_TRAIN
+// #define USE_TRAIN_RECORDER // with USE_TRAIN: lossless binary capture to the ffat partition (trainRecorder.h) in place of serial CSV
+// #define USE_SENSOR_TRACE // with USE_TRAIN_RECORDER: the raw ADC and DMP samples too, replayable by host/pipeline_sim (sensorTrace.h)
 
 #ifdef USE_TRAIN
-#define TRAIN_QUEUE_LENGTH 100
+#define TRAIN_QUEUE_LENGTH 128
+#define TRAIN_RECORD_POLL_MS 10     // rings drained this often, 128 samples cover well over a second
+#define TRAIN_RECORD_FLUSH_MS 2000  // a part filled block is written once its oldest sample is this old
+#define TRAIN_RECORD_STACK_SIZE 2048
+#define TRAIN_WRITE_STACK_SIZE 4096  // FATFS and the flash driver run on it
 #endif
 
 /*
@@ -37,6 +53,12 @@
 #define I2C_SCL_PIN 3
 #endif
 #define IMU_INTERRUPT 8
+#define IMU_INTERRUPT_TIMEOUT 100  // ms, backstop only, drain the FIFO anyway if the interrupt never comes
+#define ICM_DMP_RATE 55            // hz, Quat9 packets per second with setDMPODRrate 0
+#define ICM_PACKET_BYTES 18        // header, Quat9 and footer of one packet in the FIFO
+#define ICM_FIFO_WATERMARK 18      // bytes, the DMP interrupts once the count is past it, every second packet (~36ms)
+#define ICM_FIFO_BUFFER 512        // bytes, burst read buffer
+#define MPU_FIFO_PACKETS 16        // packets read per MPU6050 FIFO drain
 
 // FINGER PINS
 #define PINKY_PIN 9
@@ -50,24 +72,31 @@
 
 
 //RTOS DEFINITIONS
-#define FINGER_QUEUE_LENGTH 10
-#define HAND_QUEUE_LENGTH 10
-#define IMU_QUEUE_LENGTH 10
-#define IMU_QUEUE_WAIT 1
-#define FINGER_QUEUE_WAIT 1
-#define FINGER_QUEUE_RECEIVE_WAIT 0
+#define HAND_QUEUE_LENGTH 16  // spscRing.h lengths are powers of two, a full ring drops the newest sample
+#define IMU_QUEUE_LENGTH 16
 
-#define FINGER_STACK_SIZE 1280
+#define HAND_STACK_SIZE 3072
 #define MPU_STACK_SIZE 2560
-#define INFERENCE_STACK_SIZE 75776
-#define INFERENCE_PARSER_STACK_SIZE 160747
+#define INFERENCE_STACK_SIZE 16384
+#define INFERENCE_PARSER_STACK_SIZE 8192
 
 // RTOS PRIORITY DEFINITIONS
 #define FINGER_PRIORITY 1
 #define ACCEL_PRIORITY 2
 #define SYSTEM_PRIORITY 3
 
-#define FINGER_SAMPLING_RATE 60  // hz, MAXIMUM ONLY, DOES NOT GUARRANTEE ACTUAL SAMPLING RATE DUE TO freeRTOS
+#define FINGER_SAMPLING_RATE 60  // hz, frames per second of the HandSampler, hardware timed in ADC continuous mode
+#define FINGER_OVERSAMPLING 8    // conversions averaged per finger per frame, rate * 5 * this must be >= 611hz
+#define FUSION_RATE 60          // hz, fused rows per second pushed into the inference window
+#ifdef USE_ICM
+#define IMU_SAMPLE_RATE ICM_DMP_RATE
+#define IMU_DELIVERY_US ((ICM_FIFO_WATERMARK / ICM_PACKET_BYTES + 1) * 1000000UL / ICM_DMP_RATE)  // longest a packet waits in the FIFO
+#else
+#define IMU_SAMPLE_RATE 100  // hz, MotionApps 6.12 default, the MPU6050 interrupts on every packet
+#define IMU_DELIVERY_US (1000000UL / IMU_SAMPLE_RATE)
+#endif
+#define FUSION_DELAY_US (IMU_DELIVERY_US + 1000000UL / FUSION_RATE)  // fusion clock runs this far behind so both streams have a sample after each tick
+#define FUSION_INTERPOLATE      // comment out to hold the last sample instead of interpolating
 #define CALIBRATION_TIME 15// time in seconds
 
 // PINNED CORE DEFINITION
@@ -77,11 +106,20 @@
 #define INFERENCE_FEATURES 9
 #define INFERENCE_LENGTH 7442
 #define INFERENCE_WINDOW 1000
+#define PROFILE_REPORT_INTERVAL 20  // inferences between profiling dumps
+// Arena buffer classes placed in internal SRAM with USE_SRAM_ARENA
+#define SRAM_ARENA_SCRATCH  // kernel scratch, the esp_nn conv copies its input and filter here
+#define SRAM_ARENA_ACTIVATION_MAX 0  // activations up to this many bytes too, needs room beyond arenaPlan.h's SRAM part.
+                                     // Overrides an offline plan (fuse_model --offline-plan) for them, they are planned online in SRAM
+// #define SRAM_ARENA_PERSISTENT  // tensor structs and op data while there is room
 
 // BLUETOOTH VARIABLES
 constexpr char bluetoothName[] = "SignSaya";
+#define BLE_FRAME_MTU 247       // ATT MTU asked for, 247 fills one 251 byte data length extended LL packet
+#define BLE_FRAME_FLUSH_MS 500  // send a part filled frame once its oldest row is this old, a full one is 350ms at 60hz
 
 // OTHER VARIABLES
 #define MA_TIME_SPAN 1          // Time in seconds that spans the MA Filter
 #define ARRAY_LENGTH FINGER_SAMPLING_RATE * MA_TIME_SPAN
+#define FINGER_FILTER BoxcarFilter<ARRAY_LENGTH> // BoxcarFilter, ExponentialFilter or MedianFilter (fingerFilters.h)
 uint8_t maxFingerValue = 255;  //max value of finger output for dataset
@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Smoothing filters for the bend sensors, picked at compile time through
+// FingerInstance's template parameter. All take raw 12-bit ADC samples and
+// share the same interface: update() returns the filtered value, reset()
+// clears the history.
+
+// Moving average over the last Length samples, O(1) per sample using a
+// running total instead of re-summing the window.
+template <uint16_t Length>
+class BoxcarFilter {
+private:
+  uint16_t ringArray[Length];
+  uint32_t currentTotal = 0;
+  uint16_t head = 0;
+
+public:
+  BoxcarFilter() {
+    reset();
+  }
+
+  void reset() {
+    memset(ringArray, 0, sizeof(ringArray));
+    currentTotal = 0;
+    head = 0;
+  }
+
+  uint16_t update(uint16_t sample) {
+    currentTotal += sample;
+    currentTotal -= ringArray[head];
+    ringArray[head] = sample;
+    head++;
+    if (head >= Length) {
+      head = 0;
+    }
+    return currentTotal / Length;
+  }
+};
+
+// Exponential moving average with the same center of mass as a Length sample
+// boxcar (alpha = 2 / (Length + 1)). Only keeps a 16.16 fixed point state.
+template <uint16_t Length>
+class ExponentialFilter {
+private:
+  int32_t state = 0;
+
+public:
+  ExponentialFilter() {
+  }
+
+  void reset() {
+    state = 0;
+  }
+
+  uint16_t update(uint16_t sample) {
+    state += (((int32_t)sample << 16) - state) * 2 / (Length + 1);
+    return (uint16_t)((state + (1 << 15)) >> 16);
+  }
+};
+
+// Running median of the last Length samples, rejects the single sample spikes
+// the velostat sensors produce. Keeps a sorted copy of the window so each
+// sample is one binary search plus a short memmove.
+template <uint16_t Length>
+class MedianFilter {
+private:
+  uint16_t ringArray[Length];
+  uint16_t sortedArray[Length];
+  uint16_t head = 0;
+
+  uint16_t lowerBound(uint16_t value) const {
+    uint16_t low = 0;
+    uint16_t high = Length;
+    while (low < high) {
+      uint16_t middle = (low + high) / 2;
+      if (sortedArray[middle] < value) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return low;
+  }
+
+public:
+  MedianFilter() {
+    reset();
+  }
+
+  void reset() {
+    memset(ringArray, 0, sizeof(ringArray));
+    memset(sortedArray, 0, sizeof(sortedArray));
+    head = 0;
+  }
+
+  uint16_t update(uint16_t sample) {
+    // drop the oldest sample from the sorted window
+    uint16_t oldIndex = lowerBound(ringArray[head]);
+    memmove(&sortedArray[oldIndex], &sortedArray[oldIndex + 1], (Length - 1 - oldIndex) * sizeof(uint16_t));
+
+    // insert the new one, searching only the Length - 1 remaining values
+    uint16_t low = 0;
+    uint16_t high = Length - 1;
+    while (low < high) {
+      uint16_t middle = (low + high) / 2;
+      if (sortedArray[middle] < sample) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    memmove(&sortedArray[low + 1], &sortedArray[low], (Length - 1 - low) * sizeof(uint16_t));
+    sortedArray[low] = sample;
+
+    ringArray[head] = sample;
+    head++;
+    if (head >= Length) {
+      head = 0;
+    }
+    return sortedArray[Length / 2];
+  }
+};
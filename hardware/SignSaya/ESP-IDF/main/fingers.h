@@ -1,8 +1,10 @@
+#include "fingerFilters.h"
+
+// Filter is one of the classes in fingerFilters.h, see FINGER_FILTER in config.h
+template <class Filter = BoxcarFilter<ARRAY_LENGTH>>
 class FingerInstance {
 private:
-  // For increased precision consider using uint16_t instead to fit entire ADC range
-  uint16_t fingerArray[ARRAY_LENGTH];
-  // constexpr uint8_t ARRAY_LENGTH = FINGER_SAMPLING_RATE * MA_TIME_SPAN;
+  Filter fingerFilter;
   uint16_t minInputValue = 0;
   uint16_t maxInputValue = 4095;
   uint8_t pinNumber;
@@ -17,24 +19,9 @@ private:
     return analogRead(pinNumber);
   }
 
-  // Modified movingAverage, returns a value in 0 - 255 range
+  // Modified movingAverage, returns the filtered raw reading
   uint16_t movingAverage() {
-    // Variable to save the total value of the array
-    uint32_t currentTotal = 0;
-
-    // shift indexes 1 place to the left
-    // Save the current index's value to the variable
-    for (int arrayIndex = 0; arrayIndex < ARRAY_LENGTH - 1; arrayIndex++) {
-      fingerArray[arrayIndex] = fingerArray[arrayIndex + 1];
-      currentTotal += fingerArray[arrayIndex];
-    }
-
-    // Read new value and save into the array
-    uint16_t newRead = rawRead();
-    fingerArray[ARRAY_LENGTH - 1] = newRead;
-    currentTotal += newRead;
-    // Serial.println(ARRAY_LENGTH);
-    return (currentTotal / ARRAY_LENGTH);
+    return fingerFilter.update(rawRead());
   }
 
 public:
@@ -57,7 +44,17 @@ public:
     // return movingAverage();
   }
 
+  // Same as read() for a raw value already sampled by the HandSampler
+  uint8_t read(uint16_t rawValue) {
+    currentValue = fingerFilter.update(rawValue);
+    return mapData(currentValue);
+  }
+
   void calibrate() {
+    calibrate(analogRead(pinNumber));
+  }
+
+  void calibrate(uint16_t currentSensorValue) {
     if (!calibrationStarted) {
       // prevMaxInputValue = maxInputValue;
       // prevMinInputValue = minInputValue;
@@ -67,16 +64,13 @@ public:
       // arrayCalibrated = false;
     }
 
-    uint16_t currentSensorValue = analogRead(pinNumber);
     minInputValue = min(minInputValue, currentSensorValue);
     maxInputValue = max(maxInputValue, currentSensorValue);
   }
 
   void saveCalibration() {
     calibrationStarted = false;
-    for (uint8_t arrayIndex = 0; arrayIndex < ARRAY_LENGTH - 1; arrayIndex++) {
-      fingerArray[arrayIndex] = 0;
-    }
+    fingerFilter.reset();
 
     // Serial.print("Min value: ");
     // Serial.print(minInputValue);
@@ -0,0 +1,207 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/common.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/reference/requantize.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/micro_context.h"
+#include "tensorflow/lite/micro/micro_log.h"
+
+// Custom op standing in for Quantize -> ExpandDims -> Conv2D(1xK, VALID,
+// stride 1) -> Reshape -> ReduceMax(time) in the graph host/fuse_model writes.
+//   inputs:  uint8 window [1, T, F], int8 filter [C, 1, K, F], int32 bias [C]
+//   output:  int8 [1, C] with the conv output's quantization
+//   options: float scale, int32 zero point of the int8 conv input
+// Each row is quantized once through a 256 entry table, the conv keeps only a
+// running max of the raw accumulators per channel and requantizes C values at
+// the end: the requantization is monotonic, so that is the same as taking the
+// max of the requantized map. The T x C conv output is never written.
+#define FUSED_CONV_MAX_OP "SIGNSAYA_CONV_MAX"
+#define FUSED_CONV_MAX_OPTIONS_BYTES 8
+#define FUSED_CONV_MAX_CHANNELS 64  // most output channels the kernel handles
+#define FUSED_CONV_MAX_TAPS 64      // most kernel width * features
+
+class FusedConvMax {
+private:
+  struct OpData {
+    float convInputScale;
+    int32_t convInputZeroPoint;
+    int8_t quantized[256];  // uint8 window value -> int8 conv input
+    int32_t *multipliers;
+    int32_t *shifts;
+    int32_t outputOffset;
+    int kernelWidth;
+    int features;
+    int channels;
+  };
+
+  static void *init(TfLiteContext *context, const char *buffer, size_t length) {
+    OpData *data = static_cast<OpData *>(context->AllocatePersistentBuffer(context, sizeof(OpData)));
+    if (data == nullptr || buffer == nullptr || length != FUSED_CONV_MAX_OPTIONS_BYTES) {
+      return data;
+    }
+    memcpy(&data->convInputScale, buffer, sizeof(float));
+    memcpy(&data->convInputZeroPoint, buffer + sizeof(float), sizeof(int32_t));
+    return data;
+  }
+
+  static TfLiteStatus prepare(TfLiteContext *context, TfLiteNode *node) {
+    OpData *data = static_cast<OpData *>(node->user_data);
+    TF_LITE_ENSURE(context, data != nullptr && data->convInputScale > 0.0f);
+    TF_LITE_ENSURE_EQ(context, tflite::NumInputs(node), 3);
+    TF_LITE_ENSURE_EQ(context, tflite::NumOutputs(node), 1);
+
+    tflite::MicroContext *microContext = tflite::GetMicroContext(context);
+    TfLiteTensor *input = microContext->AllocateTempInputTensor(node, 0);
+    TfLiteTensor *filter = microContext->AllocateTempInputTensor(node, 1);
+    TfLiteTensor *bias = microContext->AllocateTempInputTensor(node, 2);
+    TfLiteTensor *output = microContext->AllocateTempOutputTensor(node, 0);
+    TF_LITE_ENSURE(context, input != nullptr && filter != nullptr && bias != nullptr && output != nullptr);
+    TF_LITE_ENSURE_TYPES_EQ(context, input->type, kTfLiteUInt8);
+    TF_LITE_ENSURE_TYPES_EQ(context, filter->type, kTfLiteInt8);
+    TF_LITE_ENSURE_TYPES_EQ(context, bias->type, kTfLiteInt32);
+    TF_LITE_ENSURE_TYPES_EQ(context, output->type, kTfLiteInt8);
+    TF_LITE_ENSURE_EQ(context, input->dims->size, 3);
+    TF_LITE_ENSURE_EQ(context, filter->dims->size, 4);
+
+    data->channels = filter->dims->data[0];
+    data->kernelWidth = filter->dims->data[2];
+    data->features = filter->dims->data[3];
+    TF_LITE_ENSURE_EQ(context, input->dims->data[2], data->features);
+    TF_LITE_ENSURE(context, input->dims->data[1] >= data->kernelWidth);
+    TF_LITE_ENSURE(context, data->channels <= FUSED_CONV_MAX_CHANNELS);
+    TF_LITE_ENSURE(context, data->kernelWidth * data->features <= FUSED_CONV_MAX_TAPS);
+    TF_LITE_ENSURE_EQ(context, tflite::NumElements(output), data->channels);
+
+    // Same math as the Quantize op's uint8 -> int8 Requantize
+    int32_t requantizeMultiplier;
+    int requantizeShift;
+    tflite::QuantizeMultiplier(static_cast<double>(input->params.scale) / static_cast<double>(data->convInputScale),
+                               &requantizeMultiplier, &requantizeShift);
+    uint8_t levels[256];
+    for (int level = 0; level < 256; level++) {
+      levels[level] = static_cast<uint8_t>(level);
+    }
+    tflite::reference_ops::Requantize(levels, 256, requantizeMultiplier, requantizeShift,
+                                      input->params.zero_point, data->convInputZeroPoint, data->quantized);
+
+    // Same math as PopulateConvolutionQuantizationParams, per channel
+    const TfLiteAffineQuantization *filterQuantization =
+      static_cast<const TfLiteAffineQuantization *>(filter->quantization.params);
+    TF_LITE_ENSURE(context, filterQuantization != nullptr && filterQuantization->scale->size == data->channels);
+    data->multipliers = static_cast<int32_t *>(context->AllocatePersistentBuffer(context, data->channels * sizeof(int32_t)));
+    data->shifts = static_cast<int32_t *>(context->AllocatePersistentBuffer(context, data->channels * sizeof(int32_t)));
+    TF_LITE_ENSURE(context, data->multipliers != nullptr && data->shifts != nullptr);
+    for (int channel = 0; channel < data->channels; channel++) {
+      double effectiveScale = static_cast<double>(data->convInputScale)
+                              * static_cast<double>(filterQuantization->scale->data[channel])
+                              / static_cast<double>(output->params.scale);
+      int shift;
+      tflite::QuantizeMultiplier(effectiveScale, &data->multipliers[channel], &shift);
+      data->shifts[channel] = shift;
+    }
+    data->outputOffset = output->params.zero_point;
+
+    microContext->DeallocateTempTfLiteTensor(input);
+    microContext->DeallocateTempTfLiteTensor(filter);
+    microContext->DeallocateTempTfLiteTensor(bias);
+    microContext->DeallocateTempTfLiteTensor(output);
+    return kTfLiteOk;
+  }
+
+  static TfLiteStatus eval(TfLiteContext *context, TfLiteNode *node) {
+    const OpData *data = static_cast<const OpData *>(node->user_data);
+    const TfLiteEvalTensor *input = tflite::micro::GetEvalInput(context, node, 0);
+    const TfLiteEvalTensor *filter = tflite::micro::GetEvalInput(context, node, 1);
+    const TfLiteEvalTensor *bias = tflite::micro::GetEvalInput(context, node, 2);
+    TfLiteEvalTensor *output = tflite::micro::GetEvalOutput(context, node, 0);
+    Dims dims = { input->dims->data[1], data->kernelWidth, data->features, data->channels };
+    run(dims, data->quantized, -data->convInputZeroPoint, tflite::micro::GetTensorData<uint8_t>(input),
+        tflite::micro::GetTensorData<int8_t>(filter), tflite::micro::GetTensorData<int32_t>(bias),
+        data->multipliers, data->shifts, data->outputOffset, tflite::micro::GetTensorData<int8_t>(output));
+    return kTfLiteOk;
+  }
+
+public:
+  // Shape of one invocation, known only at Prepare in the interpreter
+  struct Dims {
+    int rows;
+    int kernelWidth;
+    int features;
+    int channels;
+  };
+
+  // The same shape as compile-time constants, so generated code gets loops
+  // the compiler can unroll
+  template<int Rows, int KernelWidth, int Features, int Channels>
+  struct FixedDims {
+    static constexpr int rows = Rows;
+    static constexpr int kernelWidth = KernelWidth;
+    static constexpr int features = Features;
+    static constexpr int channels = Channels;
+    static_assert(KernelWidth * Features <= FUSED_CONV_MAX_TAPS, "kernel too wide");
+    static_assert(Channels <= FUSED_CONV_MAX_CHANNELS, "too many channels");
+  };
+
+  // The whole op on a window of dims.rows rows, quantized maps the uint8
+  // input to the int8 conv input and biases may be null
+  template<typename D>
+  static void run(const D &dims, const int8_t *quantized, int32_t inputOffset, const uint8_t *window,
+                  const int8_t *weights, const int32_t *biases, const int32_t *multipliers,
+                  const int32_t *shifts, int32_t outputOffset, int8_t *pooled) {
+    const int taps = dims.kernelWidth * dims.features;
+    const int positions = dims.rows - dims.kernelWidth + 1;
+
+    // The K newest rows quantized with the input offset applied, shifted
+    // along one row per output position
+    int32_t taps32[FUSED_CONV_MAX_TAPS];
+    for (int tap = 0; tap < taps - dims.features; tap++) {
+      taps32[tap] = quantized[window[tap]] + inputOffset;
+    }
+    int32_t maxAccumulator[FUSED_CONV_MAX_CHANNELS];
+    for (int channel = 0; channel < dims.channels; channel++) {
+      maxAccumulator[channel] = std::numeric_limits<int32_t>::min();
+    }
+
+    const uint8_t *nextRow = &window[taps - dims.features];
+    for (int position = 0; position < positions; position++) {
+      int32_t *newest = &taps32[taps - dims.features];
+      for (int feature = 0; feature < dims.features; feature++) {
+        newest[feature] = quantized[nextRow[feature]] + inputOffset;
+      }
+      nextRow += dims.features;
+
+      const int8_t *channelWeights = weights;
+      for (int channel = 0; channel < dims.channels; channel++) {
+        int32_t accumulator = 0;
+        for (int tap = 0; tap < taps; tap++) {
+          accumulator += taps32[tap] * channelWeights[tap];
+        }
+        channelWeights += taps;
+        if (accumulator > maxAccumulator[channel]) {
+          maxAccumulator[channel] = accumulator;
+        }
+      }
+      memmove(taps32, &taps32[dims.features], (taps - dims.features) * sizeof(int32_t));
+    }
+
+    for (int channel = 0; channel < dims.channels; channel++) {
+      int32_t accumulator = maxAccumulator[channel] + (biases != nullptr ? biases[channel] : 0);
+      accumulator = tflite::MultiplyByQuantizedMultiplier(accumulator, multipliers[channel], shifts[channel]);
+      accumulator += outputOffset;
+      accumulator = std::max<int32_t>(accumulator, std::numeric_limits<int8_t>::min());
+      accumulator = std::min<int32_t>(accumulator, std::numeric_limits<int8_t>::max());
+      pooled[channel] = static_cast<int8_t>(accumulator);
+    }
+  }
+
+  static const TFLMRegistration *registration() {
+    static TFLMRegistration fusedRegistration = tflite::micro::RegisterOp(init, prepare, eval);
+    return &fusedRegistration;
+  }
+};
@@ -0,0 +1,436 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "types.h"
+
+// Delta codec for glove rows: blocks of up to GLOVE_CODEC_BLOCK_ROWS rows of
+// Channels bytes each, every channel stored as zigzag deltas at the fewest
+// bits that hold its largest delta in the block. Deltas wrap at 8 bits, so a
+// byte step of any size costs at most 8 bits. A keyframe block carries its
+// first row raw, the others continue from the last row of the block before,
+// so a decoder that missed a block resyncs at the next keyframe.
+// A block, little endian:
+//   byte 0      GLOVE_CODEC_VERSION, tells it apart from a bleFrame.h frame
+//   byte 1      bit 7 keyframe, bits 0-6 rows
+//   bytes 2-3   sequence number, one more than the block before
+//   bytes 4-7   timestamp of the first row
+//   bytes 8-9   us from the first row to the second, 0 for a single row
+//   byte 10     bits per timestamp jitter
+//   then a 4 bit width per channel, low nibble first, the keyframe's first
+//   row, and the bit stream, LSB first: each channel's deltas in turn, then
+//   the zigzag difference of every later row interval from bytes 8-9.
+// Encoding a row is O(Channels), packing a block O(rows * Channels), both
+// bounded by the block size.
+
+#define GLOVE_CODEC_VERSION 2
+#define GLOVE_CODEC_BLOCK_ROWS 64       // rows per block at most, fits the 7 bit count
+#define GLOVE_CODEC_KEYFRAME_BLOCKS 8   // a keyframe at least every this many blocks
+#define GLOVE_CODEC_HEADER_BYTES 11
+
+inline uint32_t zigzag(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+inline int32_t unzigzag(uint32_t value) {
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+inline uint8_t bitWidth(uint32_t value) {
+  uint8_t width = 0;
+  while (value != 0) {
+    width++;
+    value >>= 1;
+  }
+  return width;
+}
+
+// Byte step from one value to the next as the codec stores it
+inline uint8_t byteDelta(uint8_t from, uint8_t to) {
+  return (uint8_t)zigzag((int8_t)(uint8_t)(to - from));
+}
+
+inline void packRow(const Inference_t &row, uint8_t *values) {
+  memcpy(values, &row, sizeof(Inference_t));
+}
+
+inline void packRow(const handData_t &row, uint8_t *values) {
+  values[0] = row.pinky;
+  values[1] = row.ring;
+  values[2] = row.middle;
+  values[3] = row.index;
+  values[4] = row.thumb;
+}
+
+inline void packRow(const quaternion_t &row, uint8_t *values) {
+  values[0] = row.w;
+  values[1] = row.x;
+  values[2] = row.y;
+  values[3] = row.z;
+}
+
+class BitWriter {
+private:
+  uint8_t *out;
+  uint32_t pending = 0;
+  uint8_t pendingBits = 0;
+
+public:
+  explicit BitWriter(uint8_t *destination)
+    : out(destination) {
+  }
+
+  // width up to 24
+  void write(uint32_t value, uint8_t width) {
+    pending |= value << pendingBits;
+    pendingBits += width;
+    while (pendingBits >= 8) {
+      *out++ = (uint8_t)pending;
+      pending >>= 8;
+      pendingBits -= 8;
+    }
+  }
+
+  // one past the last byte written
+  uint8_t *end() {
+    if (pendingBits > 0) {
+      *out++ = (uint8_t)pending;
+      pending = 0;
+      pendingBits = 0;
+    }
+    return out;
+  }
+};
+
+class BitReader {
+private:
+  const uint8_t *in;
+  const uint8_t *limit;
+  uint32_t pending = 0;
+  uint8_t pendingBits = 0;
+
+public:
+  BitReader(const uint8_t *source, const uint8_t *sourceEnd)
+    : in(source), limit(sourceEnd) {
+  }
+
+  // false once the stream runs out, width up to 24
+  bool read(uint8_t width, uint32_t &value) {
+    while (pendingBits < width) {
+      if (in == limit) {
+        return false;
+      }
+      pending |= (uint32_t)*in++ << pendingBits;
+      pendingBits += 8;
+    }
+    value = width == 0 ? 0 : pending & ((1u << width) - 1);
+    pending = width == 0 ? pending : pending >> width;
+    pendingBits -= width;
+    return true;
+  }
+
+  size_t bytesLeft() const {
+    return limit - in;
+  }
+};
+
+template <int Channels>
+class GloveEncoder {
+public:
+  static constexpr size_t kWidthBytes = (Channels + 1) / 2;
+  static constexpr size_t kMaxBytes = GLOVE_CODEC_HEADER_BYTES + kWidthBytes + Channels
+                                      + (GLOVE_CODEC_BLOCK_ROWS * (Channels * 8 + 24) + 7) / 8;
+  static constexpr size_t kMinBytes = GLOVE_CODEC_HEADER_BYTES + kWidthBytes + Channels;
+
+private:
+  uint8_t rows[GLOVE_CODEC_BLOCK_ROWS][Channels];
+  uint32_t timestamps[GLOVE_CODEC_BLOCK_ROWS];
+  uint16_t period = 0;
+  uint8_t count = 0;
+  uint8_t widths[Channels];
+  uint8_t timeWidth = 0;
+  bool keyframe = true;
+
+  uint8_t previous[Channels];  // last row of the block before
+  uint16_t sequence = 0;
+  uint8_t blocksSinceKeyframe = 0;
+  size_t limit = kMaxBytes;
+  size_t blockLimit = kMaxBytes;
+
+  uint8_t block[kMaxBytes];
+  size_t length = 0;
+
+  size_t packedBytes(uint8_t rowCount, const uint8_t *channelWidths, uint8_t jitterWidth) const {
+    uint32_t deltaRows = keyframe ? rowCount - 1 : rowCount;
+    uint32_t bits = 0;
+    for (int channel = 0; channel < Channels; channel++) {
+      bits += channelWidths[channel] * deltaRows;
+    }
+    bits += jitterWidth * (uint32_t)(rowCount > 2 ? rowCount - 2 : 0);
+    return GLOVE_CODEC_HEADER_BYTES + kWidthBytes + (keyframe ? Channels : 0) + (bits + 7) / 8;
+  }
+
+public:
+  GloveEncoder() {
+    reset();
+  }
+
+  // Next block is a keyframe numbered firstSequence, e.g. on a new connection
+  void reset(uint16_t firstSequence = 0) {
+    count = 0;
+    length = 0;
+    sequence = firstSequence;
+    blocksSinceKeyframe = 0;
+    keyframe = true;
+  }
+
+  // Largest block in bytes, e.g. the notification payload. Applies from the
+  // next block and never goes below what one keyframe row needs.
+  void setLimit(size_t bytes) {
+    limit = bytes < kMinBytes ? kMinBytes : (bytes > kMaxBytes ? kMaxBytes : bytes);
+  }
+
+  // Appends one row, false when it does not fit the block: too many rows or
+  // bytes, or an interval the 16 bit period and 24 bit jitter cannot hold.
+  // finish() the block, send it, clear() and push again.
+  bool push(const uint8_t *values, uint32_t timestamp) {
+    if (count == 0) {
+      blockLimit = limit;
+      period = 0;
+      timeWidth = 0;
+      for (int channel = 0; channel < Channels; channel++) {
+        widths[channel] = keyframe ? 0 : bitWidth(byteDelta(previous[channel], values[channel]));
+      }
+    } else {
+      if (count == GLOVE_CODEC_BLOCK_ROWS) {
+        return false;
+      }
+      uint32_t interval = timestamp - timestamps[count - 1];
+      uint8_t newTimeWidth = timeWidth;
+      if (count == 1) {
+        if (interval > 0xffff) {
+          return false;
+        }
+      } else {
+        newTimeWidth = bitWidth(zigzag((int32_t)(interval - period)));
+        newTimeWidth = newTimeWidth > timeWidth ? newTimeWidth : timeWidth;
+        if (newTimeWidth > 24) {
+          return false;
+        }
+      }
+      uint8_t newWidths[Channels];
+      for (int channel = 0; channel < Channels; channel++) {
+        uint8_t width = bitWidth(byteDelta(rows[count - 1][channel], values[channel]));
+        newWidths[channel] = width > widths[channel] ? width : widths[channel];
+      }
+      if (packedBytes(count + 1, newWidths, newTimeWidth) > blockLimit) {
+        return false;
+      }
+      if (count == 1) {
+        period = (uint16_t)interval;
+      }
+      timeWidth = newTimeWidth;
+      memcpy(widths, newWidths, sizeof(widths));
+    }
+    memcpy(rows[count], values, Channels);
+    timestamps[count] = timestamp;
+    count++;
+    return true;
+  }
+
+  bool push(const Inference_t &row, uint32_t timestamp) {
+    static_assert(Channels == sizeof(Inference_t), "an Inference_t row needs the 9 channel codec");
+    uint8_t values[Channels];
+    packRow(row, values);
+    return push(values, timestamp);
+  }
+
+  bool isFull() const {
+    return count == GLOVE_CODEC_BLOCK_ROWS;
+  }
+
+  bool isEmpty() const {
+    return count == 0;
+  }
+
+  // Timestamp of the oldest row waiting, for flushing on a deadline
+  uint32_t firstTimestamp() const {
+    return timestamps[0];
+  }
+
+  // Packs the rows pushed so far into data(), size() bytes
+  void finish() {
+    if (count == 0) {
+      length = 0;
+      return;
+    }
+    block[0] = GLOVE_CODEC_VERSION;
+    block[1] = (uint8_t)((keyframe ? 0x80 : 0) | count);
+    block[2] = (uint8_t)sequence;
+    block[3] = (uint8_t)(sequence >> 8);
+    block[4] = (uint8_t)timestamps[0];
+    block[5] = (uint8_t)(timestamps[0] >> 8);
+    block[6] = (uint8_t)(timestamps[0] >> 16);
+    block[7] = (uint8_t)(timestamps[0] >> 24);
+    block[8] = (uint8_t)period;
+    block[9] = (uint8_t)(period >> 8);
+    block[10] = timeWidth;
+    uint8_t *out = block + GLOVE_CODEC_HEADER_BYTES;
+    memset(out, 0, kWidthBytes);
+    for (int channel = 0; channel < Channels; channel++) {
+      out[channel / 2] |= widths[channel] << (channel % 2 * 4);
+    }
+    out += kWidthBytes;
+    if (keyframe) {
+      memcpy(out, rows[0], Channels);
+      out += Channels;
+    }
+    BitWriter bits(out);
+    for (int channel = 0; channel < Channels; channel++) {
+      uint8_t before = keyframe ? rows[0][channel] : previous[channel];
+      for (uint8_t row = keyframe ? 1 : 0; row < count; row++) {
+        bits.write(byteDelta(before, rows[row][channel]), widths[channel]);
+        before = rows[row][channel];
+      }
+    }
+    for (uint8_t row = 2; row < count; row++) {
+      bits.write(zigzag((int32_t)(timestamps[row] - timestamps[row - 1] - period)), timeWidth);
+    }
+    length = bits.end() - block;
+  }
+
+  const uint8_t *data() const {
+    return block;
+  }
+
+  size_t size() const {
+    return length;
+  }
+
+  // Call once the block is sent, the next one continues from its last row
+  void clear() {
+    if (count == 0) {
+      return;
+    }
+    memcpy(previous, rows[count - 1], Channels);
+    count = 0;
+    length = 0;
+    sequence++;
+    blocksSinceKeyframe = keyframe ? 1 : blocksSinceKeyframe + 1;
+    keyframe = blocksSinceKeyframe >= GLOVE_CODEC_KEYFRAME_BLOCKS;
+  }
+};
+
+template <int Channels>
+class GloveDecoder {
+private:
+  uint8_t previous[Channels];
+  bool synced = false;  // previous holds the last row of the block before
+  bool started = false;
+  uint16_t expected = 0;
+  uint32_t lostBlocks = 0;
+  uint32_t skippedBlocks = 0;
+
+public:
+  void reset() {
+    synced = false;
+    started = false;
+    lostBlocks = 0;
+    skippedBlocks = 0;
+  }
+
+  // Decodes one block into rows and timestamps, returns the row count, 0
+  // when the block was skipped waiting for a keyframe after a loss, or -1
+  // when it is not a valid block or rows is too small
+  int decode(const uint8_t *block, size_t length, uint8_t (*rows)[Channels], uint32_t *timestamps, size_t capacity) {
+    constexpr size_t kWidthBytes = (Channels + 1) / 2;
+    if (length < GLOVE_CODEC_HEADER_BYTES + kWidthBytes || block[0] != GLOVE_CODEC_VERSION) {
+      return -1;
+    }
+    bool keyframe = (block[1] & 0x80) != 0;
+    uint8_t count = block[1] & 0x7f;
+    uint8_t timeWidth = block[10];
+    if (count == 0 || count > capacity || timeWidth > 24) {
+      return -1;
+    }
+    uint8_t widths[Channels];
+    const uint8_t *in = block + GLOVE_CODEC_HEADER_BYTES;
+    for (int channel = 0; channel < Channels; channel++) {
+      widths[channel] = (in[channel / 2] >> (channel % 2 * 4)) & 0x0f;
+      if (widths[channel] > 8) {
+        return -1;
+      }
+    }
+    in += kWidthBytes;
+    if (keyframe && (size_t)(block + length - in) < (size_t)Channels) {
+      return -1;
+    }
+
+    uint16_t sequence = (uint16_t)(block[2] | block[3] << 8);
+    if (started && sequence != expected) {
+      // the 16 bit difference survives the sequence wrapping
+      lostBlocks += (uint16_t)(sequence - expected);
+      synced = false;
+    }
+    started = true;
+    expected = sequence + 1;
+    if (!keyframe && !synced) {
+      skippedBlocks++;
+      return 0;
+    }
+
+    uint8_t before[Channels];
+    if (keyframe) {
+      memcpy(rows[0], in, Channels);
+      memcpy(before, in, Channels);
+      in += Channels;
+    } else {
+      memcpy(before, previous, Channels);
+    }
+    BitReader bits(in, block + length);
+    uint8_t first = keyframe ? 1 : 0;
+    for (int channel = 0; channel < Channels; channel++) {
+      uint8_t value = before[channel];
+      for (uint8_t row = first; row < count; row++) {
+        uint32_t delta;
+        if (!bits.read(widths[channel], delta)) {
+          synced = false;
+          return -1;
+        }
+        value = (uint8_t)(value + unzigzag(delta));
+        rows[row][channel] = value;
+      }
+    }
+    uint32_t period = (uint32_t)(block[8] | block[9] << 8);
+    timestamps[0] = (uint32_t)block[4] | (uint32_t)block[5] << 8 | (uint32_t)block[6] << 16 | (uint32_t)block[7] << 24;
+    if (count > 1) {
+      timestamps[1] = timestamps[0] + period;
+    }
+    for (uint8_t row = 2; row < count; row++) {
+      uint32_t jitter;
+      if (!bits.read(timeWidth, jitter)) {
+        synced = false;
+        return -1;
+      }
+      timestamps[row] = timestamps[row - 1] + period + (uint32_t)unzigzag(jitter);
+    }
+    // anything past the padding byte is not a block this encoder wrote
+    if (bits.bytesLeft() != 0) {
+      synced = false;
+      return -1;
+    }
+    memcpy(previous, rows[count - 1], Channels);
+    synced = true;
+    return count;
+  }
+
+  // Blocks missing between the ones decoded so far
+  uint32_t lost() const {
+    return lostBlocks;
+  }
+
+  // Blocks decoded but dropped while waiting for a keyframe
+  uint32_t skipped() const {
+    return skippedBlocks;
+  }
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <Arduino.h>
+#include "types.h"
+
+// Samples all five bend sensors as one frame per tick.
+// When every pin is on ADC1 the ADC runs in continuous (DMA) mode: the
+// hardware converts FINGER_OVERSAMPLING samples per pin per frame at a fixed
+// rate and the conversion-done interrupt wakes the waiting task. Continuous
+// mode is ADC1 only, so if any pin is on ADC2 it falls back to one-shot reads
+// paced by vTaskDelayUntil from the same single task.
+class HandSampler {
+private:
+  uint8_t pins[FINGER_COUNT];  // handData_t order: pinky, ring, middle, index, thumb
+  bool continuousMode = false;
+  bool started = false;
+  TickType_t lastWake = 0;
+  static TaskHandle_t waitingTask;
+
+  static void IRAM_ATTR conversionDone() {
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    if (waitingTask != NULL) {
+      vTaskNotifyGiveFromISR(waitingTask, &higherPriorityTaskWoken);
+    }
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+  }
+
+public:
+  HandSampler() {
+  }
+
+  bool begin(uint8_t pinkyPin, uint8_t ringPin, uint8_t middlePin, uint8_t indexPin, uint8_t thumbPin) {
+    pins[0] = pinkyPin;
+    pins[1] = ringPin;
+    pins[2] = middlePin;
+    pins[3] = indexPin;
+    pins[4] = thumbPin;
+
+    analogContinuousSetWidth(12);
+    analogContinuousSetAtten(ADC_11db);
+    continuousMode = analogContinuous(pins, FINGER_COUNT, FINGER_OVERSAMPLING,
+                                      FINGER_SAMPLING_RATE * FINGER_OVERSAMPLING * FINGER_COUNT, &conversionDone);
+    if (!continuousMode) {
+      for (uint8_t finger = 0; finger < FINGER_COUNT; finger++) {
+        pinMode(pins[finger], INPUT);
+      }
+    }
+    return continuousMode;
+  }
+
+  bool isContinuous() {
+    return continuousMode;
+  }
+
+  // Blocks until the next frame and writes the raw 12-bit value of each
+  // finger into rawValues. Must always be called from the same task.
+  bool waitFrame(uint16_t rawValues[FINGER_COUNT]) {
+    if (!started) {
+      waitingTask = xTaskGetCurrentTaskHandle();
+      lastWake = xTaskGetTickCount();
+      if (continuousMode) {
+        analogContinuousStart();
+      }
+      started = true;
+    }
+
+    if (!continuousMode) {
+      vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(1000 / FINGER_SAMPLING_RATE));
+      for (uint8_t finger = 0; finger < FINGER_COUNT; finger++) {
+        rawValues[finger] = analogRead(pins[finger]);
+      }
+      return true;
+    }
+
+    // a frame takes 1000 / FINGER_SAMPLING_RATE ms, give it twice that
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(2000 / FINGER_SAMPLING_RATE) + 1) == 0) {
+      return false;
+    }
+    adc_continuos_data_t *frame = NULL;
+    if (!analogContinuousRead(&frame, 0) || frame == NULL) {
+      return false;
+    }
+    // results come back in the order the pins were registered
+    for (uint8_t finger = 0; finger < FINGER_COUNT; finger++) {
+      rawValues[finger] = frame[finger].avg_read_raw;
+    }
+    return true;
+  }
+};
+
+TaskHandle_t HandSampler::waitingTask = NULL;
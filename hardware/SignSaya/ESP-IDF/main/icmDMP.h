@@ -1,4 +1,5 @@
 #include "../components/ICM20948/ICM_20948.h"  // Click here to get the library: http://librarymanager/All#SparkFun_ICM_20948_IMU
+#include "quatQuantize.h"
 
 bool AD0_VAL = 0;
 
@@ -14,6 +15,33 @@ private:
   quaternion_t results;
   icm_20948_DMP_data_t data;
 
+  // raw FIFO bytes from the last burst, parsed in memory
+  uint8_t fifoBuffer[ICM_FIFO_BUFFER];
+  uint16_t fifoLength = 0;
+  uint16_t fifoOffset = 0;
+  // packets of a burst are spread evenly between the previous drain and this one
+  uint32_t lastDrainTime = 0;
+  uint32_t drainTime = 0;
+  uint16_t burstPackets = 0;
+  uint16_t packetIndex = 0;
+  uint32_t packetTime = 0;
+
+  uint16_t countPackets() {
+    icm_20948_DMP_data_t scratch;
+    uint16_t offset = fifoOffset;
+    uint16_t packets = 0;
+    uint16_t consumed = 0;
+    while (offset < fifoLength) {
+      myICM.parseDMPdata(&fifoBuffer[offset], fifoLength - offset, &scratch, &consumed);
+      if (consumed == 0) {
+        break;
+      }
+      offset += consumed;
+      packets++;
+    }
+    return packets;
+  }
+
 
 public:
 #ifdef USE_SPI
@@ -104,6 +132,14 @@ public:
     //success &= (myICM.setDMPODRrate(DMP_ODR_Reg_Cpass, 0) == ICM_20948_Stat_Ok); // Set to the maximum
     //success &= (myICM.setDMPODRrate(DMP_ODR_Reg_Cpass_Calibr, 0) == ICM_20948_Stat_Ok); // Set to the maximum
 
+    // Raise the DMP interrupt every packet or two, whatever is waiting gets drained in one burst
+    static_assert((ICM_FIFO_WATERMARK / ICM_PACKET_BYTES + 1) * 1000 / ICM_DMP_RATE < IMU_INTERRUPT_TIMEOUT,
+                  "ICM_FIFO_WATERMARK fills slower than IMU_INTERRUPT_TIMEOUT, the drain would run on the timeout");
+    const unsigned char watermark[2] = { (unsigned char)(ICM_FIFO_WATERMARK >> 8), (unsigned char)(ICM_FIFO_WATERMARK & 0xFF) };
+    success &= (myICM.writeDMPmems(FIFO_WATERMARK, 2, &watermark[0]) == ICM_20948_Stat_Ok);
+    success &= (myICM.cfgIntActiveLow(false) == ICM_20948_Stat_Ok);
+    success &= (myICM.cfgIntLatch(false) == ICM_20948_Stat_Ok);  // 50us pulse on IMU_INTERRUPT
+
     // Enable the FIFO
     success &= (myICM.enableFIFO() == ICM_20948_Stat_Ok);
 
@@ -134,13 +170,68 @@ public:
 #endif
   }
 
+  // Reads everything in the FIFO with one count read and one burst read,
+  // checkDataReady() then walks the packets without touching the bus
+  void drainFIFO() {
+    // keep a packet that was only partly in the FIFO last time
+    uint16_t leftover = fifoLength - fifoOffset;
+    memmove(fifoBuffer, &fifoBuffer[fifoOffset], leftover);
+    fifoLength = leftover;
+    fifoOffset = 0;
+
+    uint16_t fifoCount = 0;
+    if (myICM.getFIFOcount(&fifoCount) != ICM_20948_Stat_Ok) {
+      // the kept partial packet waits for the next drain
+      burstPackets = 0;
+      packetIndex = 0;
+      return;
+    }
+    uint16_t space = sizeof(fifoBuffer) - fifoLength;
+    if (fifoCount > space) {
+      fifoCount = space;
+    }
+    if (fifoCount > 0 && myICM.readFIFOburst(&fifoBuffer[fifoLength], fifoCount) != ICM_20948_Stat_Ok) {
+      // the burst reads in chunks, the ones before the failure are already out
+      // of the FIFO and the packet boundaries are lost with them
+      resetFIFO();
+      drainTime = micros();
+      return;
+    }
+    fifoLength += fifoCount;
+
+    uint32_t now = micros();
+    lastDrainTime = (drainTime == 0) ? now : drainTime;
+    drainTime = now;
+    burstPackets = countPackets();
+    packetIndex = 0;
+
+    // a full buffer without a single complete packet means the stream is out of sync
+    if (burstPackets == 0 && fifoLength == sizeof(fifoBuffer)) {
+      resetFIFO();
+    }
+  }
+
   bool checkDataReady() {
-    myICM.readDMPdataFromFIFO(&data);
+    if (fifoOffset >= fifoLength || packetIndex >= burstPackets) {
+      return false;
+    }
+    uint16_t consumed = 0;
+    myICM.parseDMPdata(&fifoBuffer[fifoOffset], fifoLength - fifoOffset, &data, &consumed);
+    if (consumed == 0) {
+      return false;
+    }
+    fifoOffset += consumed;
+    packetIndex++;
+    packetTime = lastDrainTime + (uint32_t)((uint64_t)(drainTime - lastDrainTime) * packetIndex / burstPackets);
     return ((myICM.status == ICM_20948_Stat_Ok) || (myICM.status == ICM_20948_Stat_FIFOMoreDataAvail));
   }
 
   void resetFIFO() {
     myICM.resetFIFO();
+    fifoLength = 0;
+    fifoOffset = 0;
+    burstPackets = 0;
+    packetIndex = 0;
   }
 
   quaternion_t getData() {
@@ -151,6 +242,9 @@ public:
       // In case of drift, the sum will not add to 1, therefore, quaternion data need to be corrected with right bias values.
       // The quaternion data is scaled by 2^30.
 
+#ifdef USE_FIXED_QUATERNION
+      quantizeQuat9(data.Quat9.Data.Q1, data.Quat9.Data.Q2, data.Quat9.Data.Q3, results);
+#else
       // Scale to +/- 1
       double q1 = ((double)data.Quat9.Data.Q1) / 1073741824.0;  // Convert to double. Divide by 2^30
       double q2 = ((double)data.Quat9.Data.Q2) / 1073741824.0;  // Convert to double. Divide by 2^30
@@ -161,6 +255,8 @@ public:
       results.y = (uint8_t)((q2 + 1.0f) * 127.5f);
       results.z = (uint8_t)((q3 + 1.0f) * 127.5f);
       results.w = (uint8_t)((q0 + 1.0f) * 127.5f);
+#endif
+      results.timestamp = packetTime;
 #ifdef USE_LOGGING
       // Serial.print(q1);
       // Serial.print(", ");
@@ -176,4 +272,14 @@ public:
     }
     return results;
   }
+
+  // The packet getData() last converted as the DMP wrote it, for sensor traces
+  rawQuaternion_t getRawData() {
+    rawQuaternion_t raw;
+    raw.q1 = data.Quat9.Data.Q1;
+    raw.q2 = data.Quat9.Data.Q2;
+    raw.q3 = data.Quat9.Data.Q3;
+    raw.timestamp = packetTime;
+    return raw;
+  }
 };
@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Ping-pong pair of window buffers between the parser (producer) and the
+// inference task (consumer). Ownership moves with a compare-and-swap on each
+// buffer's state, so the window is never copied on the way across and
+// neither side ever waits for the other: while the consumer runs on one
+// buffer the producer fills the other.
+//
+// Policy when inference falls behind: coalesce. At most one buffer is ever
+// Ready; publishing while one is still unread reclaims it and writes the
+// newer window over it, adding its new row count to the unread one's so the
+// streaming model still sees every row since the window it last ran on.
+#define HANDOFF_BUFFERS 2
+
+class InferenceHandoff {
+private:
+  enum : uint8_t {
+    Free,
+    Filling,  // owned by the producer
+    Ready,    // published, not taken yet
+    Busy      // owned by the consumer
+  };
+
+  uint8_t *buffers[HANDOFF_BUFFERS] = {};
+  std::atomic<uint8_t> states[HANDOFF_BUFFERS];
+  uint32_t rows[HANDOFF_BUFFERS] = {};  // rows since the last window taken, set before Ready
+  std::atomic<uint32_t> coalescedWindows{ 0 };
+
+  bool claim(uint8_t index, uint8_t from, uint8_t to) {
+    uint8_t expected = from;
+    return states[index].compare_exchange_strong(expected, to);
+  }
+
+public:
+  InferenceHandoff() {
+    for (uint8_t index = 0; index < HANDOFF_BUFFERS; index++) {
+      states[index].store(Free);
+    }
+  }
+
+  void begin(uint8_t *first, uint8_t *second) {
+    buffers[0] = first;
+    buffers[1] = second;
+    reset();
+  }
+
+  // Only while neither task is running, e.g. with both suspended
+  void reset() {
+    for (uint8_t index = 0; index < HANDOFF_BUFFERS; index++) {
+      states[index].store(Free);
+      rows[index] = 0;
+    }
+  }
+
+  // Producer: a buffer to write the next window into, or -1 if both are
+  // taken. An unread window is reclaimed before a free buffer is used.
+  int8_t acquire() {
+    for (uint8_t index = 0; index < HANDOFF_BUFFERS; index++) {
+      if (claim(index, Ready, Filling)) {
+        coalescedWindows++;
+        return index;
+      }
+    }
+    for (uint8_t index = 0; index < HANDOFF_BUFFERS; index++) {
+      if (claim(index, Free, Filling)) {
+        rows[index] = 0;
+        return index;
+      }
+    }
+    return -1;
+  }
+
+  uint8_t *buffer(int8_t index) const {
+    return buffers[index];
+  }
+
+  // Producer: hands the filled buffer over, newRows being the rows pushed
+  // since the window that went into it was last linearized
+  void publish(int8_t index, uint32_t newRows) {
+    rows[index] += newRows;
+    states[index].store(Ready);
+  }
+
+  // Consumer: the published window and its new row count, or -1 if none
+  int8_t take(uint32_t &newRows) {
+    for (uint8_t index = 0; index < HANDOFF_BUFFERS; index++) {
+      if (claim(index, Ready, Busy)) {
+        newRows = rows[index];
+        return index;
+      }
+    }
+    return -1;
+  }
+
+  // Consumer: done with the buffer from take()
+  void release(int8_t index) {
+    states[index].store(Free);
+  }
+
+  // Windows overwritten before inference got to them
+  uint32_t coalesced() const {
+    return coalescedWindows.load();
+  }
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "types.h"
+
+// Sliding window of the last INFERENCE_LENGTH samples.
+// Samples are stored already in the model's feature order, so push() is a
+// single 9 byte write and the full window is only linearized (two memcpy)
+// when an inference is actually triggered.
+class InferenceWindow {
+private:
+  uint8_t ringArray[INFERENCE_LENGTH * INFERENCE_FEATURES];
+  uint16_t head = 0;  // index of the oldest row
+  uint16_t newEntries = 0;
+
+public:
+  // Starts zeroed so oldestIsValid() holds off inference until the window is full of real samples
+  InferenceWindow() {
+    fill(0);
+  }
+
+  void fill(uint8_t value) {
+    memset(ringArray, value, sizeof(ringArray));
+    head = 0;
+    newEntries = 0;
+  }
+
+  // Overwrites the oldest row with the new sample, O(1)
+  void push(const Inference_t &entry) {
+    uint8_t *row = &ringArray[head * INFERENCE_FEATURES];
+    row[0] = entry.thumb;
+    row[1] = entry.index;
+    row[2] = entry.middle;
+    row[3] = entry.ring;
+    row[4] = entry.pinky;
+    row[5] = entry.x;
+    row[6] = entry.y;
+    row[7] = entry.z;
+    row[8] = entry.w;
+
+    head++;
+    if (head >= INFERENCE_LENGTH) {
+      head = 0;
+    }
+    if (newEntries < UINT16_MAX) {
+      newEntries++;
+    }
+  }
+
+  // Row i of the window, 0 being the oldest sample
+  const uint8_t *row(uint16_t index) const {
+    uint32_t position = head + index;
+    if (position >= INFERENCE_LENGTH) {
+      position -= INFERENCE_LENGTH;
+    }
+    return &ringArray[position * INFERENCE_FEATURES];
+  }
+
+  // Oldest sample has valid IMU data, same check the parser used on inferenceArray[0]
+  bool oldestIsValid() const {
+    const uint8_t *oldest = row(0);
+    return oldest[5] != 0 && oldest[6] != 0 && oldest[7] != 0 && oldest[8] != 0;
+  }
+
+  // Number of samples pushed since the last linearize()
+  uint16_t pending() const {
+    return newEntries;
+  }
+
+  // Copies the window oldest-first into dest (INFERENCE_LENGTH * INFERENCE_FEATURES bytes)
+  void linearize(uint8_t *dest) {
+    uint32_t tailBytes = (INFERENCE_LENGTH - head) * INFERENCE_FEATURES;
+    memcpy(dest, &ringArray[head * INFERENCE_FEATURES], tailBytes);
+    memcpy(dest + tailBytes, ringArray, head * INFERENCE_FEATURES);
+    newEntries = 0;
+  }
+};
@@ -3,12 +3,37 @@
 #include "config.h"
 #include "types.h"
 #include "bleSetup.h"
+#include "spscRing.h"
 
 #ifdef USE_TFLITE
 #include "aiTest.h"
+#include "inferenceWindow.h"
+#include "sensorFusion.h"
+#include "inferenceHandoff.h"
 AiModel aiInstance;
+EXT_RAM_BSS_ATTR InferenceWindow inferenceWindow;
+EXT_RAM_BSS_ATTR uint8_t windowBuffers[HANDOFF_BUFFERS][INFERENCE_LENGTH * INFERENCE_FEATURES];
+InferenceHandoff inferenceHandoff;
 #else
 #include "tensorflow/lite/micro/micro_log.h"
+#ifdef USE_BLE_BATCH
+#include "sensorFusion.h"
+#include "bleFrame.h"
+#ifdef USE_BLE_COMPRESSION
+#include "gloveCodec.h"
+GloveEncoder<INFERENCE_FEATURES> frameWriter;
+BleFrameWriter smallFrameWriter;  // while a keyframe does not fit the MTU, byte 0 tells the formats apart
+#else
+BleFrameWriter frameWriter;
+#endif
+#endif
+#endif
+#if defined(USE_TFLITE) || defined(USE_BLE_BATCH)
+#ifdef FUSION_INTERPOLATE
+SensorFusion sensorFusion(FUSION_RATE, FUSION_DELAY_US, true);
+#else
+SensorFusion sensorFusion(FUSION_RATE, FUSION_DELAY_US, false);
+#endif
 #endif
 
 #ifdef USE_SPI
@@ -26,42 +51,52 @@ AiModel aiInstance;
 #endif
 
 #include "fingers.h"
+#include "handSampler.h"
+#include "signPipeline.h"
 
 accelSensor ACCEL;
 bleInstance ble;
 
-FingerInstance pinkyFinger;
-FingerInstance ringFinger;
-FingerInstance middleFinger;
-FingerInstance indexFinger;
-FingerInstance thumbFinger;
+FingerInstance<FINGER_FILTER> pinkyFinger;
+FingerInstance<FINGER_FILTER> ringFinger;
+FingerInstance<FINGER_FILTER> middleFinger;
+FingerInstance<FINGER_FILTER> indexFinger;
+FingerInstance<FINGER_FILTER> thumbFinger;
+FingerInstance<FINGER_FILTER> *const fingerInstances[FINGER_COUNT] = { &pinkyFinger, &ringFinger, &middleFinger,
+                                                                       &indexFinger, &thumbFinger };
+HandSampler handSampler;
 
 int packageSent = 0;
 
-QueueHandle_t pinkyQueue;
-QueueHandle_t ringQueue;
-QueueHandle_t middleQueue;
-QueueHandle_t indexQueue;
-QueueHandle_t thumbQueue;
-QueueHandle_t handQueue;
-QueueHandle_t IMUQueue;
+SpscRing<handData_t, HAND_QUEUE_LENGTH> handQueue;
+SpscRing<quaternion_t, IMU_QUEUE_LENGTH> IMUQueue;
 
+#if defined(USE_SENSOR_TRACE) && !defined(USE_TRAIN_RECORDER)
+#error "USE_SENSOR_TRACE records through the train recorder, define USE_TRAIN and USE_TRAIN_RECORDER too"
+#endif
 #ifdef USE_TRAIN
-QueueHandle_t fingerTrainQueue;
-QueueHandle_t imuTrainQueue;
+SpscRing<handData_t, TRAIN_QUEUE_LENGTH> fingerTrainQueue;
+SpscRing<quaternion_t, TRAIN_QUEUE_LENGTH> imuTrainQueue;
 TaskHandle_t trainPrinter;
+#ifdef USE_TRAIN_RECORDER
+#ifdef USE_SENSOR_TRACE
+SpscRing<rawHandData_t, TRAIN_QUEUE_LENGTH> rawFingerTrainQueue;
+SpscRing<rawQuaternion_t, TRAIN_QUEUE_LENGTH> rawImuTrainQueue;
+#endif
+#include "trainRecorder.h"
+TrainRecorder trainRecorder;
+TaskHandle_t trainWriter;
+void trainRecordFunc(void *pvParameters);
+void trainWriteFunc(void *pvParameters);
+#else
 void trainPrintFunc(void *pvParameters);
 #endif
+#endif
 
 TaskHandle_t imuTask;
 TaskHandle_t imuChecker;
-TaskHandle_t pinkyTask;
-TaskHandle_t ringTask;
-TaskHandle_t middleTask;
-TaskHandle_t indexTask;
-TaskHandle_t thumbTask;
+TaskHandle_t handTask;
 TaskHandle_t imuSenderTask;
-TaskHandle_t parserTask;
 TaskHandle_t calibrateGlovesTask;
 
 int missedIMUData = 0;
@@ -69,11 +104,7 @@ int missedIMUData = 0;
 long lastCountdown = 0;
 bool isRunning = false;
 
-uint8_t pinkyHZ = 0;
-uint8_t ringHZ = 0;
-uint8_t middleHZ = 0;
-uint8_t indexHZ = 0;
-uint8_t thumbHZ = 0;
+uint8_t handHZ = 0;
 
 uint8_t readHZ = 0;
 uint8_t writeHZ = 0;
@@ -82,7 +113,6 @@ uint8_t core1Tel = 0;
 uint8_t core0Tel = 0;
 
 
-#ifndef USE_ICM
 // Interrupt Service Routine (ISR)
 void IRAM_ATTR sensorISR() {
 
@@ -91,25 +121,18 @@ void IRAM_ATTR sensorISR() {
   }
   // Send notification to task (replace with specific notification value as needed)
 }
-#endif
 void bleChecker(void *pvParameters);
 #ifdef USE_IMU
 void accelGyroSender(void *pvParameters) ;
 void accelGyroFunc(void *pvParameters) ;
 #endif
 #ifdef USE_FINGERS
-void fingerSender(void *pvParameters) ;
-void pinkyFingerFunc(void *pvParameters);
-void ringFingerFunc(void *pvParameters) ;
-void middleFingerFunc(void *pvParameters);
-void indexFingerFunc(void *pvParameters) ;
-void thumbFingerFunc(void *pvParameters) ;
+void handSamplerFunc(void *pvParameters);
 #endif
 
 #ifdef USE_TFLITE
-EXT_RAM_BSS_ATTR QueueHandle_t imuInferenceData;
-EXT_RAM_BSS_ATTR QueueHandle_t fingerInferenceData;
-EXT_RAM_BSS_ATTR QueueHandle_t inferenceDataQueue;
+SpscRing<quaternion_t, IMU_QUEUE_LENGTH> imuInferenceData;
+SpscRing<handData_t, HAND_QUEUE_LENGTH> fingerInferenceData;
 TaskHandle_t inferTask;
 TaskHandle_t inferParser;
 StaticTask_t inferTaskBuffer;
@@ -118,7 +141,6 @@ EXT_RAM_BSS_ATTR static StackType_t inferTaskStack[ INFERENCE_STACK_SIZE ];
 EXT_RAM_BSS_ATTR static StackType_t parseTaskStack[ INFERENCE_PARSER_STACK_SIZE ];
 void aiInferenceFunc(void *pvParameters);
 void aiInferenceParser(void *pvParameters);
-bool inferReady = true;
 #endif
 #ifdef USE_LOGGING
 void telemetryCore0(void *pvParameters) ;
@@ -138,11 +160,15 @@ void setup() {
   middleFinger.begin((digitalRead(HAND_PIN) ? RING_PIN : MIDDLE_PIN));
   indexFinger.begin((digitalRead(HAND_PIN) ? PINKY_PIN : INDEX_PIN));
   thumbFinger.begin((digitalRead(HAND_PIN) ? HAND_PIN : THUMB_PIN));
+  // falls back to one-shot reads from the same task if a pin is not on ADC1
+  handSampler.begin((digitalRead(HAND_PIN) ? INDEX_PIN : PINKY_PIN),
+                    (digitalRead(HAND_PIN) ? MIDDLE_PIN : RING_PIN),
+                    (digitalRead(HAND_PIN) ? RING_PIN : MIDDLE_PIN),
+                    (digitalRead(HAND_PIN) ? PINKY_PIN : INDEX_PIN),
+                    (digitalRead(HAND_PIN) ? HAND_PIN : THUMB_PIN));
 #endif
 
-#ifndef USE_ICM
   attachInterrupt(digitalPinToInterrupt(IMU_INTERRUPT), sensorISR, RISING);
-#endif
 #ifdef USE_LOGGING
   Serial.begin(115200);
 
@@ -163,9 +189,7 @@ void setup() {
 
 #ifdef USE_TFLITE
   aiInstance.begin();
-  imuInferenceData = xQueueCreate(INFERENCE_LENGTH, sizeof(quaternion_t));
-  fingerInferenceData = xQueueCreate(INFERENCE_LENGTH, sizeof(handData_t));
-  inferenceDataQueue = xQueueCreate(1, sizeof(uint8_t) * INFERENCE_LENGTH * INFERENCE_FEATURES);
+  inferenceHandoff.begin(windowBuffers[0], windowBuffers[1]);
 #endif
 
 #ifdef USE_SPI
@@ -174,20 +198,20 @@ void setup() {
   ACCEL.begin(I2C_SDA_PIN, I2C_SCL_PIN);
 #endif
 
-  pinkyQueue = xQueueCreate(FINGER_QUEUE_LENGTH, sizeof(uint8_t));
-  ringQueue = xQueueCreate(FINGER_QUEUE_LENGTH, sizeof(uint8_t));
-  middleQueue = xQueueCreate(FINGER_QUEUE_LENGTH, sizeof(uint8_t));
-  indexQueue = xQueueCreate(FINGER_QUEUE_LENGTH, sizeof(uint8_t));
-  thumbQueue = xQueueCreate(FINGER_QUEUE_LENGTH, sizeof(uint8_t));
-
-  handQueue = xQueueCreate(HAND_QUEUE_LENGTH, sizeof(handData_t));
-  IMUQueue = xQueueCreate(IMU_QUEUE_LENGTH, sizeof(quaternion_t));
-
   #ifdef USE_TRAIN
-    fingerTrainQueue = xQueueCreate(TRAIN_QUEUE_LENGTH, sizeof(handData_t));
-    imuTrainQueue = xQueueCreate(TRAIN_QUEUE_LENGTH, sizeof(quaternion_t));
+  #ifdef USE_TRAIN_RECORDER
+  // the writer only ever runs when nothing else wants the core
+  xTaskCreatePinnedToCore(&trainWriteFunc, "trainWrite", TRAIN_WRITE_STACK_SIZE, NULL, tskIDLE_PRIORITY, &trainWriter, SYSTEMCORE);
+  if (!trainRecorder.begin(trainWriter)) {
+#ifdef USE_LOGGING
+    Serial.println("No ffat partition to record to, samples are counted as lost");
+#endif
+  }
+  xTaskCreatePinnedToCore(&trainRecordFunc, "trainRecord", TRAIN_RECORD_STACK_SIZE, NULL, FINGER_PRIORITY, &trainPrinter, SYSTEMCORE);
+  #else
+  xTaskCreatePinnedToCore(&trainPrintFunc, "trainPrint", 3072, NULL, FINGER_PRIORITY, &trainPrinter, SYSTEMCORE);
+  #endif
   #endif
-
   xTaskCreate(&bleChecker, "bleBoss", 3072, NULL, 1, NULL);
   #ifdef USE_LOGGING
     xTaskCreatePinnedToCore(&telPrint, "telPrint", 10240, NULL, 1, NULL, SYSTEMCORE);
@@ -199,22 +223,15 @@ void setup() {
   inferTask = xTaskCreateStaticPinnedToCore(aiInferenceFunc, "inferFunc", INFERENCE_STACK_SIZE, NULL, SYSTEM_PRIORITY, inferTaskStack, &inferTaskBuffer, SYSTEMCORE);
   inferParser = xTaskCreateStaticPinnedToCore(aiInferenceParser, "aiSupport", INFERENCE_PARSER_STACK_SIZE, NULL, SYSTEM_PRIORITY, parseTaskStack, &parseTaskBuffer, APPCORE);
   #endif
-  // Start Finger Tasks
-  xTaskCreatePinnedToCore(&pinkyFingerFunc, "pinkyFunc", FINGER_STACK_SIZE, NULL, FINGER_PRIORITY, &pinkyTask, APPCORE);
-  vTaskDelay(5);
-  xTaskCreatePinnedToCore(&ringFingerFunc, "ringFunc", FINGER_STACK_SIZE, NULL, FINGER_PRIORITY, &ringTask, APPCORE);
-  vTaskDelay(5);
-  xTaskCreatePinnedToCore(&middleFingerFunc, "middleFunc", FINGER_STACK_SIZE, NULL, FINGER_PRIORITY, &middleTask, APPCORE);
-  vTaskDelay(5);
-  xTaskCreatePinnedToCore(&indexFingerFunc, "indexFunc", FINGER_STACK_SIZE, NULL, FINGER_PRIORITY, &indexTask, APPCORE);
-  vTaskDelay(5);
-  xTaskCreatePinnedToCore(&thumbFingerFunc, "thumbFunc", FINGER_STACK_SIZE, NULL, FINGER_PRIORITY, &thumbTask, APPCORE);
-  xTaskCreatePinnedToCore(&fingerSender, "fingerSender", 10240, NULL, SYSTEM_PRIORITY, &parserTask, SYSTEMCORE);
+  // Start Finger Task
+  xTaskCreatePinnedToCore(&handSamplerFunc, "handFunc", HAND_STACK_SIZE, NULL, FINGER_PRIORITY, &handTask, APPCORE);
   
   // Start MPU Task
   xTaskCreatePinnedToCore(&accelGyroFunc, "mpuFunc", MPU_STACK_SIZE, NULL, ACCEL_PRIORITY, &imuTask, APPCORE);
   #ifndef USE_TFLITE
   xTaskCreatePinnedToCore(&accelGyroSender, "mpuSender", MPU_STACK_SIZE, NULL, SYSTEM_PRIORITY, &imuSenderTask, SYSTEMCORE);
+  // woken per IMU sample
+  IMUQueue.notify(imuSenderTask);
   #endif
 }
 
@@ -227,15 +244,54 @@ void loop() {
 /*--------------------------------------------------*/
 
 #ifdef USE_TRAIN
+#ifdef USE_TRAIN_RECORDER
+void trainRecordFunc(void *pvParameters) {
+  handData_t fingerData;
+  quaternion_t imuData;
+#ifdef USE_SENSOR_TRACE
+  rawHandData_t rawFingerData;
+  rawQuaternion_t rawImuData;
+#endif
+  for (;;) {
+    while (fingerTrainQueue.pop(fingerData)) {
+      trainRecorder.add(fingerData);
+    }
+    while (imuTrainQueue.pop(imuData)) {
+      trainRecorder.add(imuData);
+    }
+#ifdef USE_SENSOR_TRACE
+    while (rawFingerTrainQueue.pop(rawFingerData)) {
+      trainRecorder.add(rawFingerData);
+    }
+    while (rawImuTrainQueue.pop(rawImuData)) {
+      trainRecorder.add(rawImuData);
+    }
+    trainRecorder.setUpstreamLost(fingerTrainQueue.overflowed() + imuTrainQueue.overflowed()
+                                  + rawFingerTrainQueue.overflowed() + rawImuTrainQueue.overflowed());
+#else
+    trainRecorder.setUpstreamLost(fingerTrainQueue.overflowed() + imuTrainQueue.overflowed());
+#endif
+    trainRecorder.flushOlderThan(micros(), TRAIN_RECORD_FLUSH_MS * 1000UL);
+    vTaskDelay(pdMS_TO_TICKS(TRAIN_RECORD_POLL_MS));
+  }
+}
+
+void trainWriteFunc(void *pvParameters) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    trainRecorder.writeReady();
+  }
+}
+#else
 void trainPrintFunc(void *pvParameters) {
   Serial.begin(115200);
   handData_t fingerData;
   quaternion_t imuData;
   char str[37];
   for (;;) {
-    int fingerReady = xQueueReceive(fingerTrainQueue, &fingerData, 0);
-    int imuReady = xQueueReceive(imuTrainQueue, &imuData, 0);
-    if (fingerReady == pdPASS || imuReady == pdPASS) {
+    bool fingerReady = fingerTrainQueue.pop(fingerData);
+    bool imuReady = imuTrainQueue.pop(imuData);
+    if (fingerReady || imuReady) {
       sprintf(
         str,
         "%d,%d,%d,%d,%d,%d,%d,%d,%d",
@@ -265,9 +321,7 @@ void bleChecker(void *pvParameters) {
     // MicroPrintf("Running, Lowest heap: %d", esp_get_minimum_free_heap_size());
     if (ble.isConnected() && !isRunning) {
       // start tasks
-#ifdef USE_ICM
         ACCEL.resetFIFO();
-#endif
 #ifdef USE_TRAIN
         vTaskResume(trainPrinter);
 #endif
@@ -275,13 +329,8 @@ void bleChecker(void *pvParameters) {
         vTaskResume(inferTask);
         vTaskResume(inferParser);
 #endif
-        vTaskResume(pinkyTask);
-        vTaskResume(ringTask);
-        vTaskResume(middleTask);
-        vTaskResume(indexTask);
-        vTaskResume(thumbTask);
+        vTaskResume(handTask);
         vTaskResume(imuTask);
-        vTaskResume(parserTask);
         isRunning = true;
 #ifdef USE_LOGGING
         Serial.println("Tasks successfuly ran");
@@ -294,13 +343,8 @@ void bleChecker(void *pvParameters) {
       vTaskSuspend(inferTask);
       vTaskSuspend(inferParser);
 #endif
-      vTaskSuspend(pinkyTask);
-      vTaskSuspend(ringTask);
-      vTaskSuspend(middleTask);
-      vTaskSuspend(indexTask);
-      vTaskSuspend(thumbTask);
+      vTaskSuspend(handTask);
       vTaskSuspend(imuTask);
-      vTaskSuspend(parserTask);
       isRunning = false;
       vTaskDelay(pdMS_TO_TICKS(500));
       ble.restartAdvertising();
@@ -310,116 +354,47 @@ void bleChecker(void *pvParameters) {
 }
 #ifdef USE_TFLITE
 
+#ifdef USE_PROFILING
+void profileReport(){
+  OpProfiler &profiler = aiInstance.profiler();
+  char row[128];
+  profiler.logCsv();
+  ble.profileWrite(OpProfiler::csvHeader());
+  for(uint8_t index = 0; index < profiler.size(); index++){
+    profiler.formatCsvRow(index, row, sizeof(row));
+    ble.profileWrite(row);
+  }
+}
+#endif
+
 void aiInferenceFunc(void *pvParameters){
-  uint8_t currentInferInput[INFERENCE_LENGTH*INFERENCE_FEATURES];
   Result_t aiResult;
-  uint8_t lastSent = 15;
+  uint8_t lastSent = NO_SIGN_SENT;
+#ifdef USE_PROFILING
+  uint16_t profiledInferences = 0;
+#endif
   for(;;){
+    // woken on every published window, runs on the newest one
     ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-    if(xQueueReceive(inferenceDataQueue, &currentInferInput, portMAX_DELAY) == pdPASS){
-      inferReady = false;
-      // aiInstance.infer(&currentInferInput);
-      aiResult = aiInstance.infer(currentInferInput);
-      inferReady = true;
-      if(lastSent != aiResult.result){
+    while(inferStep(inferenceHandoff, aiInstance, aiResult)){
+#ifdef USE_PROFILING
+      if(++profiledInferences >= PROFILE_REPORT_INTERVAL){
+        profileReport();
+        profiledInferences = 0;
+      }
+#endif
+      if(shouldSend(aiResult, lastSent)){
         uint8_t tfPackage[2] = {aiResult.result, aiResult.confidence};
         ble.tfWrite(tfPackage);
       }
     }
-    vTaskDelay(1);
   }
 }
 
 void aiInferenceParser(void *pvParameters){
-  bool ledState = false;
-  Inference_t currentEntry;
-  currentEntry.pinky = 255;
-  currentEntry.ring = 255;
-  currentEntry.middle = 255;
-  currentEntry.index = 255;
-  currentEntry.thumb = 255;
-  currentEntry.w = 255;
-  currentEntry.x = 255;
-  currentEntry.z = 255;
-  currentEntry.y = 255;
-  Inference_t inferenceArray[INFERENCE_LENGTH] = {currentEntry};
-  uint8_t finalInferenceArray[INFERENCE_LENGTH*INFERENCE_FEATURES];
-  handData_t inferHandReceive;
-  quaternion_t inferIMUReceive;
-  uint16_t currentEntryNum = 0;
-  // long lastRun = millis();
-  // uint16_t hzCheck = 0; 
   for(;;){
-      if(xQueueReceive(imuInferenceData, &inferIMUReceive, 0) == pdPASS || xQueueReceive(fingerInferenceData, &inferHandReceive, 0) == pdPASS){
-
-        // SHIFT ARRAY 1 POSITION TO THE LEFT
-        for(uint16_t arrayIndex = 0; arrayIndex < INFERENCE_LENGTH - 1 ; arrayIndex++){
-          inferenceArray[arrayIndex] = inferenceArray[arrayIndex + 1];
-          finalInferenceArray[arrayIndex * INFERENCE_FEATURES + 0] = inferenceArray[arrayIndex].thumb;
-          finalInferenceArray[arrayIndex * INFERENCE_FEATURES + 1] = inferenceArray[arrayIndex].index;
-          finalInferenceArray[arrayIndex * INFERENCE_FEATURES + 2] = inferenceArray[arrayIndex].middle;
-          finalInferenceArray[arrayIndex * INFERENCE_FEATURES + 3] = inferenceArray[arrayIndex].ring;
-          finalInferenceArray[arrayIndex * INFERENCE_FEATURES + 4] = inferenceArray[arrayIndex].pinky;
-          finalInferenceArray[arrayIndex * INFERENCE_FEATURES + 5] = inferenceArray[arrayIndex].x;
-          finalInferenceArray[arrayIndex * INFERENCE_FEATURES + 6] = inferenceArray[arrayIndex].y;
-          finalInferenceArray[arrayIndex * INFERENCE_FEATURES + 7] = inferenceArray[arrayIndex].z;
-          finalInferenceArray[arrayIndex * INFERENCE_FEATURES + 8] = inferenceArray[arrayIndex].w;
-        }
-
-        // // INSERT NEW ENTRY
-        currentEntry.pinky = inferHandReceive.pinky;
-        currentEntry.ring = inferHandReceive.ring;
-        currentEntry.middle = inferHandReceive.middle;
-        currentEntry.index = inferHandReceive.index;
-        currentEntry.thumb = inferHandReceive.thumb;
-        currentEntry.w = inferIMUReceive.w;
-        currentEntry.x = inferIMUReceive.x;
-        currentEntry.z = inferIMUReceive.z;
-        currentEntry.y = inferIMUReceive.y;
-
-        inferenceArray[INFERENCE_LENGTH-1] = currentEntry;
-        
-        finalInferenceArray[(INFERENCE_LENGTH-1) * INFERENCE_FEATURES + 0] = currentEntry.thumb;
-        finalInferenceArray[(INFERENCE_LENGTH-1) * INFERENCE_FEATURES + 1] = currentEntry.index;
-        finalInferenceArray[(INFERENCE_LENGTH-1) * INFERENCE_FEATURES + 2] = currentEntry.middle;
-        finalInferenceArray[(INFERENCE_LENGTH-1) * INFERENCE_FEATURES + 3] = currentEntry.ring;
-        finalInferenceArray[(INFERENCE_LENGTH-1) * INFERENCE_FEATURES + 4] = currentEntry.pinky;
-        finalInferenceArray[(INFERENCE_LENGTH-1) * INFERENCE_FEATURES + 5] = currentEntry.x;
-        finalInferenceArray[(INFERENCE_LENGTH-1) * INFERENCE_FEATURES + 6] = currentEntry.y;
-        finalInferenceArray[(INFERENCE_LENGTH-1) * INFERENCE_FEATURES + 7] = currentEntry.z;
-        finalInferenceArray[(INFERENCE_LENGTH-1) * INFERENCE_FEATURES + 8] = currentEntry.w;
-
-        // inferenceArray[INFERENCE_LENGTH-1][0] = inferHandReceive.thumb;
-        // inferenceArray[INFERENCE_LENGTH-1][1] = inferHandReceive.index;
-        // inferenceArray[INFERENCE_LENGTH-1][2] = inferHandReceive.middle;
-        // inferenceArray[INFERENCE_LENGTH-1][3] = inferHandReceive.ring;
-        // inferenceArray[INFERENCE_LENGTH-1][4] = inferHandReceive.pinky;
-        // inferenceArray[INFERENCE_LENGTH-1][5] = inferIMUReceive.x;
-        // inferenceArray[INFERENCE_LENGTH-1][6] = inferIMUReceive.y;
-        // inferenceArray[INFERENCE_LENGTH-1][7] = inferIMUReceive.z;
-        // inferenceArray[INFERENCE_LENGTH-1][8] = inferIMUReceive.w;
-        // increment the window
-        currentEntryNum++;
-        // MicroPrintf("%d vs %d", currentEntryNum , INFERENCE_WINDOW);
-
-        // hzCheck++;
-        // if(millis() - lastRun >= 1000){
-        //   MicroPrintf("%dhz", hzCheck);
-        //   lastRun = millis();
-        //   hzCheck = 0;
-        // }
-
-      }
-      // Check for new Data
-      // check if the entry is still within the window
-      if(currentEntryNum >= INFERENCE_WINDOW && inferenceArray[0].x != 0 && inferenceArray[0].y != 0 && inferenceArray[0].z != 0 && inferenceArray[0].w != 0){
-        if(inferReady == true){
-          currentEntryNum = 0;
-          // MicroPrintf("[%d, %d, %d, %d]", finalInferenceArray[5],finalInferenceArray[6],finalInferenceArray[7],finalInferenceArray[8]);
-          xQueueSend(inferenceDataQueue, &finalInferenceArray, 0);
-          vTaskDelay(pdMS_TO_TICKS(1));
-          xTaskNotifyGive(inferTask);
-        }
+      if(parseStep(imuInferenceData, fingerInferenceData, sensorFusion, inferenceWindow, inferenceHandoff, micros())){
+        xTaskNotifyGive(inferTask);
       }
       vTaskDelay(1);
   }
@@ -428,12 +403,98 @@ void aiInferenceParser(void *pvParameters){
 
 #ifdef USE_IMU
 #ifndef USE_TFLITE
+#ifdef USE_BLE_BATCH
+inline void finishFrame(BleFrameWriter &) {
+}
+
+#ifdef USE_BLE_COMPRESSION
+inline void finishFrame(GloveEncoder<INFERENCE_FEATURES> &writer) {
+  writer.finish();
+}
+#endif
+
+template <typename Writer>
+void sendFrame(Writer &writer) {
+  finishFrame(writer);
+  ble.frameWrite(writer.data(), writer.size());
+  writer.clear();
+  // a renegotiated MTU applies from the next frame
+  writer.setLimit(ble.frameLimit());
+  writeHZ++;
+}
+
+template <typename Writer>
+void sendRow(Writer &writer, const Inference_t &row, uint32_t timestamp) {
+  if (!writer.push(row, timestamp)) {
+    sendFrame(writer);
+    writer.push(row, timestamp);
+  }
+  if (writer.isFull()) {
+    sendFrame(writer);
+  }
+}
+
+// rows are stamped FUSION_DELAY_US behind micros()
+template <typename Writer>
+void flushFrame(Writer &writer) {
+  if (!writer.isEmpty()
+      && elapsedMicros(writer.firstTimestamp(), micros() - FUSION_DELAY_US) >= BLE_FRAME_FLUSH_MS * 1000L) {
+    sendFrame(writer);
+  }
+}
+
+// Fuses both streams like aiInferenceParser and ships the rows in batches
 void accelGyroSender(void *pvParameters) {
+  handData_t handData;
   quaternion_t imuData;
+  Inference_t row;
+  bool wasConnected = false;
 
   for (;;) {
-    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-    if (xQueueReceive(IMUQueue, &imuData, FINGER_QUEUE_WAIT) == pdPASS) {
+    // woken per IMU sample, the timeout keeps the ticks and flushes going without one
+    IMUQueue.wait(pdMS_TO_TICKS(1000 / FUSION_RATE));
+    if (ble.isConnected() != wasConnected) {
+      wasConnected = ble.isConnected();
+      sensorFusion.reset();
+      frameWriter.reset();
+      frameWriter.setLimit(ble.frameLimit());
+#ifdef USE_BLE_COMPRESSION
+      smallFrameWriter.reset();
+      smallFrameWriter.setLimit(ble.frameLimit());
+#endif
+    }
+    while (IMUQueue.pop(imuData)) {
+      sensorFusion.addImu(imuData);
+    }
+    while (handQueue.pop(handData)) {
+      sensorFusion.addHand(handData);
+    }
+    while (sensorFusion.poll(micros(), row)) {
+#ifdef USE_BLE_COMPRESSION
+      // a keyframe does not fit the default MTU, plain frames go out until the central raises it
+      if (ble.frameLimit() < frameWriter.kMinBytes) {
+        sendRow(smallFrameWriter, row, sensorFusion.tickTime());
+        continue;
+      }
+      if (!smallFrameWriter.isEmpty()) {
+        sendFrame(smallFrameWriter);
+      }
+#endif
+      sendRow(frameWriter, row, sensorFusion.tickTime());
+    }
+    flushFrame(frameWriter);
+#ifdef USE_BLE_COMPRESSION
+    flushFrame(smallFrameWriter);
+#endif
+  }
+}
+#else
+void accelGyroSender(void *pvParameters) {
+  quaternion_t imuData;
+
+  for (;;) {
+    IMUQueue.wait(portMAX_DELAY);
+    while (IMUQueue.pop(imuData)) {
       uint8_t data[4] = { imuData.x, imuData.y, imuData.z, imuData.w };
       writeHZ++;
       ble.imuWrite(data);
@@ -441,122 +502,66 @@ void accelGyroSender(void *pvParameters) {
   }
 }
 #endif
+#endif
 void accelGyroFunc(void *pvParameters) {
   quaternion_t imuData;
   
   for (;;) {
-#ifdef USE_ICM
-
+    // woken by the FIFO interrupt, every buffered packet is read in one go
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IMU_INTERRUPT_TIMEOUT));
+    ACCEL.drainFIFO();
     while (ACCEL.checkDataReady()) {
       imuData = ACCEL.getData();
       #ifndef USE_TFLITE
-      xQueueSend(IMUQueue, &imuData, pdMS_TO_TICKS(IMU_QUEUE_WAIT));
-      xTaskNotifyGive(imuSenderTask);
+      IMUQueue.push(imuData);
       #else
-      xQueueSend(imuInferenceData, &imuData, pdMS_TO_TICKS(IMU_QUEUE_WAIT));
+      imuInferenceData.push(imuData);
       #endif
 
 #ifdef USE_TRAIN
-      xQueueSend(imuTrainQueue, &imuData, pdMS_TO_TICKS(IMU_QUEUE_WAIT));
-#endif
-    }
-    vTaskDelay(pdMS_TO_TICKS(1));
-#else
-    ulTaskGenericNotifyTake(0, pdTRUE, portMAX_DELAY);
-    imuData = ACCEL.getData();
-    xQueueSend(IMUQueue, &imuData, pdMS_TO_TICKS(IMU_QUEUE_WAIT));
-    xTaskNotifyGive(imuSenderTask);
-
-
-#ifdef USE_TRAIN
-    xQueueSend(imuTrainQueue, &imuData, pdMS_TO_TICKS(IMU_QUEUE_WAIT));
+      imuTrainQueue.push(imuData);
+#ifdef USE_SENSOR_TRACE
+      rawImuTrainQueue.push(ACCEL.getRawData());
 #endif
 #endif
+    }
     readHZ++;
   }
 }
 #endif
 #ifdef USE_FINGERS
 
-void fingerSender(void *pvParameters) {
+void handSamplerFunc(void *pvParameters) {
   handData_t fingers;
-  // Serial.begin(115200);
+  uint16_t rawValues[FINGER_COUNT];
   for (;;) {
-    // unsigned long start = micros();
-    //Receive data from gloves queue
-    int pinkyStatus = xQueueReceive(pinkyQueue, &fingers.pinky, FINGER_QUEUE_RECEIVE_WAIT);
-    int ringStatus = xQueueReceive(ringQueue, &fingers.ring, FINGER_QUEUE_RECEIVE_WAIT);
-    int middleStatus = xQueueReceive(middleQueue, &fingers.middle, FINGER_QUEUE_RECEIVE_WAIT);
-    int indexStatus = xQueueReceive(indexQueue, &fingers.index, FINGER_QUEUE_RECEIVE_WAIT);
-    int thumbStatus = xQueueReceive(thumbQueue, &fingers.thumb, FINGER_QUEUE_RECEIVE_WAIT);
-    if ((pinkyStatus == pdTRUE) || (ringStatus == pdTRUE) || (middleStatus == pdTRUE) || (indexStatus == pdTRUE) || (thumbStatus == pdTRUE)) {
-      // Serial.println(sizeof(sendData));
-      #ifdef USE_TFLITE
-      xQueueSend(fingerInferenceData, &fingers, pdMS_TO_TICKS(FINGER_QUEUE_WAIT));
-      #else
-      uint8_t sendData[] = { fingers.thumb,
-                             fingers.index,
-                             fingers.middle,
-                             fingers.ring,
-                             fingers.pinky };
-      ble.fingerWrite(sendData);
-      #endif
+    // one hardware timed frame with all five fingers sampled together
+    if (!handSampler.waitFrame(rawValues)) {
+      continue;
+    }
+    fingers = fingerFrame(fingerInstances, rawValues, micros());
+    #ifdef USE_TFLITE
+    fingerInferenceData.push(fingers);
+    #elif defined(USE_BLE_BATCH)
+    handQueue.push(fingers);
+    #else
+    uint8_t sendData[] = { fingers.thumb,
+                           fingers.index,
+                           fingers.middle,
+                           fingers.ring,
+                           fingers.pinky };
+    ble.fingerWrite(sendData);
+    #endif
 #ifdef USE_TRAIN
-      xQueueSend(fingerTrainQueue, &fingers, pdMS_TO_TICKS(FINGER_QUEUE_WAIT));
+    fingerTrainQueue.push(fingers);
+#ifdef USE_SENSOR_TRACE
+    rawHandData_t rawFrame;
+    memcpy(rawFrame.raw, rawValues, sizeof(rawFrame.raw));
+    rawFrame.timestamp = fingers.timestamp;
+    rawFingerTrainQueue.push(rawFrame);
 #endif
-    } else {
-    }
-    vTaskDelay(pdMS_TO_TICKS(1));
-  }
-}
-
-void pinkyFingerFunc(void *pvParameters) {
-  for (;;) {
-    uint8_t fingerData = pinkyFinger.read(); 
-    if (xQueueSend(pinkyQueue, &fingerData, pdMS_TO_TICKS(FINGER_QUEUE_WAIT)) != pdPASS) {
-    }
-    pinkyHZ++;
-    vTaskDelay(pdMS_TO_TICKS(1000 / FINGER_SAMPLING_RATE));
-  }
-}
-
-void ringFingerFunc(void *pvParameters) {
-  for (;;) {
-    uint8_t fingerData = ringFinger.read();
-    if (xQueueSend(ringQueue, &fingerData, pdMS_TO_TICKS(FINGER_QUEUE_WAIT)) != pdPASS) {
-    }
-    ringHZ++;
-    vTaskDelay(pdMS_TO_TICKS(1000 / FINGER_SAMPLING_RATE));
-  }
-}
-
-void middleFingerFunc(void *pvParameters) {
-  for (;;) {
-    uint8_t fingerData = middleFinger.read();
-    if (xQueueSend(middleQueue, &fingerData, pdMS_TO_TICKS(FINGER_QUEUE_WAIT)) != pdPASS) {
-    }
-    middleHZ++;
-    vTaskDelay(pdMS_TO_TICKS(1000 / FINGER_SAMPLING_RATE));
-  }
-}
-
-void indexFingerFunc(void *pvParameters) {
-  for (;;) {
-    uint8_t fingerData = indexFinger.read();
-    if (xQueueSend(indexQueue, &fingerData, pdMS_TO_TICKS(FINGER_QUEUE_WAIT)) != pdPASS) {
-    }
-    indexHZ++;
-    vTaskDelay(pdMS_TO_TICKS(1000 / FINGER_SAMPLING_RATE));
-  }
-}
-
-void thumbFingerFunc(void *pvParameters) {
-  for (;;) {
-    uint8_t fingerData = thumbFinger.read();
-    if (xQueueSend(thumbQueue, &fingerData, pdMS_TO_TICKS(FINGER_QUEUE_WAIT)) != pdPASS) {
-    }
-    thumbHZ++;
-    vTaskDelay(pdMS_TO_TICKS(1000 / FINGER_SAMPLING_RATE));
+#endif
+    handHZ++;
   }
 }
 #endif
@@ -581,22 +586,14 @@ void telPrint(void *pvParameters) {
   bool ledState = false;
   int lastRun = millis();
   for (;;) {
-    MicroPrintf("%d,%d,%d,%d,%d,%d,%d,%d,%d,%d", core0Tel, core1Tel, esp_get_free_heap_size(), pinkyHZ,ringHZ,middleHZ,indexHZ,thumbHZ,readHZ,writeHZ);
+    MicroPrintf("%d,%d,%d,%d,%d,%d", core0Tel, core1Tel, esp_get_free_heap_size(), handHZ,readHZ,writeHZ);
     Serial.print(core0Tel);
     Serial.print(",");
     Serial.print(core1Tel);
     Serial.print(",");
     Serial.print(esp_get_free_heap_size());
     Serial.print(",");
-    Serial.print(pinkyHZ);
-    Serial.print(",");
-    Serial.print(ringHZ);
-    Serial.print(",");
-    Serial.print(middleHZ);
-    Serial.print(",");
-    Serial.print(indexHZ);
-    Serial.print(",");
-    Serial.print(thumbHZ);
+    Serial.print(handHZ);
     Serial.print(",");
     Serial.print(readHZ);
     Serial.print(",");
@@ -606,11 +603,7 @@ void telPrint(void *pvParameters) {
     ledState = !ledState;
     core0Tel = 0;
     core1Tel = 0;
-    pinkyHZ = 0;
-    ringHZ = 0;
-    middleHZ = 0;
-    indexHZ = 0;
-    thumbHZ = 0;
+    handHZ = 0;
     readHZ = 0;
     writeHZ = 0;
 
@@ -0,0 +1,382 @@
+// Generated by host/fuse_model from model.h, do not edit. Rerun it when model.h changes.
+#pragma once
+
+#define MODEL_FUSED_SOURCE_HASH 0x2f248bd4u  // modelHash() of the signsaya_model it was fused from
+
+alignas(16) const unsigned char signsaya_model_fused[] = {
+  0x1c, 0x00, 0x00, 0x00, 0x54, 0x46, 0x4c, 0x33, 0x14, 0x00, 0x20, 0x00, 
+  0x04, 0x00, 0x08, 0x00, 0x0c, 0x00, 0x10, 0x00, 0x14, 0x00, 0x00, 0x00, 
+  0x18, 0x00, 0x1c, 0x00, 0x14, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 
+  0xe0, 0x10, 0x00, 0x00, 0xe8, 0x07, 0x00, 0x00, 0xd0, 0x07, 0x00, 0x00, 
+  0xd0, 0x00, 0x00, 0x00, 0x70, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0xe2, 0xf7, 0xff, 0xff, 
+  0x40, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x0f, 0x00, 0x00, 0x00, 0x73, 0x65, 0x72, 0x76, 0x69, 0x6e, 0x67, 0x5f, 
+  0x64, 0x65, 0x66, 0x61, 0x75, 0x6c, 0x74, 0x00, 0x01, 0x00, 0x00, 0x00, 
+  0x04, 0x00, 0x00, 0x00, 0x9c, 0xff, 0xff, 0xff, 0x08, 0x00, 0x00, 0x00, 
+  0x08, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x64, 0x65, 0x6e, 0x73, 
+  0x65, 0x5f, 0x33, 0x00, 0x01, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0xda, 0xf7, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 
+  0x69, 0x6e, 0x70, 0x75, 0x74, 0x5f, 0x34, 0x00, 0x02, 0x00, 0x00, 0x00, 
+  0x34, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0xdc, 0xff, 0xff, 0xff, 
+  0x08, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 
+  0x43, 0x4f, 0x4e, 0x56, 0x45, 0x52, 0x53, 0x49, 0x4f, 0x4e, 0x5f, 0x4d, 
+  0x45, 0x54, 0x41, 0x44, 0x41, 0x54, 0x41, 0x00, 0x08, 0x00, 0x0c, 0x00, 
+  0x04, 0x00, 0x08, 0x00, 0x08, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 
+  0x0a, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x6d, 0x69, 0x6e, 0x5f, 
+  0x72, 0x75, 0x6e, 0x74, 0x69, 0x6d, 0x65, 0x5f, 0x76, 0x65, 0x72, 0x73, 
+  0x69, 0x6f, 0x6e, 0x00, 0x0c, 0x00, 0x00, 0x00, 0xf4, 0x06, 0x00, 0x00, 
+  0xec, 0x06, 0x00, 0x00, 0x98, 0x06, 0x00, 0x00, 0xc4, 0x04, 0x00, 0x00, 
+  0x30, 0x04, 0x00, 0x00, 0xbc, 0x00, 0x00, 0x00, 0xb4, 0x00, 0x00, 0x00, 
+  0xac, 0x00, 0x00, 0x00, 0xa4, 0x00, 0x00, 0x00, 0x9c, 0x00, 0x00, 0x00, 
+  0x78, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x7e, 0xf8, 0xff, 0xff, 
+  0x04, 0x00, 0x00, 0x00, 0x58, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 
+  0x08, 0x00, 0x0e, 0x00, 0x08, 0x00, 0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 
+  0x10, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 
+  0x08, 0x00, 0x04, 0x00, 0x06, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0xeb, 0x03, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 
+  0x10, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x04, 0x00, 0x0a, 0x00, 0x00, 0x00, 
+  0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x06, 0x00, 0x00, 0x00, 0x32, 0x2e, 0x31, 0x35, 0x2e, 0x30, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0xee, 0xf8, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 
+  0x31, 0x2e, 0x31, 0x34, 0x2e, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc8, 0xf8, 0xff, 0xff, 
+  0xcc, 0xf8, 0xff, 0xff, 0xd0, 0xf8, 0xff, 0xff, 0xd4, 0xf8, 0xff, 0xff, 
+  0x1e, 0xf9, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x60, 0x03, 0x00, 0x00, 
+  0xf6, 0xff, 0x11, 0xfb, 0xa5, 0x35, 0x5e, 0x92, 0xf3, 0xf9, 0x17, 0x18, 
+  0x0b, 0xaa, 0x34, 0x56, 0x81, 0xfd, 0xf6, 0x17, 0x25, 0x01, 0x90, 0x19, 
+  0x5b, 0x86, 0x00, 0xa2, 0x05, 0x18, 0x24, 0xf0, 0x23, 0x81, 0xcb, 0x23, 
+  0xea, 0x2a, 0xfd, 0x25, 0xe4, 0x24, 0xc3, 0xea, 0x0c, 0xdb, 0x36, 0xf0, 
+  0x2d, 0x05, 0x15, 0xbb, 0x06, 0x21, 0xbf, 0x11, 0xcd, 0xfc, 0x0c, 0xcf, 
+  0x5f, 0x08, 0x26, 0x1f, 0xff, 0xc2, 0x10, 0x0a, 0x81, 0x49, 0xfc, 0x25, 
+  0x20, 0xf1, 0xb1, 0xec, 0xd8, 0x17, 0xc7, 0xe6, 0x2f, 0xf0, 0x00, 0x2a, 
+  0x0d, 0xa6, 0xbd, 0x6d, 0xbf, 0x3a, 0xf4, 0x0b, 0x28, 0x33, 0xbe, 0xf5, 
+  0x7f, 0xca, 0x3a, 0xda, 0xaf, 0xd6, 0xe7, 0xaa, 0xed, 0x77, 0xc4, 0x1a, 
+  0xde, 0x06, 0x3f, 0x0c, 0x39, 0xea, 0xca, 0x5c, 0xeb, 0x81, 0xf7, 0x55, 
+  0x18, 0x28, 0xde, 0xd8, 0xd2, 0xe8, 0xe3, 0x0c, 0x3c, 0x02, 0x22, 0xfc, 
+  0xbd, 0xd1, 0xd0, 0xf0, 0xd6, 0x41, 0x3b, 0xf4, 0x19, 0xc8, 0x7f, 0xd0, 
+  0xd2, 0xd5, 0x60, 0x21, 0xe1, 0x9b, 0x2a, 0x48, 0xb4, 0xde, 0xe8, 0x14, 
+  0x39, 0xcf, 0xc8, 0xf1, 0x76, 0xa0, 0xed, 0xd6, 0x1d, 0x33, 0xd3, 0xe3, 
+  0xef, 0x77, 0xb0, 0xef, 0xe0, 0x04, 0x46, 0xe4, 0xe4, 0xef, 0x7f, 0xe9, 
+  0xfa, 0xdf, 0xed, 0x41, 0xf4, 0xdb, 0xf6, 0x6c, 0xb2, 0xf1, 0xf0, 0x41, 
+  0xfd, 0x0e, 0x9d, 0x2e, 0xdb, 0xb8, 0xe9, 0x03, 0x5a, 0x0f, 0x1b, 0xa3, 
+  0x29, 0xe5, 0xb4, 0x8b, 0x02, 0x7f, 0x06, 0x1d, 0xde, 0x1a, 0xe7, 0xa8, 
+  0xd3, 0x07, 0x00, 0xd5, 0x41, 0x88, 0x11, 0x14, 0x1a, 0xc8, 0xfa, 0x38, 
+  0xdf, 0x46, 0x87, 0x14, 0xf9, 0x1e, 0xd3, 0x09, 0x1f, 0xe3, 0x3c, 0x81, 
+  0x13, 0x12, 0x33, 0xea, 0xea, 0x62, 0x81, 0xf2, 0x57, 0x1e, 0xf9, 0xbc, 
+  0xf5, 0x09, 0x45, 0x93, 0x03, 0x51, 0x11, 0x06, 0xd5, 0xfd, 0x0b, 0x5d, 
+  0xa1, 0x04, 0x50, 0x1c, 0x01, 0xbf, 0x46, 0xed, 0xe0, 0x12, 0x9a, 0xdd, 
+  0xfa, 0x8f, 0xeb, 0x4d, 0xff, 0xd7, 0xf9, 0x93, 0x97, 0x3c, 0x41, 0xed, 
+  0x44, 0x00, 0xef, 0x37, 0xbb, 0x81, 0x30, 0x1d, 0xe2, 0x27, 0xc5, 0xcc, 
+  0x1e, 0xd5, 0xff, 0x38, 0xf0, 0x48, 0x57, 0x18, 0x81, 0xe3, 0xb5, 0xf7, 
+  0xe9, 0x01, 0xfd, 0x54, 0x13, 0x8b, 0xd8, 0xb8, 0x0f, 0x15, 0x07, 0x11, 
+  0xff, 0xe0, 0x45, 0xd8, 0xab, 0x01, 0xc6, 0x3b, 0xf8, 0xde, 0xe4, 0x5a, 
+  0xdb, 0xb8, 0x2b, 0x7f, 0xd4, 0x1a, 0xf5, 0xdd, 0x5f, 0xdc, 0xbb, 0x24, 
+  0x66, 0xc8, 0x23, 0x56, 0x29, 0xeb, 0xdf, 0xaf, 0x2a, 0xcd, 0x07, 0xc7, 
+  0xf0, 0x34, 0xf5, 0xf0, 0xa9, 0xa0, 0x69, 0xfd, 0xb4, 0x42, 0x49, 0xf2, 
+  0xee, 0xac, 0xa9, 0x7f, 0xf4, 0xb2, 0xd6, 0xf9, 0xc8, 0x07, 0xba, 0x72, 
+  0x30, 0xd1, 0x10, 0x03, 0x0b, 0x15, 0x0c, 0xb3, 0xda, 0xb7, 0x65, 0x01, 
+  0x03, 0x18, 0x07, 0x1d, 0xbc, 0xce, 0xab, 0x7f, 0x16, 0x35, 0xfb, 0x15, 
+  0x3d, 0xbe, 0xe2, 0x8d, 0xa8, 0xd4, 0x4b, 0x1b, 0xfc, 0x2f, 0xc7, 0xcf, 
+  0x8c, 0xb6, 0xb0, 0x44, 0x1c, 0x19, 0x16, 0xd8, 0x81, 0x10, 0xe2, 0xc7, 
+  0xff, 0x12, 0xfc, 0x25, 0x05, 0x10, 0xa5, 0x4a, 0xde, 0xfc, 0x18, 0xe4, 
+  0xfa, 0xe6, 0x10, 0x81, 0x4a, 0xd3, 0xfd, 0x19, 0xec, 0x1e, 0x0a, 0x1e, 
+  0x0f, 0x05, 0xf0, 0x17, 0x8a, 0xea, 0xdc, 0x81, 0x2f, 0x3f, 0x16, 0x3c, 
+  0x9b, 0x90, 0x43, 0x5a, 0xe1, 0x9a, 0x08, 0xf3, 0x1f, 0x42, 0xe2, 0x58, 
+  0x3e, 0xc4, 0x11, 0xc2, 0xdb, 0x4e, 0xbc, 0xd4, 0xdd, 0xc7, 0xe5, 0x7f, 
+  0xd3, 0xfc, 0x11, 0x24, 0x1e, 0xf3, 0xef, 0x16, 0x0b, 0x64, 0x0e, 0x0b, 
+  0x26, 0x09, 0xd0, 0xe8, 0xfc, 0xaf, 0xe8, 0xd9, 0x12, 0xe0, 0x21, 0x2e, 
+  0x2b, 0x01, 0x17, 0xb6, 0xd9, 0xca, 0xe8, 0x25, 0x34, 0x27, 0x0a, 0x08, 
+  0xae, 0xdc, 0xd4, 0xe2, 0x2e, 0x2e, 0x30, 0x04, 0x81, 0x1f, 0xdf, 0xb0, 
+  0xee, 0xff, 0xf6, 0xf1, 0x11, 0x87, 0x0c, 0xfe, 0x6e, 0xf2, 0x0a, 0xea, 
+  0x02, 0x0c, 0x81, 0xfc, 0xf0, 0x51, 0xfc, 0xf6, 0xfd, 0xf8, 0x01, 0x8a, 
+  0xf3, 0x05, 0x58, 0xd3, 0xf1, 0x22, 0xef, 0xd6, 0xf1, 0x6e, 0x30, 0xf8, 
+  0x0e, 0xf1, 0xfd, 0xfb, 0xca, 0xfd, 0x7e, 0x1f, 0xfa, 0x0d, 0xe2, 0x1c, 
+  0x19, 0xdb, 0x81, 0xd1, 0xbd, 0xec, 0x15, 0x06, 0xff, 0xd9, 0xb8, 0x2d, 
+  0x1a, 0x6b, 0x2f, 0xfb, 0x00, 0xd5, 0xd2, 0x98, 0x64, 0xf4, 0x81, 0x54, 
+  0xbf, 0x06, 0x30, 0xdf, 0xd0, 0x7b, 0xe0, 0x92, 0x4b, 0xf8, 0x03, 0x53, 
+  0xdd, 0xb8, 0x16, 0x2a, 0x24, 0xd4, 0xf7, 0xfa, 0x4e, 0xd5, 0xb5, 0x21, 
+  0x4d, 0x81, 0x07, 0xf9, 0xf3, 0x51, 0xd1, 0xcc, 0x2e, 0x58, 0x81, 0xef, 
+  0xcd, 0x2a, 0x41, 0x16, 0xf7, 0x81, 0x2d, 0xe4, 0x99, 0xb4, 0x12, 0x3c, 
+  0x1b, 0x2b, 0xb3, 0x36, 0xee, 0xa7, 0xea, 0x28, 0x5b, 0x17, 0x07, 0xcc, 
+  0x1b, 0xdf, 0xb3, 0x01, 0x09, 0x27, 0x1c, 0x19, 0xd8, 0x05, 0x08, 0xa9, 
+  0x81, 0xd9, 0x3d, 0x25, 0x1c, 0xec, 0xff, 0xff, 0xbc, 0xff, 0x07, 0x32, 
+  0x19, 0x21, 0xd2, 0x05, 0x1f, 0xbc, 0x2c, 0x01, 0xba, 0x21, 0x05, 0xf3, 
+  0xfe, 0x8e, 0x23, 0x3c, 0x11, 0x9d, 0x10, 0x05, 0xe4, 0x08, 0x81, 0x23, 
+  0x13, 0x0f, 0xd7, 0x1f, 0xe6, 0xd7, 0xf9, 0xb4, 0x2b, 0xfd, 0x0f, 0xbf, 
+  0x7c, 0x96, 0xfb, 0xd7, 0x7a, 0xa6, 0x1e, 0xfc, 0xb6, 0x78, 0x9f, 0x13, 
+  0xd9, 0x7f, 0x94, 0x1d, 0x0c, 0xac, 0x69, 0xc3, 0x0e, 0xe7, 0x69, 0xc7, 
+  0xc9, 0xe5, 0x5c, 0xd1, 0xb8, 0x3a, 0x13, 0xfb, 0x0b, 0x8c, 0x00, 0x7f, 
+  0x0d, 0xf0, 0x51, 0x0b, 0xf6, 0x0e, 0x00, 0xe6, 0x1f, 0xbf, 0xc7, 0x4b, 
+  0x52, 0xde, 0x08, 0x51, 0x22, 0xfa, 0x32, 0xe7, 0x81, 0x68, 0xf9, 0xac, 
+  0x51, 0x14, 0x11, 0x29, 0xf3, 0x9a, 0x62, 0xf6, 0xa9, 0x0c, 0x0f, 0xc9, 
+  0xeb, 0xc2, 0x92, 0xad, 0xaa, 0x91, 0xe8, 0x12, 0x43, 0x11, 0x0e, 0xb8, 
+  0x2d, 0xf9, 0x93, 0x06, 0xfe, 0x3b, 0x55, 0x0f, 0xa1, 0x9e, 0x9a, 0xa4, 
+  0x08, 0x0d, 0x59, 0x2c, 0x3a, 0x81, 0x96, 0xa5, 0xbc, 0x07, 0x53, 0x11, 
+  0x06, 0xe5, 0xa6, 0x12, 0x9c, 0x2d, 0x16, 0x4d, 0x13, 0x08, 0xd4, 0xc8, 
+  0x3a, 0xde, 0x38, 0xf0, 0x81, 0xeb, 0xe9, 0xa6, 0x16, 0x3a, 0x2d, 0xf6, 
+  0x00, 0x00, 0x00, 0x00, 0x8e, 0xfc, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 
+  0x80, 0x00, 0x00, 0x00, 0x23, 0xf6, 0xff, 0xff, 0x7e, 0xe2, 0xff, 0xff, 
+  0x53, 0x1f, 0x00, 0x00, 0xb0, 0xf1, 0xff, 0xff, 0xd8, 0xd1, 0xff, 0xff, 
+  0x4b, 0xed, 0xff, 0xff, 0xe5, 0xd0, 0xff, 0xff, 0x2c, 0xef, 0xff, 0xff, 
+  0xbc, 0xbe, 0xff, 0xff, 0x35, 0xf6, 0xff, 0xff, 0x74, 0x44, 0x00, 0x00, 
+  0xca, 0x3e, 0x00, 0x00, 0xd6, 0xd3, 0xff, 0xff, 0x4d, 0x39, 0x00, 0x00, 
+  0xa1, 0x06, 0x00, 0x00, 0x23, 0x3f, 0x00, 0x00, 0x95, 0xe8, 0xff, 0xff, 
+  0xe4, 0x1a, 0x00, 0x00, 0x7c, 0x1a, 0x00, 0x00, 0x53, 0xe0, 0xff, 0xff, 
+  0x2d, 0xcd, 0xff, 0xff, 0x15, 0x0b, 0x00, 0x00, 0xe6, 0x08, 0x00, 0x00, 
+  0xa6, 0xf0, 0xff, 0xff, 0xbe, 0xd3, 0xff, 0xff, 0xb7, 0xf2, 0xff, 0xff, 
+  0xc7, 0x2e, 0x00, 0x00, 0xf8, 0xfb, 0xff, 0xff, 0x6b, 0xe1, 0xff, 0xff, 
+  0xd7, 0x36, 0x00, 0x00, 0xd9, 0xf3, 0xff, 0xff, 0x16, 0xf6, 0xff, 0xff, 
+  0x00, 0x00, 0x00, 0x00, 0x1e, 0xfd, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 
+  0xc0, 0x01, 0x00, 0x00, 0xf7, 0x27, 0x50, 0xae, 0xfe, 0xfd, 0x00, 0x01, 
+  0xef, 0xd1, 0xcd, 0x65, 0xb9, 0xf0, 0xf1, 0x33, 0x05, 0xcb, 0x1c, 0x19, 
+  0x14, 0x02, 0x26, 0xdf, 0x0a, 0xfc, 0x0d, 0x0d, 0xc5, 0x26, 0x0d, 0x0c, 
+  0x0f, 0x00, 0x0a, 0x33, 0x09, 0x10, 0x0e, 0x17, 0xde, 0xef, 0xf5, 0xc6, 
+  0x10, 0x17, 0xf3, 0x16, 0xcb, 0x03, 0xe7, 0x24, 0xea, 0x07, 0xe9, 0x0b, 
+  0x1c, 0x0e, 0xf8, 0xfb, 0xf1, 0x5b, 0x3e, 0x28, 0x1b, 0x0e, 0xfc, 0x18, 
+  0xe4, 0x03, 0x02, 0x21, 0x08, 0xce, 0x1a, 0xfe, 0xf5, 0x08, 0x19, 0xf4, 
+  0x13, 0x20, 0x13, 0xf7, 0x16, 0x10, 0x12, 0xeb, 0x18, 0xfd, 0x1e, 0x1d, 
+  0x1e, 0xd2, 0x11, 0xef, 0x2c, 0x3d, 0xb3, 0x40, 0xdb, 0x07, 0x0a, 0xfd, 
+  0x06, 0x0a, 0x1f, 0xdd, 0x34, 0x44, 0xe7, 0x0e, 0xfd, 0xfd, 0xf5, 0x03, 
+  0x27, 0x12, 0x68, 0x64, 0x16, 0xda, 0x06, 0x19, 0x46, 0x4a, 0x13, 0x22, 
+  0x13, 0xdb, 0xa7, 0xd6, 0x08, 0x06, 0x04, 0x23, 0x1c, 0xf6, 0x2b, 0xe2, 
+  0xf4, 0x04, 0x14, 0xf1, 0x0e, 0x0a, 0x17, 0xf6, 0xf3, 0x08, 0x0d, 0x09, 
+  0x20, 0x14, 0x09, 0x0c, 0x0e, 0xe5, 0x0b, 0xef, 0x01, 0xf5, 0xf8, 0xc1, 
+  0xf7, 0xee, 0xed, 0xb8, 0x1d, 0x5b, 0x14, 0x86, 0xd0, 0xf5, 0x00, 0x10, 
+  0x05, 0xb6, 0xd9, 0xe9, 0x37, 0xbf, 0x17, 0x3a, 0xe5, 0x98, 0x08, 0xf3, 
+  0xfd, 0x00, 0xe6, 0xda, 0x12, 0xec, 0x58, 0x2a, 0x10, 0x0a, 0x09, 0xda, 
+  0xdf, 0xe1, 0x28, 0x45, 0xba, 0xe2, 0x1b, 0x2a, 0xf8, 0xfc, 0xe1, 0x0d, 
+  0x17, 0x19, 0xdb, 0xf9, 0xb9, 0xf5, 0x2b, 0x1c, 0xb8, 0x4f, 0x01, 0xf1, 
+  0xd9, 0x1c, 0xf9, 0xe0, 0x0f, 0xe8, 0xde, 0x14, 0xe3, 0xed, 0x11, 0x12, 
+  0xf5, 0x40, 0xfb, 0xff, 0xe9, 0x0b, 0x12, 0x21, 0xd0, 0xf4, 0x01, 0xbc, 
+  0x1f, 0x2f, 0xee, 0xd4, 0xa7, 0x05, 0xfc, 0x0e, 0x01, 0xe9, 0x02, 0xdb, 
+  0xe6, 0x0b, 0x12, 0x0a, 0xfe, 0xef, 0xdf, 0x7f, 0x2c, 0xf2, 0x0c, 0xe2, 
+  0x2b, 0x04, 0xf6, 0xdc, 0x05, 0xd6, 0xfa, 0xf7, 0xf5, 0xfc, 0x23, 0x34, 
+  0x0e, 0xde, 0xd6, 0x10, 0x0d, 0xf6, 0xf3, 0x15, 0xf9, 0x13, 0x08, 0x18, 
+  0x19, 0x30, 0xc5, 0x55, 0x10, 0xe1, 0x0d, 0xea, 0xf8, 0x09, 0xe5, 0x01, 
+  0x10, 0xef, 0xf4, 0x33, 0x0b, 0x19, 0xe8, 0xeb, 0x36, 0xf4, 0xf2, 0x01, 
+  0xd9, 0xf5, 0xf5, 0xdd, 0x27, 0xf8, 0xf6, 0x07, 0x07, 0x0f, 0xf8, 0xfa, 
+  0x16, 0x01, 0xe9, 0xf1, 0xfb, 0xf5, 0x13, 0x13, 0xf5, 0x07, 0x13, 0xd2, 
+  0xf6, 0x07, 0xec, 0xd2, 0x09, 0xef, 0x0d, 0xda, 0xcd, 0xe0, 0x2c, 0x05, 
+  0xb9, 0xd5, 0xd9, 0xc4, 0xe2, 0x0f, 0xfb, 0xe6, 0x0f, 0xea, 0x28, 0xfa, 
+  0x02, 0x14, 0x19, 0xe6, 0xff, 0x1d, 0xcd, 0xd3, 0xdb, 0x99, 0xfd, 0xef, 
+  0xd6, 0xf6, 0xdb, 0x27, 0x09, 0xe2, 0x1c, 0x41, 0x33, 0x15, 0x04, 0xf5, 
+  0xfa, 0xfc, 0xe8, 0xba, 0x24, 0xe6, 0x0e, 0xec, 0x0e, 0x06, 0xe0, 0xf9, 
+  0xf1, 0xe8, 0xd5, 0x15, 0xf6, 0x1a, 0xf6, 0x09, 0x02, 0xe4, 0xe5, 0x1a, 
+  0xf6, 0x03, 0xe7, 0xde, 0x04, 0x05, 0xfd, 0x1a, 0x2f, 0x26, 0xfe, 0xb8, 
+  0x08, 0x20, 0xdf, 0x00, 0x07, 0xf6, 0x1f, 0xf4, 0x24, 0x0b, 0xdd, 0xfc, 
+  0x07, 0x16, 0x1a, 0xda, 0x12, 0xec, 0x02, 0xd0, 0x00, 0x00, 0x00, 0x00, 
+  0xee, 0xfe, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 
+  0x63, 0x01, 0x00, 0x00, 0x9c, 0xfd, 0xff, 0xff, 0x2a, 0x02, 0x00, 0x00, 
+  0x67, 0xfc, 0xff, 0xff, 0xc4, 0x01, 0x00, 0x00, 0xad, 0xf8, 0xff, 0xff, 
+  0xa7, 0x02, 0x00, 0x00, 0xb2, 0xff, 0xff, 0xff, 0x92, 0xff, 0xff, 0xff, 
+  0xae, 0xff, 0xff, 0xff, 0x40, 0x06, 0x00, 0x00, 0xc6, 0xfa, 0xff, 0xff, 
+  0x57, 0xff, 0xff, 0xff, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0xfe, 0xff, 0xff, 
+  0xfc, 0xfe, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x4d, 0x4c, 0x49, 0x52, 
+  0x20, 0x43, 0x6f, 0x6e, 0x76, 0x65, 0x72, 0x74, 0x65, 0x64, 0x2e, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 
+  0x18, 0x00, 0x04, 0x00, 0x08, 0x00, 0x0c, 0x00, 0x10, 0x00, 0x14, 0x00, 
+  0x0e, 0x00, 0x00, 0x00, 0x44, 0x01, 0x00, 0x00, 0x38, 0x01, 0x00, 0x00, 
+  0x2c, 0x01, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x04, 0x00, 0x00, 0x00, 0x6d, 0x61, 0x69, 0x6e, 0x00, 0x00, 0x00, 0x00, 
+  0x04, 0x00, 0x00, 0x00, 0xdc, 0x00, 0x00, 0x00, 0x90, 0x00, 0x00, 0x00, 
+  0x44, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 
+  0x10, 0x00, 0x04, 0x00, 0x08, 0x00, 0x0c, 0x00, 0x0a, 0x00, 0x00, 0x00, 
+  0x03, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 
+  0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x1a, 0x00, 0x08, 0x00, 
+  0x0c, 0x00, 0x10, 0x00, 0x07, 0x00, 0x14, 0x00, 0x0e, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x09, 0x02, 0x00, 0x00, 0x00, 0x24, 0x00, 0x00, 0x00, 
+  0x18, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 
+  0x08, 0x00, 0x04, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3f, 
+  0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 
+  0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x18, 0x00, 0x08, 0x00, 
+  0x0c, 0x00, 0x10, 0x00, 0x07, 0x00, 0x14, 0x00, 0x0e, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x08, 0x01, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00, 
+  0x10, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x04, 0x00, 0x04, 0x00, 
+  0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 
+  0x03, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x04, 0x00, 
+  0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x10, 0x00, 0x00, 0x00, 
+  0x20, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x08, 0x00, 0x00, 0x00, 0x81, 0x80, 0x80, 0x3b, 0x80, 0xff, 0xff, 0xff, 
+  0x01, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x07, 0x00, 0x00, 
+  0x78, 0x06, 0x00, 0x00, 0xf4, 0x05, 0x00, 0x00, 0x08, 0x04, 0x00, 0x00, 
+  0x1c, 0x02, 0x00, 0x00, 0x98, 0x01, 0x00, 0x00, 0xfc, 0x00, 0x00, 0x00, 
+  0x80, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x36, 0xf9, 0xff, 0xff, 
+  0x00, 0x00, 0x03, 0x01, 0x64, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 
+  0x3c, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x02, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x0e, 0x00, 0x00, 0x00, 
+  0x1c, 0xf9, 0xff, 0xff, 0x18, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3b, 
+  0x19, 0x00, 0x00, 0x00, 0x53, 0x74, 0x61, 0x74, 0x65, 0x66, 0x75, 0x6c, 
+  0x50, 0x61, 0x72, 0x74, 0x69, 0x74, 0x69, 0x6f, 0x6e, 0x65, 0x64, 0x43, 
+  0x61, 0x6c, 0x6c, 0x3a, 0x30, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x00, 0xae, 0xf9, 0xff, 0xff, 
+  0x00, 0x00, 0x09, 0x01, 0x64, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 
+  0x3c, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x02, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x0e, 0x00, 0x00, 0x00, 
+  0x94, 0xf9, 0xff, 0xff, 0x18, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x80, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 
+  0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3b, 
+  0x1a, 0x00, 0x00, 0x00, 0x53, 0x74, 0x61, 0x74, 0x65, 0x66, 0x75, 0x6c, 
+  0x50, 0x61, 0x72, 0x74, 0x69, 0x74, 0x69, 0x6f, 0x6e, 0x65, 0x64, 0x43, 
+  0x61, 0x6c, 0x6c, 0x3a, 0x30, 0x31, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x26, 0xfa, 0xff, 0xff, 
+  0x00, 0x00, 0x09, 0x01, 0x84, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 
+  0x3c, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x02, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x0e, 0x00, 0x00, 0x00, 
+  0x0c, 0xfa, 0xff, 0xff, 0x18, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0xa1, 0x7b, 0x10, 0x3e, 
+  0x38, 0x00, 0x00, 0x00, 0x73, 0x65, 0x71, 0x75, 0x65, 0x6e, 0x74, 0x69, 
+  0x61, 0x6c, 0x5f, 0x33, 0x2f, 0x64, 0x65, 0x6e, 0x73, 0x65, 0x5f, 0x33, 
+  0x2f, 0x4d, 0x61, 0x74, 0x4d, 0x75, 0x6c, 0x3b, 0x73, 0x65, 0x71, 0x75, 
+  0x65, 0x6e, 0x74, 0x69, 0x61, 0x6c, 0x5f, 0x33, 0x2f, 0x64, 0x65, 0x6e, 
+  0x73, 0x65, 0x5f, 0x33, 0x2f, 0x42, 0x69, 0x61, 0x73, 0x41, 0x64, 0x64, 
+  0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 
+  0x0e, 0x00, 0x00, 0x00, 0xbe, 0xfa, 0xff, 0xff, 0x00, 0x00, 0x09, 0x01, 
+  0x6c, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 
+  0x14, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 
+  0xff, 0xff, 0xff, 0xff, 0x20, 0x00, 0x00, 0x00, 0xa4, 0xfa, 0xff, 0xff, 
+  0x14, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 
+  0x29, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 
+  0x91, 0x18, 0xe5, 0x3c, 0x27, 0x00, 0x00, 0x00, 0x73, 0x65, 0x71, 0x75, 
+  0x65, 0x6e, 0x74, 0x69, 0x61, 0x6c, 0x5f, 0x33, 0x2f, 0x67, 0x6c, 0x6f, 
+  0x62, 0x61, 0x6c, 0x5f, 0x6d, 0x61, 0x78, 0x5f, 0x70, 0x6f, 0x6f, 0x6c, 
+  0x69, 0x6e, 0x67, 0x31, 0x64, 0x5f, 0x33, 0x2f, 0x4d, 0x61, 0x78, 0x00, 
+  0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 
+  0xc6, 0xfb, 0xff, 0xff, 0x00, 0x00, 0x09, 0x01, 0xcc, 0x01, 0x00, 0x00, 
+  0x05, 0x00, 0x00, 0x00, 0xa0, 0x01, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x14, 0xfb, 0xff, 0xff, 0x10, 0x01, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x20, 0x00, 0x00, 0x00, 0x67, 0x2a, 0x13, 0x3c, 0x63, 0x31, 0x46, 0x3c, 
+  0xa5, 0xa7, 0x4f, 0x3c, 0x41, 0xb1, 0x21, 0x3c, 0xe5, 0xe4, 0x28, 0x3c, 
+  0x8e, 0xbe, 0xe7, 0x3b, 0x97, 0xbd, 0xda, 0x3b, 0x02, 0x31, 0x16, 0x3c, 
+  0x44, 0xee, 0x24, 0x3c, 0x94, 0x2c, 0x1b, 0x3c, 0x60, 0x13, 0x10, 0x3c, 
+  0x6e, 0xf8, 0x44, 0x3c, 0xb5, 0x80, 0x15, 0x3c, 0x7f, 0xf7, 0x02, 0x3c, 
+  0xca, 0x12, 0x10, 0x3c, 0xd9, 0x0d, 0xfc, 0x3b, 0xa6, 0x86, 0x4c, 0x3c, 
+  0xc2, 0xfd, 0xe5, 0x3b, 0xa1, 0x75, 0x30, 0x3c, 0x67, 0x30, 0x15, 0x3c, 
+  0x8f, 0x70, 0x47, 0x3c, 0x96, 0x6d, 0x31, 0x3c, 0x02, 0xf4, 0x1f, 0x3c, 
+  0x24, 0xe1, 0x23, 0x3c, 0xdb, 0xfc, 0x09, 0x3c, 0xbe, 0x1b, 0x4d, 0x3c, 
+  0xce, 0x3f, 0x1f, 0x3c, 0xb5, 0x5a, 0xdf, 0x3b, 0x02, 0xe0, 0x34, 0x3c, 
+  0x72, 0xb6, 0x12, 0x3c, 0x30, 0x4c, 0xff, 0x3b, 0x66, 0x56, 0x24, 0x3c, 
+  0x1c, 0x00, 0x00, 0x00, 0x73, 0x65, 0x71, 0x75, 0x65, 0x6e, 0x74, 0x69, 
+  0x61, 0x6c, 0x5f, 0x33, 0x2f, 0x63, 0x6f, 0x6e, 0x76, 0x31, 0x64, 0x5f, 
+  0x33, 0x2f, 0x43, 0x6f, 0x6e, 0x76, 0x31, 0x44, 0x00, 0x00, 0x00, 0x00, 
+  0x04, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 
+  0x03, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0xae, 0xfd, 0xff, 0xff, 
+  0x00, 0x00, 0x02, 0x01, 0xd8, 0x01, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x9c, 0x01, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0xfc, 0xfc, 0xff, 0xff, 
+  0x0c, 0x01, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x26, 0xbe, 0x13, 0x38, 
+  0x5c, 0xf8, 0x46, 0x38, 0x1e, 0x78, 0x50, 0x38, 0x95, 0x53, 0x22, 0x38, 
+  0x74, 0x8e, 0x29, 0x38, 0x36, 0xa7, 0xe8, 0x37, 0x31, 0x99, 0xdb, 0x37, 
+  0xca, 0xc7, 0x16, 0x38, 0xd8, 0x93, 0x25, 0x38, 0x5d, 0xc8, 0x1b, 0x38, 
+  0x05, 0xa4, 0x10, 0x38, 0x2d, 0xbe, 0x45, 0x38, 0xcc, 0x16, 0x16, 0x38, 
+  0xfa, 0x7a, 0x03, 0x38, 0x6e, 0xa3, 0x10, 0x38, 0xe5, 0x0a, 0xfd, 0x37, 
+  0xfb, 0x53, 0x4d, 0x38, 0xa8, 0xe4, 0xe6, 0x37, 0xc8, 0x26, 0x31, 0x38, 
+  0x2e, 0xc6, 0x15, 0x38, 0xc9, 0x38, 0x48, 0x38, 0xb6, 0x1f, 0x32, 0x38, 
+  0x97, 0x94, 0x20, 0x38, 0xaa, 0x85, 0x24, 0x38, 0x63, 0x87, 0x0a, 0x38, 
+  0xa8, 0xe9, 0x4d, 0x38, 0xae, 0xdf, 0x1f, 0x38, 0xf1, 0x3a, 0xe0, 0x37, 
+  0x98, 0x95, 0x35, 0x38, 0xbc, 0x49, 0x13, 0x38, 0x3f, 0x26, 0x00, 0x38, 
+  0x62, 0xfb, 0x24, 0x38, 0x2c, 0x00, 0x00, 0x00, 0x73, 0x65, 0x71, 0x75, 
+  0x65, 0x6e, 0x74, 0x69, 0x61, 0x6c, 0x5f, 0x33, 0x2f, 0x63, 0x6f, 0x6e, 
+  0x76, 0x31, 0x64, 0x5f, 0x33, 0x2f, 0x42, 0x69, 0x61, 0x73, 0x41, 0x64, 
+  0x64, 0x2f, 0x52, 0x65, 0x61, 0x64, 0x56, 0x61, 0x72, 0x69, 0x61, 0x62, 
+  0x6c, 0x65, 0x4f, 0x70, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 
+  0x20, 0x00, 0x00, 0x00, 0x96, 0xff, 0xff, 0xff, 0x00, 0x00, 0x09, 0x01, 
+  0x54, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00, 
+  0x04, 0x00, 0x00, 0x00, 0xe4, 0xfe, 0xff, 0xff, 0x18, 0x00, 0x00, 0x00, 
+  0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 
+  0x6d, 0xe7, 0xd0, 0x3c, 0x1b, 0x00, 0x00, 0x00, 0x73, 0x65, 0x71, 0x75, 
+  0x65, 0x6e, 0x74, 0x69, 0x61, 0x6c, 0x5f, 0x33, 0x2f, 0x64, 0x65, 0x6e, 
+  0x73, 0x65, 0x5f, 0x33, 0x2f, 0x4d, 0x61, 0x74, 0x4d, 0x75, 0x6c, 0x00, 
+  0x02, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x16, 0x00, 0x18, 0x00, 0x08, 0x00, 0x06, 0x00, 0x0c, 0x00, 
+  0x10, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 
+  0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x01, 0x60, 0x00, 0x00, 0x00, 
+  0x02, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x64, 0xff, 0xff, 0xff, 0x14, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x11, 0xf3, 0x3a, 0x3a, 0x2b, 0x00, 0x00, 0x00, 
+  0x73, 0x65, 0x71, 0x75, 0x65, 0x6e, 0x74, 0x69, 0x61, 0x6c, 0x5f, 0x33, 
+  0x2f, 0x64, 0x65, 0x6e, 0x73, 0x65, 0x5f, 0x33, 0x2f, 0x42, 0x69, 0x61, 
+  0x73, 0x41, 0x64, 0x64, 0x2f, 0x52, 0x65, 0x61, 0x64, 0x56, 0x61, 0x72, 
+  0x69, 0x61, 0x62, 0x6c, 0x65, 0x4f, 0x70, 0x00, 0x01, 0x00, 0x00, 0x00, 
+  0x0e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x16, 0x00, 0x1c, 0x00, 0x08, 0x00, 
+  0x06, 0x00, 0x0c, 0x00, 0x10, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x18, 0x00, 0x07, 0x00, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 
+  0x74, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x4c, 0x00, 0x00, 0x00, 
+  0x24, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 
+  0xff, 0xff, 0xff, 0xff, 0x12, 0x1d, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 
+  0x0c, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x08, 0x00, 
+  0x0c, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x81, 0x80, 0x80, 0x3b, 
+  0x19, 0x00, 0x00, 0x00, 0x73, 0x65, 0x72, 0x76, 0x69, 0x6e, 0x67, 0x5f, 
+  0x64, 0x65, 0x66, 0x61, 0x75, 0x6c, 0x74, 0x5f, 0x69, 0x6e, 0x70, 0x75, 
+  0x74, 0x5f, 0x34, 0x3a, 0x30, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 
+  0x01, 0x00, 0x00, 0x00, 0x12, 0x1d, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 
+  0x04, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 
+  0x20, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x0c, 0x00, 
+  0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x0c, 0x00, 0x00, 0x00, 
+  0x00, 0x00, 0x00, 0x72, 0x72, 0x00, 0x00, 0x00, 0xf0, 0xff, 0xff, 0xff, 
+  0x00, 0x00, 0x00, 0x19, 0x02, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 
+  0x0c, 0x00, 0x10, 0x00, 0x07, 0x00, 0x00, 0x00, 0x08, 0x00, 0x0c, 0x00, 
+  0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x04, 0x00, 0x00, 0x00, 
+  0x09, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x10, 0x00, 0x07, 0x00, 0x08, 0x00, 
+  0x00, 0x00, 0x0c, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 
+  0x08, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 
+  0x53, 0x49, 0x47, 0x4e, 0x53, 0x41, 0x59, 0x41, 0x5f, 0x43, 0x4f, 0x4e, 
+  0x56, 0x5f, 0x4d, 0x41, 0x58, 0x00, 0x00, 0x00
+};
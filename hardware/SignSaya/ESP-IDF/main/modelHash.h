@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 32 bit FNV-1a of a flatbuffer. The generated headers record the hash of
+// the model they were made from, a retrained model of the same size still
+// changes it.
+inline uint32_t modelHash(const unsigned char *data, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t index = 0; index < length; index++) {
+    hash = (hash ^ data[index]) * 16777619u;
+  }
+  return hash;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "fusedConvMax.h"
+
+// The ops the signsaya model needs, shared by AiModel and the host tools so
+// both run the graph with the same kernels registered. Covers the original
+// graph and the fused one from host/fuse_model.
+#define MODEL_OP_COUNT 9
+
+typedef tflite::MicroMutableOpResolver<MODEL_OP_COUNT> ModelOpResolver;
+
+inline TfLiteStatus registerModelOps(ModelOpResolver &resolver) {
+  if (resolver.AddReduceMax() != kTfLiteOk) return kTfLiteError;
+  if (resolver.AddDequantize() != kTfLiteOk) return kTfLiteError;
+  if (resolver.AddQuantize() != kTfLiteOk) return kTfLiteError;
+  if (resolver.AddExpandDims() != kTfLiteOk) return kTfLiteError;
+  if (resolver.AddSoftmax() != kTfLiteOk) return kTfLiteError;
+  if (resolver.AddConv2D() != kTfLiteOk) return kTfLiteError;
+  if (resolver.AddReshape() != kTfLiteOk) return kTfLiteError;
+  if (resolver.AddFullyConnected() != kTfLiteOk) return kTfLiteError;
+  if (resolver.AddCustom(FUSED_CONV_MAX_OP, FusedConvMax::registration()) != kTfLiteOk) return kTfLiteError;
+  return kTfLiteOk;
+}
@@ -52,6 +52,7 @@ SPIClass* spiObj = NULL;
 #include "I2Cdev.h"
 #endif
 #include "MPU6050_6Axis_MotionApps612.h"
+#include "quatQuantize.h"
 //#include "MPU6050.h" // not necessary if using MotionApps include file
 
 
@@ -96,6 +97,11 @@ void dmpDataReady() {
 class accelSensor {
 private:
   quaternion_t angles;
+  uint8_t packetBuffer[MPU_FIFO_PACKETS * 28];  // 28 byte MotionApps 6.12 packets
+  uint32_t packetTimes[MPU_FIFO_PACKETS];
+  uint16_t packetCount = 0;
+  uint16_t packetIndex = 0;
+  uint8_t *packet = NULL;
 public:
 #ifdef USE_SPI
   void begin(const uint8_t SDI_PIN, const uint8_t SCK_PIN, const uint8_t SDO_PIN, const uint8_t CS_PIN) {
@@ -127,6 +133,7 @@ public:
     Serial.println(F("Initializing I2C devices..."));
 #endif
     mpu.initialize();
+    I2CdevAsync::begin();
 
 #ifdef USE_LOGGING
     // verify connection
@@ -193,24 +200,70 @@ public:
   };
 
 
-  quaternion_t getData() {
+  // Reads every complete packet buffered in the FIFO, checkDataReady() then
+  // walks them oldest first without touching the bus
+  void drainFIFO() {
+    packetIndex = 0;
+    packetCount = 0;
+    if (!dmpReady) return;
+    packetCount = mpu.dmpGetFIFOPackets(packetBuffer, MPU_FIFO_PACKETS, packetTimes);
+  }
 
-    // if programming failed, don't try to do anything
-    if (!dmpReady) return angles;
-    // read a packet from FIFO
-    if (mpu.dmpGetCurrentFIFOPacket(fifoBuffer)) {  // Get the Latest packet
-      mpu.dmpGetQuaternion(&q, fifoBuffer);
-      double q1 = ((double)q.x) / 1073741824.0;  // Convert to double. Divide by 2^30
-      double q2 = ((double)q.y) / 1073741824.0;  // Convert to double. Divide by 2^30
-      double q3 = ((double)q.z) / 1073741824.0;  // Convert to double. Divide by 2^30
-      double q0 = ((double)q.w) / 1073741824.0;
-
-      angles.x = (uint8_t)((q1 + 1.0f) * 127.5f);
-      angles.y = (uint8_t)((q2 + 1.0f) * 127.5f);
-      angles.z = (uint8_t)((q3 + 1.0f) * 127.5f);
-      angles.w = (uint8_t)((q0 + 1.0f) * 127.5f);
-      return angles;
+  bool checkDataReady() {
+    if (packetIndex >= packetCount) {
+      return false;
     }
+    packet = &packetBuffer[packetIndex * packetSize];
+    angles.timestamp = packetTimes[packetIndex];
+    packetIndex++;
+    return true;
+  }
+
+  void resetFIFO() {
+    mpu.resetFIFO();
+    packetIndex = 0;
+    packetCount = 0;
+  }
+
+  // packets lost to FIFO overflows since startup
+  uint32_t droppedPackets() {
+    return mpu.getFIFODroppedPackets();
+  }
+
+  quaternion_t getData() {
+    if (packet == NULL) return angles;
+    int32_t quat[4];  // w, x, y, z as Q30
+    mpu.dmpGetQuaternion(quat, packet);
+#ifdef USE_FIXED_QUATERNION
+    angles.x = quantizeQ30(quat[1]);
+    angles.y = quantizeQ30(quat[2]);
+    angles.z = quantizeQ30(quat[3]);
+    angles.w = quantizeQ30(quat[0]);
+#else
+    double q1 = ((double)quat[1]) / 1073741824.0;  // Convert to double. Divide by 2^30
+    double q2 = ((double)quat[2]) / 1073741824.0;  // Convert to double. Divide by 2^30
+    double q3 = ((double)quat[3]) / 1073741824.0;  // Convert to double. Divide by 2^30
+    double q0 = ((double)quat[0]) / 1073741824.0;
+
+    angles.x = (uint8_t)((q1 + 1.0f) * 127.5f);
+    angles.y = (uint8_t)((q2 + 1.0f) * 127.5f);
+    angles.z = (uint8_t)((q3 + 1.0f) * 127.5f);
+    angles.w = (uint8_t)((q0 + 1.0f) * 127.5f);
+#endif
     return angles;
   }
+
+  // The packet checkDataReady() is on as the DMP wrote it, for sensor traces.
+  // Traces keep x, y and z like the ICM's Quat9, w is rebuilt on replay.
+  rawQuaternion_t getRawData() {
+    rawQuaternion_t raw = {};
+    raw.timestamp = angles.timestamp;
+    if (packet == NULL) return raw;
+    int32_t quat[4];
+    mpu.dmpGetQuaternion(quat, packet);
+    raw.q1 = quat[1];
+    raw.q2 = quat[2];
+    raw.q3 = quat[3];
+    return raw;
+  }
 };
\ No newline at end of file
@@ -0,0 +1,168 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/micro_profiler_interface.h"
+#include "tensorflow/lite/micro/micro_time.h"
+
+// Per-op latency histograms fed by the interpreter's profiling hooks.
+// MicroProfiler keeps every event (4096 of them, ~80kB), this only keeps one
+// row per tag: count, total, min, max and a log2 histogram of the durations
+// in microseconds, enough for percentiles over any number of invokes.
+// Ticks come from tflite::GetCurrentTimeTicks(), the cycle counter on the
+// S3 and CLOCK_MONOTONIC on a Linux host.
+
+#define OP_PROFILER_TAGS 16
+#define OP_PROFILER_OPEN 8     // events open at the same time
+#define OP_PROFILER_BUCKETS 24  // 1us .. 8s
+
+class OpProfiler : public tflite::MicroProfilerInterface {
+public:
+  struct OpStats {
+    const char *tag;
+    uint32_t count;
+    uint64_t totalMicros;
+    uint32_t minMicros;
+    uint32_t maxMicros;
+    uint32_t buckets[OP_PROFILER_BUCKETS];  // bucket b holds durations below 2^b us
+  };
+
+private:
+  OpStats stats[OP_PROFILER_TAGS];
+  uint8_t tagCount = 0;
+  uint32_t droppedEvents = 0;
+
+  struct OpenEvent {
+    const char *tag;
+    uint32_t startTicks;
+  };
+  OpenEvent open[OP_PROFILER_OPEN];
+  uint8_t openCount = 0;
+
+  OpStats *find(const char *tag) {
+    for (uint8_t index = 0; index < tagCount; index++) {
+      // tags are string literals, the pointer compare nearly always hits
+      if (stats[index].tag == tag || strcmp(stats[index].tag, tag) == 0) {
+        return &stats[index];
+      }
+    }
+    if (tagCount >= OP_PROFILER_TAGS) {
+      return nullptr;
+    }
+    OpStats *entry = &stats[tagCount++];
+    memset(entry, 0, sizeof(OpStats));
+    entry->tag = tag;
+    entry->minMicros = UINT32_MAX;
+    return entry;
+  }
+
+  static uint8_t bucketOf(uint32_t micros) {
+    uint8_t bucket = 0;
+    while (bucket < OP_PROFILER_BUCKETS - 1 && micros >= (1UL << bucket)) {
+      bucket++;
+    }
+    return bucket;
+  }
+
+public:
+  OpProfiler() {
+    reset();
+  }
+
+  void reset() {
+    tagCount = 0;
+    openCount = 0;
+    droppedEvents = 0;
+  }
+
+  uint32_t BeginEvent(const char *tag) override {
+    if (openCount >= OP_PROFILER_OPEN) {
+      droppedEvents++;
+      return OP_PROFILER_OPEN;
+    }
+    open[openCount].tag = tag;
+    open[openCount].startTicks = tflite::GetCurrentTimeTicks();
+    return openCount++;
+  }
+
+  // Events nest, so the handle is always the innermost open one
+  void EndEvent(uint32_t handle) override {
+    uint32_t endTicks = tflite::GetCurrentTimeTicks();
+    if (handle >= openCount) {
+      return;
+    }
+    openCount = handle;
+    record(open[handle].tag, endTicks - open[handle].startTicks);
+  }
+
+  void record(const char *tag, uint32_t ticks) {
+    OpStats *entry = find(tag);
+    if (entry == nullptr) {
+      droppedEvents++;
+      return;
+    }
+    uint32_t ticksPerMicro = tflite::ticks_per_second() / 1000000;
+    uint32_t micros = ticksPerMicro > 0 ? ticks / ticksPerMicro : 0;
+    entry->count++;
+    entry->totalMicros += micros;
+    if (micros < entry->minMicros) {
+      entry->minMicros = micros;
+    }
+    if (micros > entry->maxMicros) {
+      entry->maxMicros = micros;
+    }
+    entry->buckets[bucketOf(micros)]++;
+  }
+
+  uint8_t size() const {
+    return tagCount;
+  }
+
+  const OpStats &at(uint8_t index) const {
+    return stats[index];
+  }
+
+  uint32_t dropped() const {
+    return droppedEvents;
+  }
+
+  // Upper bound of the bucket holding the given percentile, in microseconds
+  static uint32_t percentile(const OpStats &entry, uint8_t percent) {
+    uint32_t target = (entry.count * percent + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t bucket = 0; bucket < OP_PROFILER_BUCKETS; bucket++) {
+      seen += entry.buckets[bucket];
+      if (seen >= target && seen > 0) {
+        uint32_t bound = (bucket == 0) ? 1 : (1UL << bucket);
+        return bound < entry.maxMicros ? bound : entry.maxMicros;
+      }
+    }
+    return entry.maxMicros;
+  }
+
+  static const char *csvHeader() {
+    return "tag,count,total_us,mean_us,min_us,max_us,p50_us,p90_us,p99_us";
+  }
+
+  // One CSV row per tag, returns the length written like snprintf
+  int formatCsvRow(uint8_t index, char *buffer, size_t length) const {
+    const OpStats &entry = stats[index];
+    uint32_t mean = entry.count > 0 ? (uint32_t)(entry.totalMicros / entry.count) : 0;
+    return snprintf(buffer, length, "%s,%lu,%llu,%lu,%lu,%lu,%lu,%lu,%lu", entry.tag,
+                    (unsigned long)entry.count, (unsigned long long)entry.totalMicros, (unsigned long)mean,
+                    (unsigned long)(entry.count > 0 ? entry.minMicros : 0), (unsigned long)entry.maxMicros,
+                    (unsigned long)percentile(entry, 50), (unsigned long)percentile(entry, 90),
+                    (unsigned long)percentile(entry, 99));
+  }
+
+  // Whole table through MicroPrintf, i.e. the serial console on the device
+  void logCsv() const {
+    char row[128];
+    MicroPrintf("%s", csvHeader());
+    for (uint8_t index = 0; index < tagCount; index++) {
+      formatCsvRow(index, row, sizeof(row));
+      MicroPrintf("%s", row);
+    }
+  }
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include "types.h"
+
+// Integer only conversion of the DMP's Q30 quaternions to the 0-255
+// quaternion_t encoding. Gives the same bytes as the double path
+//   (uint8_t)((q / 2^30 + 1.0) * 127.5)
+// without touching the FPU, the S3 has no double precision hardware so that
+// path is all soft-float. Inputs outside -1..1 clamp to 0 or 255.
+
+#define Q30_ONE (1L << 30)
+#define QUATERNION_W_DOUBLE_ONE 320  // largest Q60 x^2 + y^2 + z^2 the double path maps to w = 255
+
+// floor((q + 2^30) * 255 / 2^31), exactly what the double expression rounds to
+inline uint8_t quantizeQ30(int32_t q) {
+  if (q <= -Q30_ONE) {
+    return 0;
+  }
+  if (q >= Q30_ONE) {
+    return 255;
+  }
+  return (uint8_t)(((uint64_t)(q + Q30_ONE) * 255) >> 31);
+}
+
+inline uint8_t countLeadingZeros64(uint64_t value) {
+  return (uint8_t)__builtin_clzll(value);
+}
+
+// 1 / sqrt(x) at the middle of each sixteenth of 0.25..1, Q30
+static const uint32_t inverseSqrtSeeds[12] = {
+  2024667000, 1831380208, 1684624773, 1568300315, 1473161629, 1393471397,
+  1325455684, 1266516759, 1214800200, 1168942037, 1127913670, 1090922784
+};
+
+// 1 / sqrt(x) for x in 0.25..1 as Q32, result in 1..2 as Q30.
+// Table seed within 6%, then three Newton steps y = y * (3 - x * y^2) / 2.
+inline uint32_t inverseSqrtQ32(uint32_t x) {
+  uint64_t y = inverseSqrtSeeds[(x >> 28) - 4];
+  for (uint8_t step = 0; step < 3; step++) {
+    uint64_t ySquared = (y * y) >> 30;                    // Q30
+    uint64_t xySquared = ((uint64_t)x * ySquared) >> 32;  // Q30
+    y = (y * (((uint64_t)3 << 30) - xySquared)) >> 31;    // Q30
+  }
+  return (uint32_t)y;
+}
+
+// floor(sqrt(value)) for a Q60 value up to 1.0, so the result is Q30
+inline uint32_t sqrtQ60(uint64_t value) {
+  if (value == 0) {
+    return 0;
+  }
+  // scale into 0.25..1 as Q64 keeping the shift even
+  uint8_t shift = countLeadingZeros64(value) & ~1;
+  uint32_t x = (uint32_t)((value << shift) >> 32);
+  // sqrt(x) = x / sqrt(x), Q32 * Q30 >> 30 = Q32, then undo half the shift
+  uint64_t root = (((uint64_t)x * inverseSqrtQ32(x)) >> 30) >> (shift / 2);
+  // the truncated mantissa leaves root a step or two off, settle it exactly
+  while (root > 0 && root * root > value) {
+    root--;
+  }
+  while ((root + 1) * (root + 1) <= value) {
+    root++;
+  }
+  return (uint32_t)root;
+}
+
+// Quantized w of a unit quaternion from the other three, sqrt(1 - x^2 - y^2 - z^2).
+// The ICM's Quat9 only carries x, y and z. Rounds like the exact root would,
+// not the Q30 floor, so w just under 1 still lands on 255 as with doubles.
+inline uint8_t quantizeQuaternionW(int32_t x, int32_t y, int32_t z) {
+  uint64_t sum = (uint64_t)((int64_t)x * x) + (uint64_t)((int64_t)y * y) + (uint64_t)((int64_t)z * z);
+  const uint64_t one = (uint64_t)1 << 60;
+  if (sum >= one) {
+    return quantizeQ30(0);
+  }
+  // doubles round 1 - sum, its root and w + 1 back up to exactly 1 while
+  // sum is within a few ulps, so w stays 255 a little past the exact cutoff
+  if (sum <= QUATERNION_W_DOUBLE_ONE) {
+    return 255;
+  }
+  uint64_t remainder = one - sum;
+  uint32_t root = sqrtQ60(remainder);
+  uint8_t level = quantizeQ30((int32_t)root);
+  if (level == 255) {
+    return level;
+  }
+  // the next level starts at (step + root) with step = (level + 1) * 2^31 / 255 - 2^30 - root,
+  // so it is reached when 255 * root + offset <= 255 * sqrt(remainder)
+  int64_t offset = (int64_t)(level + 1) * (1LL << 31) - 255LL * Q30_ONE - 255LL * root;
+  if (offset <= 0) {
+    return level + 1;
+  }
+  if (offset < 255) {
+    uint64_t fraction = remainder - (uint64_t)root * root;
+    if (510ULL * root * (uint64_t)offset + (uint64_t)(offset * offset) <= 65025ULL * fraction) {
+      return level + 1;
+    }
+  }
+  return level;
+}
+
+// The Quat9 x, y and z as quaternion_t bytes, w rebuilt from them
+inline void quantizeQuat9(int32_t q1, int32_t q2, int32_t q3, quaternion_t &result) {
+  result.x = quantizeQ30(q1);
+  result.y = quantizeQ30(q2);
+  result.z = quantizeQ30(q3);
+  result.w = quantizeQuaternionW(q1, q2, q3);
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include <cstdint>
+#include "types.h"
+
+// Resamples the finger and IMU streams onto one fixed rate clock.
+// Each source pushes its timestamped samples as they arrive; poll() then
+// emits exactly one Inference_t per tick. The clock runs FUSION_DELAY_US
+// behind real time so both streams usually have a sample on each side of
+// the tick to interpolate between, otherwise the newest sample is held.
+
+// Samples of the faster stream arriving in FUSION_DELAY_US, plus the one
+// before the tick and one for timing jitter
+#define FUSION_MAX_RATE (FINGER_SAMPLING_RATE > IMU_SAMPLE_RATE ? FINGER_SAMPLING_RATE : IMU_SAMPLE_RATE)
+#define FUSION_HISTORY (FUSION_DELAY_US * FUSION_MAX_RATE / 1000000UL + 3)
+
+// IMU samples show up a whole drain late, the parser polls every 1ms
+static_assert(FUSION_DELAY_US >= IMU_DELIVERY_US + 1000, "FUSION_DELAY_US is shorter than the IMU delivery latency");
+static_assert(FUSION_HISTORY <= 255, "SampleHistory counts in uint8_t");
+
+// signed difference so the comparisons survive micros() wrapping
+inline int32_t elapsedMicros(uint32_t from, uint32_t to) {
+  return (int32_t)(to - from);
+}
+
+inline uint8_t blendValue(uint8_t from, uint8_t to, uint16_t weight) {
+  return (uint8_t)(from + ((((int16_t)to - (int16_t)from) * weight + 128) >> 8));
+}
+
+// weight is 0..256, 0 being from and 256 being to
+inline handData_t blendSample(const handData_t &from, const handData_t &to, uint16_t weight) {
+  handData_t result;
+  result.pinky = blendValue(from.pinky, to.pinky, weight);
+  result.ring = blendValue(from.ring, to.ring, weight);
+  result.middle = blendValue(from.middle, to.middle, weight);
+  result.index = blendValue(from.index, to.index, weight);
+  result.thumb = blendValue(from.thumb, to.thumb, weight);
+  return result;
+}
+
+// component wise, close enough to a slerp at these sample intervals
+inline quaternion_t blendSample(const quaternion_t &from, const quaternion_t &to, uint16_t weight) {
+  quaternion_t result;
+  result.w = blendValue(from.w, to.w, weight);
+  result.x = blendValue(from.x, to.x, weight);
+  result.y = blendValue(from.y, to.y, weight);
+  result.z = blendValue(from.z, to.z, weight);
+  return result;
+}
+
+// Last few samples of one stream, oldest first
+template <class Sample>
+class SampleHistory {
+private:
+  Sample samples[FUSION_HISTORY];
+  uint8_t count = 0;
+  uint8_t head = 0;  // index of the oldest sample
+
+  const Sample &at(uint8_t index) const {
+    return samples[(head + index) % FUSION_HISTORY];
+  }
+
+public:
+  void reset() {
+    count = 0;
+    head = 0;
+  }
+
+  bool isEmpty() const {
+    return count == 0;
+  }
+
+  void push(const Sample &sample) {
+    // repeated reads of the same sample only refresh the values
+    if (count > 0 && at(count - 1).timestamp == sample.timestamp) {
+      samples[(head + count - 1) % FUSION_HISTORY] = sample;
+      return;
+    }
+    if (count < FUSION_HISTORY) {
+      samples[(head + count) % FUSION_HISTORY] = sample;
+      count++;
+    } else {
+      samples[head] = sample;
+      head = (head + 1) % FUSION_HISTORY;
+    }
+  }
+
+  // Value of the stream at time, interpolated between the samples around it
+  // or holding the closest one when time is outside the history
+  Sample sampleAt(uint32_t time, bool interpolate) const {
+    if (elapsedMicros(at(0).timestamp, time) <= 0) {
+      return at(0);
+    }
+    for (uint8_t index = 1; index < count; index++) {
+      const Sample &after = at(index);
+      if (elapsedMicros(after.timestamp, time) < 0) {
+        const Sample &before = at(index - 1);
+        if (!interpolate) {
+          return before;
+        }
+        uint32_t span = after.timestamp - before.timestamp;
+        uint16_t weight = (uint16_t)(((uint64_t)(time - before.timestamp) * 256) / span);
+        Sample result = blendSample(before, after, weight);
+        result.timestamp = time;
+        return result;
+      }
+    }
+    return at(count - 1);
+  }
+};
+
+class SensorFusion {
+private:
+  SampleHistory<handData_t> hand;
+  SampleHistory<quaternion_t> imu;
+  uint32_t period;
+  uint32_t delay;
+  bool interpolate;
+  uint32_t nextTick = 0;
+  uint32_t lastTick = 0;
+  bool clockStarted = false;
+  uint32_t skippedTicks = 0;
+
+public:
+  SensorFusion(uint16_t rate, uint32_t delayMicros, bool useInterpolation)
+    : period(1000000UL / rate), delay(delayMicros), interpolate(useInterpolation) {
+  }
+
+  void reset() {
+    hand.reset();
+    imu.reset();
+    clockStarted = false;
+  }
+
+  void addHand(const handData_t &sample) {
+    hand.push(sample);
+  }
+
+  void addImu(const quaternion_t &sample) {
+    imu.push(sample);
+  }
+
+  // Time of the row poll() wrote last
+  uint32_t tickTime() const {
+    return lastTick;
+  }
+
+  // Ticks dropped because poll() fell too far behind, e.g. while suspended
+  uint32_t skipped() const {
+    return skippedTicks;
+  }
+
+  // Writes the fused row for the next tick if it is due at now.
+  // Call until it returns false to catch up on every due tick.
+  bool poll(uint32_t now, Inference_t &entry) {
+    if (hand.isEmpty() || imu.isEmpty()) {
+      return false;
+    }
+    uint32_t delayed = now - delay;
+    if (!clockStarted) {
+      nextTick = delayed;
+      clockStarted = true;
+    }
+    int32_t lag = elapsedMicros(nextTick, delayed);
+    if (lag < 0) {
+      return false;
+    }
+    // restart the clock instead of emitting a burst of held rows
+    if ((uint32_t)lag > period * FUSION_HISTORY) {
+      skippedTicks += lag / period;
+      nextTick = delayed;
+    }
+
+    handData_t handSample = hand.sampleAt(nextTick, interpolate);
+    quaternion_t imuSample = imu.sampleAt(nextTick, interpolate);
+    entry.pinky = handSample.pinky;
+    entry.ring = handSample.ring;
+    entry.middle = handSample.middle;
+    entry.index = handSample.index;
+    entry.thumb = handSample.thumb;
+    entry.w = imuSample.w;
+    entry.x = imuSample.x;
+    entry.y = imuSample.y;
+    entry.z = imuSample.z;
+
+    lastTick = nextTick;
+    nextTick += period;
+    return true;
+  }
+};
@@ -0,0 +1,171 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "types.h"
+#include "trainRecord.h"
+
+// Sensor traces: the raw inputs of the pipeline, for replaying it off the
+// glove (host/pipeline_sim). A trace is SENSOR_TRACE_HEADER_BYTES of header
+//   bytes 0-3  SENSOR_TRACE_MAGIC
+//   byte 4     SENSOR_TRACE_VERSION
+//   bytes 5-7  0
+// then records in time order, each a kind byte, the micros() since the
+// record before as an unsigned LEB128 varint (since 0 for the first), and
+//   SENSOR_TRACE_ADC   the five raw 12 bit finger readings, handData_t
+//                      order, packed LSB first into 8 bytes (putAdc12)
+//   SENSOR_TRACE_DMP   the DMP's Quat9 Q1, Q2, Q3 as little endian int32, Q30
+//   SENSOR_TRACE_MARK  one byte, the sign being performed from here on, or
+//                      SENSOR_TRACE_NO_SIGN; only from a labelled source
+// A sample of each stream every 1/60s comes to about 28 bytes, 1.7 kB/s.
+
+#define SENSOR_TRACE_MAGIC 0x544e4753  // "SGNT"
+#define SENSOR_TRACE_VERSION 1
+#define SENSOR_TRACE_HEADER_BYTES 8
+#define SENSOR_TRACE_ADC 1
+#define SENSOR_TRACE_DMP 2
+#define SENSOR_TRACE_MARK 3
+#define SENSOR_TRACE_NO_SIGN 0xff
+#define SENSOR_TRACE_MAX_RECORD_BYTES 18  // kind, 5 byte varint, 12 byte payload
+
+typedef struct {
+  uint8_t kind;
+  uint32_t timestamp;
+  uint16_t adc[FINGER_COUNT];  // SENSOR_TRACE_ADC
+  int32_t quat[3];             // SENSOR_TRACE_DMP
+  uint8_t sign;                // SENSOR_TRACE_MARK
+} SensorTraceRecord_t;
+
+class SensorTraceWriter {
+private:
+  uint32_t lastTimestamp = 0;
+  bool started = false;
+
+  static size_t putVarint(uint8_t *out, uint32_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+      out[length++] = (uint8_t)(value | 0x80);
+      value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+  }
+
+  size_t start(uint8_t *out, uint8_t kind, uint32_t timestamp) {
+    out[0] = kind;
+    size_t length = 1 + putVarint(out + 1, started ? timestamp - lastTimestamp : 0);
+    lastTimestamp = timestamp;
+    started = true;
+    return length;
+  }
+
+public:
+  // Writes the header into out, SENSOR_TRACE_HEADER_BYTES
+  size_t header(uint8_t *out) {
+    started = false;
+    putU32(out, SENSOR_TRACE_MAGIC);
+    out[4] = SENSOR_TRACE_VERSION;
+    out[5] = out[6] = out[7] = 0;
+    return SENSOR_TRACE_HEADER_BYTES;
+  }
+
+  // Each writes one record into out, at most SENSOR_TRACE_MAX_RECORD_BYTES,
+  // and returns its size. Timestamps must not go backwards.
+  size_t adc(uint8_t *out, uint32_t timestamp, const uint16_t raw[FINGER_COUNT]) {
+    size_t length = start(out, SENSOR_TRACE_ADC, timestamp);
+    putAdc12(out + length, raw);
+    return length + 8;
+  }
+
+  size_t dmp(uint8_t *out, uint32_t timestamp, int32_t q1, int32_t q2, int32_t q3) {
+    size_t length = start(out, SENSOR_TRACE_DMP, timestamp);
+    putU32(out + length, (uint32_t)q1);
+    putU32(out + length + 4, (uint32_t)q2);
+    putU32(out + length + 8, (uint32_t)q3);
+    return length + 12;
+  }
+
+  size_t mark(uint8_t *out, uint32_t timestamp, uint8_t sign) {
+    size_t length = start(out, SENSOR_TRACE_MARK, timestamp);
+    out[length++] = sign;
+    return length;
+  }
+};
+
+class SensorTraceReader {
+private:
+  const uint8_t *data = nullptr;
+  size_t length = 0;
+  size_t offset = 0;
+  uint32_t timestamp = 0;
+
+  bool getVarint(uint32_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      if (offset >= length) {
+        return false;
+      }
+      uint8_t byte = data[offset++];
+      value |= (uint32_t)(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+public:
+  // false when trace is not a trace of this version
+  bool begin(const uint8_t *trace, size_t traceLength) {
+    data = trace;
+    length = traceLength;
+    offset = SENSOR_TRACE_HEADER_BYTES;
+    timestamp = 0;
+    return traceLength >= SENSOR_TRACE_HEADER_BYTES
+        && getU32(trace) == SENSOR_TRACE_MAGIC && trace[4] == SENSOR_TRACE_VERSION;
+  }
+
+  // The next record, false at the end or at a damaged record
+  bool next(SensorTraceRecord_t &record) {
+    if (offset >= length) {
+      return false;
+    }
+    record.kind = data[offset++];
+    uint32_t delta;
+    if (!getVarint(delta)) {
+      return false;
+    }
+    timestamp += delta;
+    record.timestamp = timestamp;
+    if (record.kind == SENSOR_TRACE_ADC) {
+      if (length - offset < 8) {
+        return false;
+      }
+      getAdc12(data + offset, record.adc);
+      offset += 8;
+      return true;
+    }
+    if (record.kind == SENSOR_TRACE_DMP) {
+      if (length - offset < 12) {
+        return false;
+      }
+      for (int component = 0; component < 3; component++) {
+        record.quat[component] = (int32_t)getU32(data + offset);
+        offset += 4;
+      }
+      return true;
+    }
+    if (record.kind == SENSOR_TRACE_MARK) {
+      if (offset >= length) {
+        return false;
+      }
+      record.sign = data[offset++];
+      return true;
+    }
+    return false;
+  }
+
+  // Reached the end without running into a damaged record
+  bool atEnd() const {
+    return offset == length;
+  }
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include "types.h"
+#include "spscRing.h"
+#include "sensorFusion.h"
+#include "inferenceWindow.h"
+#include "inferenceHandoff.h"
+
+// What the glove's tasks do with each wake-up, without the waiting and the
+// hardware around it, so host/pipeline_sim replays sensor traces through the
+// same code. main.cpp's tasks block on their sensor or notification and call
+// these; the simulator calls them from its own clock.
+
+#define NO_SIGN_SENT 15  // lastSent before the first result, not a class
+
+// handSamplerFunc: one ADC frame filtered and scaled, fingers in handData_t order
+template <class Finger>
+handData_t fingerFrame(Finger *const fingers[FINGER_COUNT], const uint16_t raw[FINGER_COUNT], uint32_t now) {
+  handData_t frame;
+  frame.timestamp = now;
+  frame.pinky = fingers[0]->read(raw[0]);
+  frame.ring = fingers[1]->read(raw[1]);
+  frame.middle = fingers[2]->read(raw[2]);
+  frame.index = fingers[3]->read(raw[3]);
+  frame.thumb = fingers[4]->read(raw[4]);
+  return frame;
+}
+
+// aiInferenceParser: drains both rings into the fusion stage, pushes the rows
+// due at now and hands a window to inference once INFERENCE_WINDOW new rows
+// are in. True when a window was published, wake the inference task then.
+template <uint32_t ImuLength, uint32_t HandLength>
+bool parseStep(SpscRing<quaternion_t, ImuLength> &imuRing, SpscRing<handData_t, HandLength> &handRing,
+               SensorFusion &fusion, InferenceWindow &window, InferenceHandoff &handoff, uint32_t now) {
+  quaternion_t imuSamples[ImuLength];
+  handData_t handSamples[HandLength];
+  uint32_t received = imuRing.pop(imuSamples, ImuLength);
+  for (uint32_t index = 0; index < received; index++) {
+    fusion.addImu(imuSamples[index]);
+  }
+  received = handRing.pop(handSamples, HandLength);
+  for (uint32_t index = 0; index < received; index++) {
+    fusion.addHand(handSamples[index]);
+  }
+
+  // one time aligned row per FUSION_RATE tick, written over the oldest
+  Inference_t row;
+  while (fusion.poll(now, row)) {
+    window.push(row);
+  }
+  if (window.pending() < INFERENCE_WINDOW || !window.oldestIsValid()) {
+    return false;
+  }
+  // fills whichever buffer inference is not running on, or writes over
+  // the window it has not got to yet
+  int8_t slot = handoff.acquire();
+  if (slot < 0) {
+    return false;
+  }
+  uint32_t newRows = window.pending();
+  window.linearize(handoff.buffer(slot));
+  handoff.publish(slot, newRows);
+  return true;
+}
+
+// aiInferenceFunc: runs the model on the newest published window, false when
+// there is none. Model is AiModel (aiTest.h).
+template <class Model>
+bool inferStep(InferenceHandoff &handoff, Model &model, Result_t &result) {
+  uint32_t newRows = 0;
+  int8_t slot = handoff.take(newRows);
+  if (slot < 0) {
+    return false;
+  }
+#ifdef USE_STREAMING_INFERENCE
+  result = model.inferStreaming(handoff.buffer(slot), newRows);
+#else
+  result = model.infer(handoff.buffer(slot));
+#endif
+  handoff.release(slot);
+  return true;
+}
+
+// Whether result goes out over BLE: only when the sign changes
+inline bool shouldSend(const Result_t &result, uint8_t &lastSent) {
+  if (result.result == lastSent) {
+    return false;
+  }
+  lastSent = result.result;
+  return true;
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#endif
+
+// Single producer, single consumer ring for the point to point sensor links.
+// Each side owns one free running index and only reads the other's, so a
+// push or pop is a load, a copy and a release store without a critical
+// section. The indices sit on their own cache lines with a copy of the other
+// side's index that is only refreshed when the ring looks full or empty, so
+// the steady state does not bounce a line between the cores.
+// A full ring refuses the push and counts it, the producer never blocks.
+#define SPSC_RING_LINE_BYTES 64  // 32 on the S3's data cache, 64 covers host CPUs too
+
+template <typename T, uint32_t Capacity>
+class SpscRing {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+  // producer's line
+  alignas(SPSC_RING_LINE_BYTES) std::atomic<uint32_t> head{ 0 };
+  uint32_t cachedTail = 0;
+  std::atomic<uint32_t> overflows{ 0 };
+#ifdef ESP_PLATFORM
+  TaskHandle_t consumer = nullptr;
+#endif
+
+  // consumer's line
+  alignas(SPSC_RING_LINE_BYTES) std::atomic<uint32_t> tail{ 0 };
+  uint32_t cachedHead = 0;
+
+  alignas(SPSC_RING_LINE_BYTES) T slots[Capacity];
+
+  void published() {
+#ifdef ESP_PLATFORM
+    if (consumer != nullptr) {
+      xTaskNotifyGive(consumer);
+    }
+#endif
+  }
+
+public:
+  static constexpr uint32_t capacity() {
+    return Capacity;
+  }
+
+  // Producer: false and counted as an overflow when the ring is full
+  bool push(const T &item) {
+    uint32_t position = head.load(std::memory_order_relaxed);
+    if (position - cachedTail == Capacity) {
+      cachedTail = tail.load(std::memory_order_acquire);
+      if (position - cachedTail == Capacity) {
+        overflows.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+    }
+    slots[position & (Capacity - 1)] = item;
+    head.store(position + 1, std::memory_order_release);
+    published();
+    return true;
+  }
+
+  // Producer: as many of items as fit, published together, the rest counted
+  // as overflows. Returns how many went in.
+  uint32_t push(const T *items, uint32_t count) {
+    uint32_t position = head.load(std::memory_order_relaxed);
+    if (Capacity - (position - cachedTail) < count) {
+      cachedTail = tail.load(std::memory_order_acquire);
+    }
+    uint32_t room = Capacity - (position - cachedTail);
+    uint32_t accepted = count < room ? count : room;
+    for (uint32_t index = 0; index < accepted; index++) {
+      slots[(position + index) & (Capacity - 1)] = items[index];
+    }
+    if (accepted < count) {
+      overflows.fetch_add(count - accepted, std::memory_order_relaxed);
+    }
+    if (accepted > 0) {
+      head.store(position + accepted, std::memory_order_release);
+      published();
+    }
+    return accepted;
+  }
+
+  // Consumer: false when there is nothing to take
+  bool pop(T &item) {
+    uint32_t position = tail.load(std::memory_order_relaxed);
+    if (position == cachedHead) {
+      cachedHead = head.load(std::memory_order_acquire);
+      if (position == cachedHead) {
+        return false;
+      }
+    }
+    item = slots[position & (Capacity - 1)];
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer: up to count items in order, the slots freed together. Returns
+  // how many were taken.
+  uint32_t pop(T *items, uint32_t count) {
+    uint32_t position = tail.load(std::memory_order_relaxed);
+    if (cachedHead - position < count) {
+      cachedHead = head.load(std::memory_order_acquire);
+    }
+    uint32_t available = cachedHead - position;
+    uint32_t taken = count < available ? count : available;
+    for (uint32_t index = 0; index < taken; index++) {
+      items[index] = slots[(position + index) & (Capacity - 1)];
+    }
+    if (taken > 0) {
+      tail.store(position + taken, std::memory_order_release);
+    }
+    return taken;
+  }
+
+  // Either side, a snapshot that may be stale by the time it returns
+  bool isEmpty() const {
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+  }
+
+  // Pushes refused because the consumer fell behind
+  uint32_t overflowed() const {
+    return overflows.load(std::memory_order_relaxed);
+  }
+
+#ifdef ESP_PLATFORM
+  // Every push notifies task, set once before the producer starts. The
+  // consumer then sleeps in wait() instead of polling.
+  void notify(TaskHandle_t task) {
+    consumer = task;
+  }
+
+  // Consumer: blocks up to ticks for a push unless something is waiting
+  // already, true when there is something to pop
+  bool wait(TickType_t ticks) {
+    if (!isEmpty()) {
+      return true;
+    }
+    ulTaskNotifyTake(pdTRUE, ticks);
+    return !isEmpty();
+  }
+#endif
+};
@@ -0,0 +1,337 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/conv.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/fully_connected.h"
+#include "tensorflow/lite/kernels/internal/reference/softmax.h"
+#include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/micro_profiler.h"
+#ifdef ESP_PLATFORM
+#include "esp_nn.h"
+#endif
+
+// Streaming execution of the signsaya graph:
+//   Quantize -> ExpandDims -> Conv2D(1x3, VALID) -> Reshape -> ReduceMax(time)
+//   -> FullyConnected -> Softmax -> Quantize
+// Consecutive windows share all but the newest rows, so the conv columns of
+// rows already seen are kept in a ring and only the new columns are computed.
+// The ring is split into blocks with a cached max per channel, an update only
+// rescans the blocks it touched and the window max is taken over the blocks.
+class StreamingModel {
+public:
+  static constexpr int kKernelWidth = 3;
+  static constexpr int kChannels = 32;
+  static constexpr int kClasses = 14;
+  static constexpr int kConvLength = INFERENCE_LENGTH - kKernelWidth + 1;
+  static constexpr int kBlockLength = 40;
+  static constexpr int kBlocks = kConvLength / kBlockLength;
+  static constexpr int kChunkLength = 64;  // conv columns computed per kernel call
+  static_assert(kConvLength % kBlockLength == 0, "conv length must be a multiple of the block length");
+
+private:
+  int8_t convRing[kConvLength * kChannels];
+  int8_t blockMax[kBlocks * kChannels];
+  int8_t inputChunk[(kChunkLength + kKernelWidth - 1) * INFERENCE_FEATURES];
+  uint16_t ringHead = 0;  // slot holding the oldest conv column
+  bool primed = false;
+  bool ready = false;
+  tflite::MicroProfilerInterface *profiler = nullptr;
+
+  const int8_t *convWeights = nullptr;
+  const int32_t *convBias = nullptr;
+  int32_t convMultiplier[kChannels];
+  int32_t convShift[kChannels];
+  int32_t convInputOffset = 0;
+  int32_t convOutputOffset = 0;
+  void *convScratch = nullptr;
+
+  const int8_t *fcWeights = nullptr;
+  const int32_t *fcBias = nullptr;
+  tflite::FullyConnectedParams fcParams;
+  tflite::SoftmaxParams softmaxParams;
+  int32_t outputZeroPointDiff = 0;
+
+  int8_t pooled[kChannels];
+  int8_t logits[kClasses];
+  int8_t probabilities[kClasses];
+  uint8_t scores[kClasses];
+
+  static const tflite::Tensor *tensorAt(const tflite::SubGraph *subgraph, const tflite::Operator *op, int input) {
+    return subgraph->tensors()->Get(op->inputs()->Get(input));
+  }
+
+  static const void *bufferOf(const tflite::Model *model, const tflite::Tensor *tensor) {
+    const tflite::Buffer *buffer = model->buffers()->Get(tensor->buffer());
+    if (buffer == nullptr || buffer->data() == nullptr) return nullptr;
+    return buffer->data()->data();
+  }
+
+  static bool shapeIs(const tflite::Tensor *tensor, std::initializer_list<int> dims) {
+    if (tensor->shape() == nullptr || tensor->shape()->size() != dims.size()) return false;
+    int index = 0;
+    for (int dim : dims) {
+      if (tensor->shape()->Get(index++) != dim) return false;
+    }
+    return true;
+  }
+
+  static tflite::RuntimeShape shapeOf(std::initializer_list<int32_t> dims) {
+    return tflite::RuntimeShape(dims.size(), dims.begin());
+  }
+
+  static float scaleOf(const tflite::Tensor *tensor, int index = 0) {
+    return tensor->quantization()->scale()->Get(index);
+  }
+
+  static int32_t zeroPointOf(const tflite::Tensor *tensor) {
+    return static_cast<int32_t>(tensor->quantization()->zero_point()->Get(0));
+  }
+
+  static tflite::BuiltinOperator opCode(const tflite::Model *model, const tflite::Operator *op) {
+    const tflite::OperatorCode *code = model->operator_codes()->Get(op->opcode_index());
+    return std::max(static_cast<tflite::BuiltinOperator>(code->deprecated_builtin_code()), code->builtin_code());
+  }
+
+  // Conv columns for `length` consecutive output positions, rows points at the first input row
+  void computeColumns(const uint8_t *rows, int length, int8_t *out) {
+    const int inputRows = length + kKernelWidth - 1;
+    // Quantize op: uint8 (zp 0) -> int8 (zp -128) with the same scale
+    for (int i = 0; i < inputRows * INFERENCE_FEATURES; i++) {
+      inputChunk[i] = static_cast<int8_t>(rows[i] ^ 0x80);
+    }
+#ifdef ESP_PLATFORM
+    data_dims_t inputDims = { .width = inputRows, .height = 1, .channels = INFERENCE_FEATURES, 1 };
+    data_dims_t outputDims = { .width = length, .height = 1, .channels = kChannels, 1 };
+    data_dims_t filterDims = { .width = kKernelWidth, .height = 1, 0, 0 };
+    conv_params_t convParams = {
+      .in_offset = convInputOffset, .out_offset = convOutputOffset,
+      .stride = { 1, 1 }, .padding = { 0, 0 },
+      .dilation = { 0, 0 }, .activation = { -128, 127 }
+    };
+    quant_data_t quantData = { .shift = convShift, .mult = convMultiplier };
+    esp_nn_set_conv_scratch_buf(convScratch);
+    esp_nn_conv_s8(&inputDims, inputChunk, &filterDims, convWeights, convBias,
+                   &outputDims, out, &convParams, &quantData);
+#else
+    tflite::ConvParams convParams = {};
+    convParams.padding_type = tflite::PaddingType::kValid;
+    convParams.input_offset = convInputOffset;
+    convParams.output_offset = convOutputOffset;
+    convParams.stride_width = 1;
+    convParams.stride_height = 1;
+    convParams.dilation_width_factor = 1;
+    convParams.dilation_height_factor = 1;
+    convParams.quantized_activation_min = -128;
+    convParams.quantized_activation_max = 127;
+    tflite::reference_integer_ops::ConvPerChannel(
+      convParams, convMultiplier, convShift,
+      shapeOf({ 1, 1, inputRows, INFERENCE_FEATURES }), inputChunk,
+      shapeOf({ kChannels, 1, kKernelWidth, INFERENCE_FEATURES }), convWeights,
+      shapeOf({ kChannels }), convBias,
+      shapeOf({ 1, 1, length, kChannels }), out);
+#endif
+  }
+
+  void refreshBlock(int block) {
+    int8_t *blockValues = &blockMax[block * kChannels];
+    const int8_t *column = &convRing[block * kBlockLength * kChannels];
+    memcpy(blockValues, column, kChannels);
+    for (int slot = 1; slot < kBlockLength; slot++) {
+      column += kChannels;
+      for (int channel = 0; channel < kChannels; channel++) {
+        blockValues[channel] = std::max(blockValues[channel], column[channel]);
+      }
+    }
+  }
+
+public:
+  StreamingModel() {
+  }
+
+  // Reads the quantization parameters out of the flatbuffer, returns false if
+  // the graph is not the one this class was written for.
+  bool begin(const tflite::Model *model) {
+    const tflite::SubGraph *subgraph = model->subgraphs()->Get(0);
+    const tflite::BuiltinOperator expected[] = {
+      tflite::BuiltinOperator_QUANTIZE, tflite::BuiltinOperator_EXPAND_DIMS,
+      tflite::BuiltinOperator_CONV_2D, tflite::BuiltinOperator_RESHAPE,
+      tflite::BuiltinOperator_REDUCE_MAX, tflite::BuiltinOperator_FULLY_CONNECTED,
+      tflite::BuiltinOperator_SOFTMAX, tflite::BuiltinOperator_QUANTIZE
+    };
+    if (subgraph->operators()->size() != sizeof(expected) / sizeof(expected[0])) return false;
+    for (uint32_t i = 0; i < subgraph->operators()->size(); i++) {
+      if (opCode(model, subgraph->operators()->Get(i)) != expected[i]) return false;
+    }
+
+    // computeColumns quantizes with a sign flip, only right for uint8 zp 0 -> int8 zp -128 at one scale
+    const tflite::Operator *quantizeOp = subgraph->operators()->Get(0);
+    const tflite::Tensor *quantizeInput = tensorAt(subgraph, quantizeOp, 0);
+    const tflite::Tensor *quantizeOutput = subgraph->tensors()->Get(quantizeOp->outputs()->Get(0));
+    if (quantizeInput->type() != tflite::TensorType_UINT8 || quantizeOutput->type() != tflite::TensorType_INT8
+        || zeroPointOf(quantizeInput) != 0 || zeroPointOf(quantizeOutput) != -128
+        || scaleOf(quantizeInput) != scaleOf(quantizeOutput)) {
+      return false;
+    }
+
+    const tflite::Operator *convOp = subgraph->operators()->Get(2);
+    const tflite::Conv2DOptions *convOptions = convOp->builtin_options_as_Conv2DOptions();
+    if (convOptions == nullptr || convOptions->padding() != tflite::Padding_VALID
+        || convOptions->stride_w() != 1 || convOptions->dilation_w_factor() != 1
+        || convOptions->fused_activation_function() != tflite::ActivationFunctionType_NONE) {
+      return false;
+    }
+    const tflite::Tensor *convInput = tensorAt(subgraph, convOp, 0);
+    const tflite::Tensor *convFilter = tensorAt(subgraph, convOp, 1);
+    const tflite::Tensor *convBiasTensor = tensorAt(subgraph, convOp, 2);
+    const tflite::Tensor *convOutput = subgraph->tensors()->Get(convOp->outputs()->Get(0));
+    if (!shapeIs(convFilter, { kChannels, 1, kKernelWidth, INFERENCE_FEATURES })
+        || !shapeIs(convOutput, { 1, 1, kConvLength, kChannels })
+        || convFilter->quantization()->scale()->size() != kChannels) {
+      return false;
+    }
+    convWeights = static_cast<const int8_t *>(bufferOf(model, convFilter));
+    convBias = static_cast<const int32_t *>(bufferOf(model, convBiasTensor));
+    convInputOffset = -zeroPointOf(convInput);
+    convOutputOffset = zeroPointOf(convOutput);
+    for (int channel = 0; channel < kChannels; channel++) {
+      // Same math as PopulateConvolutionQuantizationParams
+      double effectiveScale = static_cast<double>(scaleOf(convInput)) * static_cast<double>(scaleOf(convFilter, channel)) / static_cast<double>(scaleOf(convOutput));
+      int shift;
+      tflite::QuantizeMultiplier(effectiveScale, &convMultiplier[channel], &shift);
+      convShift[channel] = shift;
+    }
+
+    const tflite::Operator *fcOp = subgraph->operators()->Get(5);
+    const tflite::Tensor *fcInput = tensorAt(subgraph, fcOp, 0);
+    const tflite::Tensor *fcFilter = tensorAt(subgraph, fcOp, 1);
+    const tflite::Tensor *fcBiasTensor = tensorAt(subgraph, fcOp, 2);
+    const tflite::Tensor *fcOutput = subgraph->tensors()->Get(fcOp->outputs()->Get(0));
+    if (!shapeIs(fcFilter, { kClasses, kChannels })) return false;
+    fcWeights = static_cast<const int8_t *>(bufferOf(model, fcFilter));
+    fcBias = static_cast<const int32_t *>(bufferOf(model, fcBiasTensor));
+    // Same math as GetQuantizedConvolutionMultipler
+    double fcScale = static_cast<double>(scaleOf(fcInput) * scaleOf(fcFilter)) / static_cast<double>(scaleOf(fcOutput));
+    int fcShift;
+    tflite::QuantizeMultiplier(fcScale, &fcParams.output_multiplier, &fcShift);
+    fcParams.output_shift = fcShift;
+    fcParams.input_offset = -zeroPointOf(fcInput);
+    fcParams.weights_offset = -zeroPointOf(fcFilter);
+    fcParams.output_offset = zeroPointOf(fcOutput);
+    fcParams.quantized_activation_min = -128;
+    fcParams.quantized_activation_max = 127;
+
+    const tflite::Operator *softmaxOp = subgraph->operators()->Get(6);
+    const tflite::Tensor *softmaxInput = tensorAt(subgraph, softmaxOp, 0);
+    // Same math as CalculateSoftmaxParams for int8
+    int inputLeftShift;
+    tflite::PreprocessSoftmaxScaling(static_cast<double>(softmaxOp->builtin_options_as_SoftmaxOptions()->beta()),
+                                     static_cast<double>(scaleOf(softmaxInput)), 5,
+                                     &softmaxParams.input_multiplier, &inputLeftShift);
+    softmaxParams.input_left_shift = inputLeftShift;
+    softmaxParams.diff_min = -1.0 * tflite::CalculateInputRadius(5, inputLeftShift);
+
+    const tflite::Operator *outputOp = subgraph->operators()->Get(7);
+    outputZeroPointDiff = zeroPointOf(subgraph->tensors()->Get(outputOp->outputs()->Get(0)))
+                          - zeroPointOf(tensorAt(subgraph, outputOp, 0));
+
+#ifdef ESP_PLATFORM
+    data_dims_t inputDims = { .width = kChunkLength + kKernelWidth - 1, .height = 1, .channels = INFERENCE_FEATURES, 1 };
+    data_dims_t outputDims = { .width = kChunkLength, .height = 1, .channels = kChannels, 1 };
+    data_dims_t filterDims = { .width = kKernelWidth, .height = 1, 0, 0 };
+    conv_params_t convParams = {
+      .in_offset = 0, .out_offset = 0, .stride = { 1, 1 }, .padding = { 0, 0 },
+      .dilation = { 0, 0 }, .activation = { -128, 127 }
+    };
+    int scratchSize = esp_nn_get_conv_scratch_size(&inputDims, &filterDims, &outputDims, &convParams);
+    if (scratchSize > 0) {
+      convScratch = malloc(scratchSize);
+      if (convScratch == nullptr) return false;
+    }
+#endif
+    reset();
+    ready = true;
+    return true;
+  }
+
+  bool isReady() const {
+    return ready;
+  }
+
+  // Stages of update() are reported under the ops they stand in for
+  void setProfiler(tflite::MicroProfilerInterface *eventProfiler) {
+    profiler = eventProfiler;
+  }
+
+  // Forget the cached columns, the next update recomputes the whole window
+  void reset() {
+    primed = false;
+    ringHead = 0;
+  }
+
+  // window holds INFERENCE_LENGTH rows oldest first, of which the last newRows
+  // arrived since the previous call. Returns the uint8 class scores.
+  const uint8_t *update(const uint8_t *window, uint32_t newRows) {
+    if (!primed || newRows >= kConvLength) {
+      newRows = kConvLength;
+      ringHead = 0;
+      primed = true;
+    }
+    convolveNewRows(window, newRows);
+    reduceWindow();
+    runHead();
+    for (int i = 0; i < kClasses; i++) {
+      scores[i] = static_cast<uint8_t>(probabilities[i] + outputZeroPointDiff);
+    }
+    return scores;
+  }
+
+private:
+  // Conv columns of the newest rows into the ring, rescanning the blocks they touch
+  void convolveNewRows(const uint8_t *window, uint32_t newRows) {
+    tflite::ScopedMicroProfiler event("STREAMING_CONV_2D", profiler);
+    int column = kConvLength - newRows;
+    int slot = ringHead;
+    int remaining = newRows;
+    while (remaining > 0) {
+      int length = std::min(std::min(remaining, kChunkLength), kConvLength - slot);
+      computeColumns(&window[column * INFERENCE_FEATURES], length, &convRing[slot * kChannels]);
+      for (int block = slot / kBlockLength; block <= (slot + length - 1) / kBlockLength; block++) {
+        refreshBlock(block);
+      }
+      column += length;
+      remaining -= length;
+      slot += length;
+      if (slot >= kConvLength) {
+        slot = 0;
+      }
+    }
+    ringHead = slot;
+  }
+
+  // ReduceMax over the window is the max over the cached block maxima
+  void reduceWindow() {
+    tflite::ScopedMicroProfiler event("STREAMING_REDUCE_MAX", profiler);
+    memcpy(pooled, blockMax, kChannels);
+    for (int block = 1; block < kBlocks; block++) {
+      const int8_t *blockValues = &blockMax[block * kChannels];
+      for (int channel = 0; channel < kChannels; channel++) {
+        pooled[channel] = std::max(pooled[channel], blockValues[channel]);
+      }
+    }
+  }
+
+  void runHead() {
+    tflite::ScopedMicroProfiler event("STREAMING_FC_SOFTMAX", profiler);
+    tflite::reference_integer_ops::FullyConnected(
+      fcParams, shapeOf({ 1, kChannels }), pooled,
+      shapeOf({ kClasses, kChannels }), fcWeights,
+      shapeOf({ kClasses }), fcBias,
+      shapeOf({ 1, kClasses }), logits);
+    tflite::reference_ops::Softmax(softmaxParams, shapeOf({ 1, kClasses }), logits,
+                                   shapeOf({ 1, kClasses }), probabilities);
+  }
+};
@@ -0,0 +1,281 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "types.h"
+
+// Binary training capture (USE_TRAIN_RECORDER): every finger frame and IMU
+// sample as a record, packed into fixed size blocks that are written whole,
+// one FAT sector each. A block, little endian:
+//   bytes 0-3    TRAIN_RECORD_MAGIC
+//   byte 4       TRAIN_RECORD_VERSION
+//   byte 5       0
+//   bytes 6-7    payload bytes
+//   bytes 8-9    session, the recording's file number
+//   bytes 10-11  records
+//   bytes 12-15  sequence number within the session, a gap is a lost block
+//   bytes 16-19  samples lost on the device so far in the session
+//   bytes 20-23  CRC-32 (IEEE) of bytes 0-19 and the payload
+//   then the records and zero padding up to TRAIN_BLOCK_BYTES.
+// A record is a kind byte and the sample:
+//   TRAIN_RECORD_HAND  timestamp u32, pinky, ring, middle, index, thumb
+//   TRAIN_RECORD_IMU   timestamp u32, w, x, y, z
+//   TRAIN_RECORD_RAW_HAND  timestamp u32, the five 12-bit ADC readings in
+//                          handData_t order packed LSB first into 8 bytes
+//   TRAIN_RECORD_RAW_IMU   timestamp u32, the DMP's x, y, z as int32 Q30
+// The raw kinds only with USE_SENSOR_TRACE.
+// The magic and CRC make blocks findable in a raw dump of the partition too.
+
+#define TRAIN_RECORD_MAGIC 0x524e4753  // "SGNR"
+#define TRAIN_RECORD_VERSION 1
+#define TRAIN_BLOCK_BYTES 4096  // CONFIG_FATFS_SECTOR_4096
+#define TRAIN_BLOCK_HEADER_BYTES 24
+#define TRAIN_RECORD_HAND 1
+#define TRAIN_RECORD_IMU 2
+#define TRAIN_RECORD_HAND_BYTES 10
+#define TRAIN_RECORD_IMU_BYTES 9
+#define TRAIN_RECORD_RAW_HAND 3
+#define TRAIN_RECORD_RAW_IMU 4
+#define TRAIN_RECORD_RAW_HAND_BYTES 13
+#define TRAIN_RECORD_RAW_IMU_BYTES 17
+
+inline uint32_t trainCrc32(const uint8_t *data, size_t length, uint32_t crc = 0) {
+  // reflected 0xedb88320, a nibble at a time
+  static const uint32_t table[16] = {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+  };
+  crc = ~crc;
+  for (size_t index = 0; index < length; index++) {
+    crc ^= data[index];
+    crc = (crc >> 4) ^ table[crc & 0x0f];
+    crc = (crc >> 4) ^ table[crc & 0x0f];
+  }
+  return ~crc;
+}
+
+inline void putU16(uint8_t *out, uint16_t value) {
+  out[0] = (uint8_t)value;
+  out[1] = (uint8_t)(value >> 8);
+}
+
+inline void putU32(uint8_t *out, uint32_t value) {
+  out[0] = (uint8_t)value;
+  out[1] = (uint8_t)(value >> 8);
+  out[2] = (uint8_t)(value >> 16);
+  out[3] = (uint8_t)(value >> 24);
+}
+
+inline uint16_t getU16(const uint8_t *in) {
+  return (uint16_t)(in[0] | in[1] << 8);
+}
+
+inline uint32_t getU32(const uint8_t *in) {
+  return (uint32_t)in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+}
+
+// FINGER_COUNT 12-bit readings in 8 bytes
+inline void putAdc12(uint8_t *out, const uint16_t raw[FINGER_COUNT]) {
+  uint64_t packed = 0;
+  for (int finger = 0; finger < FINGER_COUNT; finger++) {
+    packed |= (uint64_t)(raw[finger] & 0x0fff) << (12 * finger);
+  }
+  for (int index = 0; index < 8; index++) {
+    out[index] = (uint8_t)(packed >> (8 * index));
+  }
+}
+
+inline void getAdc12(const uint8_t *in, uint16_t raw[FINGER_COUNT]) {
+  uint64_t packed = 0;
+  for (int index = 0; index < 8; index++) {
+    packed |= (uint64_t)in[index] << (8 * index);
+  }
+  for (int finger = 0; finger < FINGER_COUNT; finger++) {
+    raw[finger] = (uint16_t)((packed >> (12 * finger)) & 0x0fff);
+  }
+}
+
+// Fills one block in place
+class TrainBlockWriter {
+private:
+  uint8_t *block = nullptr;
+  size_t length = 0;
+  uint16_t records = 0;
+  uint32_t firstTimestamp = 0;
+
+  uint8_t *reserve(size_t bytes, uint32_t timestamp) {
+    if (length + bytes > TRAIN_BLOCK_BYTES) {
+      return nullptr;
+    }
+    if (records == 0) {
+      firstTimestamp = timestamp;
+    }
+    uint8_t *out = block + length;
+    length += bytes;
+    records++;
+    return out;
+  }
+
+public:
+  void begin(uint8_t *buffer) {
+    block = buffer;
+    length = TRAIN_BLOCK_HEADER_BYTES;
+    records = 0;
+  }
+
+  // false when the block is full, seal it and go on in the next one
+  bool add(const handData_t &hand) {
+    uint8_t *out = reserve(TRAIN_RECORD_HAND_BYTES, hand.timestamp);
+    if (out == nullptr) {
+      return false;
+    }
+    out[0] = TRAIN_RECORD_HAND;
+    putU32(out + 1, hand.timestamp);
+    out[5] = hand.pinky;
+    out[6] = hand.ring;
+    out[7] = hand.middle;
+    out[8] = hand.index;
+    out[9] = hand.thumb;
+    return true;
+  }
+
+  bool add(const quaternion_t &imu) {
+    uint8_t *out = reserve(TRAIN_RECORD_IMU_BYTES, imu.timestamp);
+    if (out == nullptr) {
+      return false;
+    }
+    out[0] = TRAIN_RECORD_IMU;
+    putU32(out + 1, imu.timestamp);
+    out[5] = imu.w;
+    out[6] = imu.x;
+    out[7] = imu.y;
+    out[8] = imu.z;
+    return true;
+  }
+
+  bool add(const rawHandData_t &hand) {
+    uint8_t *out = reserve(TRAIN_RECORD_RAW_HAND_BYTES, hand.timestamp);
+    if (out == nullptr) {
+      return false;
+    }
+    out[0] = TRAIN_RECORD_RAW_HAND;
+    putU32(out + 1, hand.timestamp);
+    putAdc12(out + 5, hand.raw);
+    return true;
+  }
+
+  bool add(const rawQuaternion_t &imu) {
+    uint8_t *out = reserve(TRAIN_RECORD_RAW_IMU_BYTES, imu.timestamp);
+    if (out == nullptr) {
+      return false;
+    }
+    out[0] = TRAIN_RECORD_RAW_IMU;
+    putU32(out + 1, imu.timestamp);
+    putU32(out + 5, (uint32_t)imu.q1);
+    putU32(out + 9, (uint32_t)imu.q2);
+    putU32(out + 13, (uint32_t)imu.q3);
+    return true;
+  }
+
+  bool isEmpty() const {
+    return records == 0;
+  }
+
+  // Timestamp of the oldest record in the block, for flushing on a deadline
+  uint32_t oldest() const {
+    return firstTimestamp;
+  }
+
+  // Writes the header and padding, the block is then ready to be written out
+  void seal(uint16_t session, uint32_t sequence, uint32_t lost) {
+    putU32(block, TRAIN_RECORD_MAGIC);
+    block[4] = TRAIN_RECORD_VERSION;
+    block[5] = 0;
+    putU16(block + 6, (uint16_t)(length - TRAIN_BLOCK_HEADER_BYTES));
+    putU16(block + 8, session);
+    putU16(block + 10, records);
+    putU32(block + 12, sequence);
+    putU32(block + 16, lost);
+    uint32_t crc = trainCrc32(block, 20);
+    crc = trainCrc32(block + TRAIN_BLOCK_HEADER_BYTES, length - TRAIN_BLOCK_HEADER_BYTES, crc);
+    putU32(block + 20, crc);
+    memset(block + length, 0, TRAIN_BLOCK_BYTES - length);
+  }
+};
+
+typedef struct {
+  uint16_t payloadBytes;
+  uint16_t session;
+  uint16_t records;
+  uint32_t sequence;
+  uint32_t lost;
+} TrainBlockHeader_t;
+
+typedef struct {
+  uint8_t kind;  // TRAIN_RECORD_*, the member below of that kind is set
+  handData_t hand;
+  quaternion_t imu;
+  rawHandData_t rawHand;
+  rawQuaternion_t rawImu;
+} TrainRecord_t;
+
+// Whether data starts a valid block of this version, available bytes long at
+// least up to the end of its payload
+inline bool readTrainBlock(const uint8_t *data, size_t available, TrainBlockHeader_t &header) {
+  if (available < TRAIN_BLOCK_HEADER_BYTES || getU32(data) != TRAIN_RECORD_MAGIC || data[4] != TRAIN_RECORD_VERSION) {
+    return false;
+  }
+  header.payloadBytes = getU16(data + 6);
+  if (header.payloadBytes > TRAIN_BLOCK_BYTES - TRAIN_BLOCK_HEADER_BYTES
+      || TRAIN_BLOCK_HEADER_BYTES + (size_t)header.payloadBytes > available) {
+    return false;
+  }
+  uint32_t crc = trainCrc32(data, 20);
+  crc = trainCrc32(data + TRAIN_BLOCK_HEADER_BYTES, header.payloadBytes, crc);
+  if (crc != getU32(data + 20)) {
+    return false;
+  }
+  header.session = getU16(data + 8);
+  header.records = getU16(data + 10);
+  header.sequence = getU32(data + 12);
+  header.lost = getU32(data + 16);
+  return true;
+}
+
+// Decodes the record at payload, returns its size or 0 when it is not one
+inline size_t readTrainRecord(const uint8_t *payload, size_t remaining, TrainRecord_t &record) {
+  if (remaining == 0) {
+    return 0;
+  }
+  record.kind = payload[0];
+  if (record.kind == TRAIN_RECORD_HAND && remaining >= TRAIN_RECORD_HAND_BYTES) {
+    record.hand.timestamp = getU32(payload + 1);
+    record.hand.pinky = payload[5];
+    record.hand.ring = payload[6];
+    record.hand.middle = payload[7];
+    record.hand.index = payload[8];
+    record.hand.thumb = payload[9];
+    return TRAIN_RECORD_HAND_BYTES;
+  }
+  if (record.kind == TRAIN_RECORD_IMU && remaining >= TRAIN_RECORD_IMU_BYTES) {
+    record.imu.timestamp = getU32(payload + 1);
+    record.imu.w = payload[5];
+    record.imu.x = payload[6];
+    record.imu.y = payload[7];
+    record.imu.z = payload[8];
+    return TRAIN_RECORD_IMU_BYTES;
+  }
+  if (record.kind == TRAIN_RECORD_RAW_HAND && remaining >= TRAIN_RECORD_RAW_HAND_BYTES) {
+    record.rawHand.timestamp = getU32(payload + 1);
+    getAdc12(payload + 5, record.rawHand.raw);
+    return TRAIN_RECORD_RAW_HAND_BYTES;
+  }
+  if (record.kind == TRAIN_RECORD_RAW_IMU && remaining >= TRAIN_RECORD_RAW_IMU_BYTES) {
+    record.rawImu.timestamp = getU32(payload + 1);
+    record.rawImu.q1 = (int32_t)getU32(payload + 5);
+    record.rawImu.q2 = (int32_t)getU32(payload + 9);
+    record.rawImu.q3 = (int32_t)getU32(payload + 13);
+    return TRAIN_RECORD_RAW_IMU_BYTES;
+  }
+  return 0;
+}
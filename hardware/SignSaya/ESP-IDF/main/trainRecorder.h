@@ -0,0 +1,172 @@
+#pragma once
+#include <atomic>
+#include <Arduino.h>
+#include "FFat.h"
+#include "trainRecord.h"
+
+// Records trainRecord.h blocks to a new file on the ffat partition per boot,
+// /TRN<session>.BIN. Two block buffers: add() fills one from the recording
+// task while writeReady() writes the other out from a lower priority task, so
+// a slow flash write never holds up the rings the sampling tasks push into.
+// When both buffers are waiting to be written the new samples are counted as
+// lost rather than blocking, the count goes into every block header. So are
+// the samples of a block the flash did not take, and every sample while no
+// file is open.
+class TrainRecorder {
+private:
+  enum : uint8_t {
+    Free,
+    Filling,
+    Ready
+  };
+
+  uint8_t buffers[2][TRAIN_BLOCK_BYTES];
+  std::atomic<uint8_t> states[2];
+  uint32_t sequences[2] = {};
+  int8_t filling = -1;
+  TrainBlockWriter writer;
+
+  File file;
+  TaskHandle_t writerTask = nullptr;
+  uint16_t session = 0;
+  uint32_t sequence = 0;
+  bool recording = false;
+  uint32_t lostSamples = 0;
+  uint32_t upstreamLost = 0;
+  uint32_t writtenBlocks = 0;
+  std::atomic<uint32_t> unwrittenSamples{0};  // counted by the writer task
+  uint32_t failedBlocks = 0;
+
+  bool acquire() {
+    for (int8_t index = 0; index < 2; index++) {
+      uint8_t expected = Free;
+      if (states[index].compare_exchange_strong(expected, Filling)) {
+        filling = index;
+        writer.begin(buffers[index]);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template <typename T>
+  void record(const T &sample) {
+    if (!recording || (filling < 0 && !acquire())) {
+      lostSamples++;
+      return;
+    }
+    if (!writer.add(sample)) {
+      flush();
+      if (!acquire() || !writer.add(sample)) {
+        lostSamples++;
+      }
+    }
+  }
+
+public:
+  TrainRecorder() {
+    states[0].store(Free);
+    states[1].store(Free);
+  }
+
+  // Mounts the partition, formatting it the first time, and opens the next
+  // free session file. writer is the task that calls writeReady(). When
+  // this fails add() only counts the samples as lost.
+  bool begin(TaskHandle_t writer) {
+    writerTask = writer;
+    if (!FFat.begin(true)) {
+      return false;
+    }
+    char path[16];
+    do {
+      session++;
+      snprintf(path, sizeof(path), "/TRN%05u.BIN", session);
+    } while (FFat.exists(path) && session < 65535);
+    file = FFat.open(path, FILE_WRITE);
+    recording = (bool)file;
+    return recording;
+  }
+
+  // Recording task: appends one sample, never waits on the flash
+  void add(const handData_t &hand) {
+    record(hand);
+  }
+
+  void add(const quaternion_t &imu) {
+    record(imu);
+  }
+
+  void add(const rawHandData_t &hand) {
+    record(hand);
+  }
+
+  void add(const rawQuaternion_t &imu) {
+    record(imu);
+  }
+
+  // Recording task: samples the rings feeding it refused so far, recorded
+  // with the ones lost here
+  void setUpstreamLost(uint32_t samples) {
+    upstreamLost = samples;
+  }
+
+  // Recording task: hands a block over once its oldest sample is maxAgeUs
+  // old, so a power cut loses at most that much
+  void flushOlderThan(uint32_t now, uint32_t maxAgeUs) {
+    if (filling >= 0 && !writer.isEmpty() && now - writer.oldest() >= maxAgeUs) {
+      flush();
+    }
+  }
+
+  // Recording task: seals the block being filled and wakes the writer
+  void flush() {
+    if (filling < 0 || writer.isEmpty()) {
+      return;
+    }
+    writer.seal(session, sequence, lost());
+    sequences[filling] = sequence++;
+    states[filling].store(Ready);
+    filling = -1;
+    if (writerTask != nullptr) {
+      xTaskNotifyGive(writerTask);
+    }
+  }
+
+  // Writer task: writes every sealed block, oldest first, whole sectors at a time
+  void writeReady() {
+    for (;;) {
+      int8_t next = -1;
+      for (int8_t index = 0; index < 2; index++) {
+        if (states[index].load() == Ready && (next < 0 || (int32_t)(sequences[index] - sequences[next]) < 0)) {
+          next = index;
+        }
+      }
+      if (next < 0) {
+        return;
+      }
+      if (file.write(buffers[next], TRAIN_BLOCK_BYTES) == TRAIN_BLOCK_BYTES) {
+        // the directory entry has the new length once this returns
+        file.flush();
+        writtenBlocks++;
+      } else {
+        // the partition is full or the card went away, a part written block
+        // fails its CRC and the reader skips it
+        unwrittenSamples += getU16(buffers[next] + 10);
+        failedBlocks++;
+      }
+      states[next].store(Free);
+    }
+  }
+
+  uint32_t lost() const {
+    return lostSamples + upstreamLost + unwrittenSamples.load();
+  }
+
+  uint32_t written() const {
+    return writtenBlocks;
+  }
+
+  uint32_t failed() const {
+    return failedBlocks;
+  }
+};
@@ -1,10 +1,13 @@
 #pragma once
 
+#define FINGER_COUNT 5
+
 typedef struct {
   uint8_t w;
   uint8_t x;
   uint8_t y;
   uint8_t z;
+  uint32_t timestamp;  // micros() when the sample was read
 } quaternion_t;
 
 typedef struct {
@@ -13,9 +16,23 @@ typedef struct {
   uint8_t middle;
   uint8_t index;
   uint8_t thumb;
+  uint32_t timestamp;  // micros() when the frame was sampled
 } handData_t;
 
 
+// Unprocessed readings, what the pipeline starts from (sensorTrace.h)
+typedef struct {
+  uint16_t raw[FINGER_COUNT];  // 12-bit ADC, handData_t order
+  uint32_t timestamp;
+} rawHandData_t;
+
+typedef struct {
+  int32_t q1;  // the DMP's x, y and z, Q30
+  int32_t q2;
+  int32_t q3;
+  uint32_t timestamp;
+} rawQuaternion_t;
+
 typedef struct{ 
   uint8_t pinky;
   uint8_t ring;